@@ -10,7 +10,7 @@ APP_EXEC := $(DIST_DIR)/cmocka-app
 
 # Application specific flags (use installed SDK from build directory)
 APP_CFLAGS := $(CFLAGS) -I$(SDK_INSTALL_INC_DIR)
-APP_LDFLAGS := -L$(SDK_INSTALL_LIB_DIR) -lsdk
+APP_LDFLAGS := -L$(SDK_INSTALL_LIB_DIR) -lsdk -lpthread
 
 # Build application (depends on sdk_install)
 .PHONY: app
@@ -39,4 +39,32 @@ run: app
 # Clean application artifacts
 .PHONY: clean-app
 clean-app:
-	$(RM) $(APP_OUTPUT_DIR) $(APP_EXEC)
\ No newline at end of file
+	$(RM) $(APP_OUTPUT_DIR) $(APP_EXEC)
+
+# Release application (LTO across the app and the release SDK library)
+APP_RELEASE_OUTPUT_DIR := $(OUTPUT_DIR)/application_release
+APP_RELEASE_OBJS := $(patsubst $(APP_SRC_DIR)/%.c, $(APP_RELEASE_OUTPUT_DIR)/%.o, $(APP_SRCS))
+APP_RELEASE_EXEC := $(DIST_DIR)/cmocka-app-release
+APP_RELEASE_CFLAGS := -Wall -Wextra -O2 -flto -I$(SDK_INC_DIR)
+APP_RELEASE_LDFLAGS := -O2 -flto -L$(dir $(SDK_RELEASE_LIB)) -lsdk -lpthread
+
+# Build release application
+.PHONY: app_release
+app_release: $(APP_RELEASE_EXEC)
+
+$(APP_RELEASE_EXEC): $(APP_RELEASE_OBJS) $(SDK_RELEASE_LIB)
+	@echo "Building release application: $@"
+	@$(MKDIR) $(dir $@)
+	$(CC) $(APP_RELEASE_OBJS) -o $@ $(APP_RELEASE_LDFLAGS)
+	@echo "Release application built successfully: $@"
+
+# Compile application source files (release)
+$(APP_RELEASE_OUTPUT_DIR)/%.o: $(APP_SRC_DIR)/%.c
+	@echo "Compiling (release): $<"
+	@$(MKDIR) $(dir $@)
+	$(CC) $(APP_RELEASE_CFLAGS) -c $< -o $@
+
+# Clean release application artifacts
+.PHONY: clean-app-release
+clean-app-release:
+	$(RM) $(APP_RELEASE_OUTPUT_DIR) $(APP_RELEASE_EXEC)
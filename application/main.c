@@ -18,6 +18,16 @@ void test_calculator() {
     // Test division by zero
     printf("\nTesting division by zero:\n");
     printf("calc_divide(%d, 0) = %d (should return 0)\n", a, calc_divide(a, 0));
+
+    // Test batch API
+    int xs[5] = {10, 20, 30, 40, 50};
+    int ys[5] = {3, 0, 7, -4, 5};
+    int out[5];
+    printf("\nTesting batch API (ISA %d):\n", (int)calc_batch_get_isa());
+    calc_divide_n(xs, ys, out, 5);
+    for (int i = 0; i < 5; i++) {
+        printf("calc_divide_n: %d / %d = %d\n", xs[i], ys[i], out[i]);
+    }
 }
 
 void test_greeting() {
@@ -0,0 +1,108 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "calc.h"
+#include "multi-calc.h"
+#include "multi-calc-expr.h"
+#include "multi-calc-jit.h"
+
+/*
+ * (a + b) * (c - d): three calc batch passes over temporaries, the fused
+ * multi_calc_expression_n kernel, the formula engine and its JIT mode
+ *
+ * Usage: bench_expression [elements] (default 16M, 8 arrays = 512 MiB)
+ */
+
+#define BENCH_REPEAT 5
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : (size_t)16 << 20;
+    int *a = malloc(n * sizeof(int));
+    int *b = malloc(n * sizeof(int));
+    int *c = malloc(n * sizeof(int));
+    int *d = malloc(n * sizeof(int));
+    int *out = malloc(n * sizeof(int));
+    int *t1 = malloc(n * sizeof(int));
+    int *t2 = malloc(n * sizeof(int));
+    int *t3 = malloc(n * sizeof(int));
+    if (n == 0 || !a || !b || !c || !d || !out || !t1 || !t2 || !t3) {
+        fprintf(stderr, "bench_expression: can't allocate %zu ints\n", n);
+        return 1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        a[i] = (int)(i % 101);
+        b[i] = (int)(i % 37) - 18;
+        c[i] = (int)(i % 1009);
+        d[i] = (int)(i % 7);
+    }
+
+    static const char *const names[] = { "a", "b", "c", "d" };
+    multi_calc_expr_t *expr = multi_calc_expr_compile("(a + b) * (c - d)", names, 4, NULL);
+    multi_calc_jit_t *jit = multi_calc_jit_get("(a + b) * (c - d)", names, 4, NULL);
+    const int *inputs[] = { a, b, c, d };
+    if (expr == NULL || jit == NULL) {
+        fprintf(stderr, "bench_expression: can't compile formula\n");
+        return 1;
+    }
+
+    double three_pass = 1e30, fused = 1e30, formula = 1e30, jitted = 1e30;
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        double t0 = now_sec();
+        calc_add_n(a, b, t1, n);
+        calc_subtract_n(c, d, t2, n);
+        calc_multiply_n(t1, t2, t1, n);
+        double t = now_sec() - t0;
+        three_pass = t < three_pass ? t : three_pass;
+
+        t0 = now_sec();
+        multi_calc_expression_n(a, b, c, d, out, n);
+        t = now_sec() - t0;
+        fused = t < fused ? t : fused;
+
+        t0 = now_sec();
+        multi_calc_expr_eval_n(expr, inputs, t2, n);
+        t = now_sec() - t0;
+        formula = t < formula ? t : formula;
+
+        t0 = now_sec();
+        multi_calc_jit_eval_n(jit, inputs, t3, n);
+        t = now_sec() - t0;
+        jitted = t < jitted ? t : jitted;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        if (out[i] != t1[i] || t2[i] != t1[i] || t3[i] != t1[i]) {
+            fprintf(stderr, "bench_expression: mismatch at %zu\n", i);
+            return 1;
+        }
+    }
+
+    // Bytes moved: 3 passes = 9 loads + 3 stores, fused = 4 loads + 1 store
+    double mib = (double)(n * sizeof(int)) / (1 << 20);
+    printf("(a + b) * (c - d): %zu ints, best of %d\n", n, BENCH_REPEAT);
+    printf("%-12s %10.3f ms %10.0f MiB moved\n", "three-pass", three_pass * 1e3, 12 * mib);
+    printf("%-12s %10.3f ms %10.0f MiB moved\n", "fused", fused * 1e3, 5 * mib);
+    printf("%-12s %10.3f ms (bytecode, %d-row blocks)\n", "formula", formula * 1e3, MULTI_CALC_EXPR_BLOCK);
+    printf("%-12s %10.3f ms (%s)\n", "formula jit", jitted * 1e3,
+           multi_calc_jit_is_native(jit) ? "native AVX2" : "interpreter fallback");
+    printf("fused speedup %.2fx\n", three_pass / fused);
+
+    multi_calc_jit_release(jit);
+    multi_calc_expr_free(expr);
+
+    free(a);
+    free(b);
+    free(c);
+    free(d);
+    free(out);
+    free(t1);
+    free(t2);
+    free(t3);
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "greeting.h"
+
+/*
+ * Greetings for many names, collected into one output block: say_hello per
+ * name plus a copy-out, say_hello_r into the block, and one say_hello_n call.
+ * Then the same greetings sent to /dev/null: say_hello + write() per name
+ * against say_hello_write_n (writev, name bytes never copied)
+ *
+ * Usage: bench_greeting [names] (default 4M)
+ */
+
+#define BENCH_REPEAT 5
+#define BENCH_NAME_SIZE 16
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : (size_t)4 << 20;
+    char *storage = malloc(n * BENCH_NAME_SIZE);
+    const char **names = malloc(n * sizeof(*names));
+    size_t *offsets = malloc((n + 1) * sizeof(*offsets));
+    if (n == 0 || !storage || !names || !offsets) {
+        fprintf(stderr, "bench_greeting: can't allocate %zu names\n", n);
+        return 1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        char *name = storage + i * BENCH_NAME_SIZE;
+        snprintf(name, BENCH_NAME_SIZE, "user%zu", i);
+        names[i] = name;
+    }
+
+    size_t size = say_hello_n(names, n, '\n', NULL, 0, offsets);
+    char *legacy = malloc(size);
+    char *reentrant = malloc(size + 1);
+    char *batch = malloc(size);
+    if (!legacy || !reentrant || !batch) {
+        fprintf(stderr, "bench_greeting: can't allocate %zu-byte arena\n", size);
+        return 1;
+    }
+
+    double per_call = 1e30, per_call_r = 1e30, batched = 1e30;
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        double t0 = now_sec();
+        size_t pos = 0;
+        for (size_t i = 0; i < n; i++) {
+            const char *msg = say_hello(names[i]);
+            size_t len = strlen(msg);
+            memcpy(legacy + pos, msg, len);
+            legacy[pos + len] = '\n';
+            pos += len + 1;
+        }
+        double t = now_sec() - t0;
+        per_call = t < per_call ? t : per_call;
+
+        t0 = now_sec();
+        pos = 0;
+        for (size_t i = 0; i < n; i++) {
+            pos += say_hello_r(names[i], GREETING_NAME_STRLEN, reentrant + pos, size + 1 - pos);
+            reentrant[pos++] = '\n';
+        }
+        t = now_sec() - t0;
+        per_call_r = t < per_call_r ? t : per_call_r;
+
+        t0 = now_sec();
+        say_hello_n(names, n, '\n', batch, size, offsets);
+        t = now_sec() - t0;
+        batched = t < batched ? t : batched;
+    }
+
+    if (memcmp(legacy, batch, size) != 0 || memcmp(reentrant, batch, size) != 0) {
+        fprintf(stderr, "bench_greeting: outputs differ\n");
+        return 1;
+    }
+
+    printf("say_hello for %zu names into one %.1f MiB block, best of %d\n", n,
+           (double)size / (1 << 20), BENCH_REPEAT);
+    printf("%-14s %10.3f ms %8.1f ns/name\n", "say_hello+copy", per_call * 1e3, per_call * 1e9 / n);
+    printf("%-14s %10.3f ms %8.1f ns/name\n", "say_hello_r", per_call_r * 1e3, per_call_r * 1e9 / n);
+    printf("%-14s %10.3f ms %8.1f ns/name\n", "say_hello_n", batched * 1e3, batched * 1e9 / n);
+    printf("batch speedup %.2fx\n", per_call / batched);
+
+    int fd = open("/dev/null", O_WRONLY);
+    if (fd < 0) {
+        perror("bench_greeting: /dev/null");
+        return 1;
+    }
+    double write_each = 1e30, write_vec = 1e30;
+    size_t sent = 0;
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        double t0 = now_sec();
+        for (size_t i = 0; i < n; i++) {
+            char line[64];
+            size_t len = say_hello_r(names[i], GREETING_NAME_STRLEN, line, sizeof(line) - 1);
+            line[len] = '\n';
+            if (write(fd, line, len + 1) != (ssize_t)(len + 1)) {
+                perror("bench_greeting: write");
+                return 1;
+            }
+        }
+        double t = now_sec() - t0;
+        write_each = t < write_each ? t : write_each;
+
+        t0 = now_sec();
+        if (say_hello_write_n(fd, names, n, '\n', &sent) != 0 || sent != size) {
+            perror("bench_greeting: say_hello_write_n");
+            return 1;
+        }
+        t = now_sec() - t0;
+        write_vec = t < write_vec ? t : write_vec;
+    }
+    close(fd);
+
+    printf("\nsame greetings to /dev/null\n");
+    printf("%-14s %10.3f ms %8.1f ns/name\n", "write per name", write_each * 1e3, write_each * 1e9 / n);
+    printf("%-14s %10.3f ms %8.1f ns/name\n", "writev batch", write_vec * 1e3, write_vec * 1e9 / n);
+    printf("writev speedup %.2fx\n", write_each / write_vec);
+
+    free(storage);
+    free(names);
+    free(offsets);
+    free(legacy);
+    free(reentrant);
+    free(batch);
+    return 0;
+}
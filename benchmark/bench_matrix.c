@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "calc.h"
+#include "calc-matrix.h"
+#include "sdk-pool.h"
+
+/*
+ * Square int32 matrix multiply: naive calc_multiply / calc_add triple loop
+ * vs the blocked kernels (scalar and best ISA, int32 and int64
+ * accumulation), then blocked int32 from 1 thread to the whole SDK pool.
+ *
+ * Usage: bench_matrix [size] (default 512)
+ * Set SDK_THREADS to benchmark more threads than online CPUs.
+ */
+
+#define BENCH_REPEAT 3
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+struct bench_args {
+    const int *a, *b;
+    int *c;
+    int64_t *c64;
+    size_t n;
+    unsigned threads;
+};
+
+static void run_naive(const struct bench_args *args) {
+    calc_matrix_multiply_ref(args->a, args->b, args->c, args->n, args->n, args->n);
+}
+
+static void run_blocked(const struct bench_args *args) {
+    calc_matrix_multiply(args->a, args->b, args->c, args->n, args->n, args->n, args->threads);
+}
+
+static void run_blocked64(const struct bench_args *args) {
+    calc_matrix_multiply64(args->a, args->b, args->c64, args->n, args->n, args->n, args->threads);
+}
+
+static double best_time(void (*fn)(const struct bench_args *), const struct bench_args *args,
+                        int repeat) {
+    double best = 1e30;
+    for (int r = 0; r < repeat; r++) {
+        double t0 = now_sec();
+        fn(args);
+        double t = now_sec() - t0;
+        best = t < best ? t : best;
+    }
+    return best;
+}
+
+static void report(const char *name, double sec, double base, size_t n) {
+    double ops = 2.0 * (double)n * (double)n * (double)n;
+    printf("%-26s %12.3f %10.2f %9.2fx\n", name, sec * 1e3, ops / sec / 1e9, base / sec);
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 512;
+    int *a = malloc(n * n * sizeof(int));
+    int *b = malloc(n * n * sizeof(int));
+    int *c = malloc(n * n * sizeof(int));
+    int *expected = malloc(n * n * sizeof(int));
+    int64_t *c64 = malloc(n * n * sizeof(int64_t));
+    if (n == 0 || !a || !b || !c || !expected || !c64) {
+        fprintf(stderr, "bench_matrix: can't allocate %zu x %zu matrices\n", n, n);
+        return 1;
+    }
+    // Small values: the naive loop must not overflow, int64 must match int32
+    for (size_t i = 0; i < n * n; i++) {
+        a[i] = (int)(i % 201) - 100;
+        b[i] = (int)((i * 7) % 101) - 50;
+    }
+
+    struct bench_args args = { a, b, expected, c64, n, 1 };
+    printf("%zu x %zu int32 matrix multiply, best of %d\n", n, n, BENCH_REPEAT);
+    printf("%-26s %12s %10s %9s\n", "variant", "time(ms)", "GOPS", "speedup");
+    double naive = best_time(run_naive, &args, 1);
+    report("naive calc_xxx loop", naive, naive, n);
+
+    args.c = c;
+    calc_isa_t best_isa = calc_batch_get_isa();
+    calc_batch_set_isa(CALC_ISA_SCALAR);
+    double t = best_time(run_blocked, &args, BENCH_REPEAT);
+    int ok = memcmp(c, expected, n * n * sizeof(int)) == 0;
+    report("blocked scalar", t, naive, n);
+    calc_batch_set_isa(best_isa);
+
+    memset(c, 0, n * n * sizeof(int));
+    t = best_time(run_blocked, &args, BENCH_REPEAT);
+    ok = ok && memcmp(c, expected, n * n * sizeof(int)) == 0;
+    report(best_isa >= CALC_ISA_AVX2 ? "blocked avx2" : "blocked (no avx2)", t, naive, n);
+
+    t = best_time(run_blocked64, &args, BENCH_REPEAT);
+    for (size_t i = 0; i < n * n; i++) {
+        ok = ok && c64[i] == expected[i];
+    }
+    report(best_isa >= CALC_ISA_AVX2 ? "blocked avx2, int64 acc" : "blocked, int64 acc", t, naive, n);
+    if (!ok) {
+        fprintf(stderr, "bench_matrix: result mismatch\n");
+        return 1;
+    }
+
+    printf("\n%8s %12s %10s %9s\n", "threads", "time(ms)", "GOPS", "speedup");
+    double base = 0;
+    for (unsigned threads = 1; threads <= sdk_pool_size(); threads++) {
+        args.threads = threads;
+        memset(c, 0, n * n * sizeof(int));
+        t = best_time(run_blocked, &args, BENCH_REPEAT);
+        if (memcmp(c, expected, n * n * sizeof(int)) != 0) {
+            fprintf(stderr, "bench_matrix: result mismatch at %u threads\n", threads);
+            return 1;
+        }
+        base = threads == 1 ? t : base;
+        printf("%8u %12.3f %10.2f %8.2fx\n", threads, t * 1e3,
+               2.0 * (double)n * (double)n * (double)n / t / 1e9, base / t);
+    }
+
+    sdk_pool_shutdown();
+    free(a);
+    free(b);
+    free(c);
+    free(expected);
+    free(c64);
+    return 0;
+}
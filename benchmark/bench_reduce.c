@@ -0,0 +1,84 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "calc.h"
+#include "multi-calc.h"
+#include "sdk-pool.h"
+
+/*
+ * calc_sum_reduce scaling from 1 thread to the whole SDK pool
+ *
+ * Usage: bench_reduce [elements] (default 64M ints = 256 MiB)
+ * Set SDK_THREADS to benchmark more threads than online CPUs.
+ */
+
+#define BENCH_REPEAT 5
+#define BENCH_FILL_CHUNK (64 * 1024)
+
+struct fill_job {
+    int *a;
+    size_t n;
+};
+
+static void fill_task(void *ctx, size_t task) {
+    struct fill_job *job = ctx;
+    size_t end = (task + 1) * BENCH_FILL_CHUNK < job->n ? (task + 1) * BENCH_FILL_CHUNK : job->n;
+    for (size_t i = task * BENCH_FILL_CHUNK; i < end; i++) {
+        job->a[i] = (int)(i % 2001) - 1000;
+    }
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static double best_time(const int *a, size_t n, unsigned threads, int64_t *sum) {
+    double best = 1e30;
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        double t0 = now_sec();
+        *sum = calc_sum_reduce(a, n, threads);
+        double t = now_sec() - t0;
+        if (t < best) {
+            best = t;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : (size_t)64 << 20;
+    int *a = NULL;
+    if (n == 0 || posix_memalign((void **)&a, 4096, n * sizeof(int)) != 0) {
+        fprintf(stderr, "bench_reduce: can't allocate %zu ints\n", n);
+        return 1;
+    }
+
+    // First-touch the input from the pool, chunked like calc_sum_reduce
+    struct fill_job fill = { a, n };
+    sdk_pool_parallel_for((n + BENCH_FILL_CHUNK - 1) / BENCH_FILL_CHUNK, 0, fill_task, &fill);
+
+    unsigned max = sdk_pool_size();
+    int64_t sum = 0;
+    double base = best_time(a, n, 1, &sum);
+    int64_t expect = sum;
+
+    printf("calc_sum_reduce: %zu ints, best of %d\n", n, BENCH_REPEAT);
+    printf("%8s %12s %10s %9s\n", "threads", "time(ms)", "GB/s", "speedup");
+    for (unsigned t = 1; t <= max; t++) {
+        double sec = t == 1 ? base : best_time(a, n, t, &sum);
+        if (sum != expect) {
+            fprintf(stderr, "bench_reduce: sum mismatch at %u threads\n", t);
+            free(a);
+            return 1;
+        }
+        printf("%8u %12.3f %10.2f %8.2fx\n", t, sec * 1e3,
+               (double)(n * sizeof(int)) / sec / 1e9, base / sec);
+    }
+    printf("multi_calc_average_n = %d\n", multi_calc_average_n(a, n, 0));
+
+    free(a);
+    sdk_pool_shutdown();
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "multi-calc.h"
+#include "sdk-pool.h"
+#include "sdk-sched.h"
+
+/*
+ * Skewed job list: static partitioning vs the work-stealing scheduler
+ *
+ * Every job runs multi_calc_expression_n over its own batch and stores
+ * multi_calc_average_n of the results. Batch sizes span 4..512 rows and
+ * the last tenth of the list is 16x heavier, so equal-count static chunks
+ * leave all but the last thread idle near the end.
+ *
+ * Usage: bench_sched [jobs] (default 500000)
+ * Set SDK_THREADS to benchmark more threads than online CPUs.
+ */
+
+#define BENCH_REPEAT 3
+#define BENCH_INPUT_LEN (1 << 20)
+#define BENCH_MAX_BATCH (512 * 16)
+
+struct job {
+    size_t offset;
+    size_t len;
+};
+
+struct job_list {
+    const struct job *jobs;
+    size_t njobs;
+    const int *a, *b, *c, *d;
+    int *results;
+    unsigned nchunks;       /* static partitioning only */
+};
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void run_jobs(const struct job_list *list, size_t begin, size_t end) {
+    static __thread int scratch[BENCH_MAX_BATCH];
+    for (size_t i = begin; i < end; i++) {
+        const struct job *j = &list->jobs[i];
+        multi_calc_expression_n(list->a + j->offset, list->b + j->offset, list->c + j->offset,
+                                list->d + j->offset, scratch, j->len);
+        list->results[i] = multi_calc_average_n(scratch, j->len, 1);
+    }
+}
+
+static void static_task(void *ctx, size_t task) {
+    const struct job_list *list = ctx;
+    size_t per = (list->njobs + list->nchunks - 1) / list->nchunks;
+    size_t begin = task * per;
+    size_t end = begin + per < list->njobs ? begin + per : list->njobs;
+    if (begin < end) {
+        run_jobs(list, begin, end);
+    }
+}
+
+static void sched_range(void *ctx, size_t begin, size_t end) {
+    run_jobs(ctx, begin, end);
+}
+
+static double best_static(struct job_list *list, unsigned threads) {
+    double best = 1e30;
+    list->nchunks = threads;
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        double t0 = now_sec();
+        sdk_pool_parallel_for(threads, threads, static_task, list);
+        double t = now_sec() - t0;
+        best = t < best ? t : best;
+    }
+    return best;
+}
+
+static double best_sched(struct job_list *list) {
+    double best = 1e30;
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        double t0 = now_sec();
+        sdk_sched_run(0, list->njobs, 16, sched_range, list);
+        double t = now_sec() - t0;
+        best = t < best ? t : best;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    size_t njobs = argc > 1 ? strtoull(argv[1], NULL, 10) : 500000;
+    struct job *jobs = malloc(njobs * sizeof(*jobs));
+    int *a = malloc(BENCH_INPUT_LEN * sizeof(int));
+    int *b = malloc(BENCH_INPUT_LEN * sizeof(int));
+    int *c = malloc(BENCH_INPUT_LEN * sizeof(int));
+    int *d = malloc(BENCH_INPUT_LEN * sizeof(int));
+    int *expected = malloc(njobs * sizeof(int));
+    int *results = malloc(njobs * sizeof(int));
+    if (njobs == 0 || !jobs || !a || !b || !c || !d || !expected || !results) {
+        fprintf(stderr, "bench_sched: can't allocate %zu jobs\n", njobs);
+        return 1;
+    }
+    for (size_t i = 0; i < BENCH_INPUT_LEN; i++) {
+        a[i] = (int)(i % 101);
+        b[i] = (int)(i % 37) - 18;
+        c[i] = (int)(i % 1009);
+        d[i] = (int)(i % 7);
+    }
+    uint32_t rng = 12345;
+    size_t rows = 0;
+    for (size_t i = 0; i < njobs; i++) {
+        rng = rng * 1664525u + 1013904223u;
+        jobs[i].len = (size_t)4 << ((rng >> 24) % 8);
+        if (i >= njobs - njobs / 10) {
+            jobs[i].len *= 16;
+        }
+        jobs[i].offset = (rng >> 4) % (BENCH_INPUT_LEN - jobs[i].len);
+        rows += jobs[i].len;
+    }
+
+    struct job_list list = { jobs, njobs, a, b, c, d, expected, 1 };
+    run_jobs(&list, 0, njobs);
+    list.results = results;
+
+    unsigned max = sdk_pool_size();
+    printf("skewed job list: %zu jobs, %zu rows, best of %d\n", njobs, rows, BENCH_REPEAT);
+    printf("%8s %14s %9s %14s %9s %10s\n", "threads", "static(ms)", "speedup", "stealing(ms)", "speedup",
+           "steals");
+    double static_base = 0, sched_base = 0;
+    for (unsigned t = 1; t <= max; t++) {
+        if (sdk_pool_set_size(t) != 0 || sdk_sched_set_workers(t) != 0) {
+            fprintf(stderr, "bench_sched: can't start %u threads\n", t);
+            return 1;
+        }
+        memset(results, 0, njobs * sizeof(int));
+        double st = best_static(&list, t);
+        int ok = memcmp(results, expected, njobs * sizeof(int)) == 0;
+
+        sdk_sched_stats_t stats;
+        sdk_sched_reset_stats();
+        memset(results, 0, njobs * sizeof(int));
+        double ws = best_sched(&list);
+        sdk_sched_get_stats(&stats);
+        ok = ok && memcmp(results, expected, njobs * sizeof(int)) == 0;
+        if (!ok) {
+            fprintf(stderr, "bench_sched: result mismatch at %u threads\n", t);
+            return 1;
+        }
+
+        if (t == 1) {
+            static_base = st;
+            sched_base = ws;
+        }
+        printf("%8u %14.3f %8.2fx %14.3f %8.2fx %10.1f\n", t, st * 1e3, static_base / st, ws * 1e3,
+               sched_base / ws, (double)stats.steals / BENCH_REPEAT);
+    }
+
+    sdk_sched_shutdown();
+    sdk_pool_shutdown();
+    free(jobs);
+    free(a);
+    free(b);
+    free(c);
+    free(d);
+    free(expected);
+    free(results);
+    return 0;
+}
@@ -0,0 +1,43 @@
+# Benchmark build rules
+#
+# Every benchmark/bench_xxx.c is a standalone program linked against the
+# release SDK library, so timings reflect the optimized (LTO) build.
+
+# Benchmark source files
+BENCH_SRC_DIR := benchmark
+BENCH_SRCS := $(wildcard $(BENCH_SRC_DIR)/*.c)
+BENCH_OUTPUT_DIR := $(OUTPUT_DIR)/benchmark
+BENCH_EXECS := $(patsubst $(BENCH_SRC_DIR)/%.c, $(DIST_DIR)/%, $(BENCH_SRCS))
+
+# Benchmark specific flags
+BENCH_CFLAGS := -Wall -Wextra -O2 -flto -I$(SDK_INC_DIR)
+BENCH_LDFLAGS := -O2 -flto -L$(dir $(SDK_RELEASE_LIB)) -lsdk -lpthread
+
+# Build and run all benchmarks
+.PHONY: bench
+bench: bench_build
+	@for b in $(BENCH_EXECS); do \
+		echo ""; \
+		echo "--- Running $$b ---"; \
+		$$b || exit 1; \
+	done
+
+# Build benchmarks only (without running)
+.PHONY: bench_build
+bench_build: $(BENCH_EXECS)
+
+$(DIST_DIR)/bench_%: $(BENCH_OUTPUT_DIR)/bench_%.o $(SDK_RELEASE_LIB)
+	@echo "Building benchmark: $@"
+	@$(MKDIR) $(dir $@)
+	$(CC) $< -o $@ $(BENCH_LDFLAGS)
+
+# Compile benchmark source files
+$(BENCH_OUTPUT_DIR)/%.o: $(BENCH_SRC_DIR)/%.c
+	@echo "Compiling (benchmark): $<"
+	@$(MKDIR) $(dir $@)
+	$(CC) $(BENCH_CFLAGS) -c $< -o $@
+
+# Clean benchmark artifacts
+.PHONY: clean-bench
+clean-bench:
+	$(RM) $(BENCH_OUTPUT_DIR) $(BENCH_EXECS)
@@ -0,0 +1,121 @@
+#ifndef __CALC_BIGINT_H__
+#define __CALC_BIGINT_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Arbitrary-precision integers
+ *
+ * Sign-magnitude integers with 64-bit limbs for results that don't fit in
+ * an int. Magnitudes of up to CALC_BIGINT_INLINE_LIMBS limbs (|x| < 2^128,
+ * enough for any sum or product of int64 values) live inside the struct,
+ * so small values never allocate; larger ones move to the heap and keep
+ * that capacity until calc_bigint_free.
+ *
+ * Multiplication is schoolbook below the Karatsuba threshold (in limbs of
+ * the smaller operand) and Karatsuba above it. Division truncates toward
+ * zero like C, with the remainder taking the dividend's sign, and division
+ * by 0 gives 0 like calc_divide.
+ *
+ * Results may alias operands. Copy values with calc_bigint_copy, not by
+ * struct assignment. Functions that can allocate return 0 on success and -1
+ * on allocation failure; the result is then unspecified but still valid
+ * (it can be reused or freed).
+ */
+
+#define CALC_BIGINT_INLINE_LIMBS 2
+#define CALC_BIGINT_KARATSUBA_THRESHOLD 24  /* limbs, see calc_bigint_set_karatsuba_threshold */
+
+typedef struct {
+    size_t len;             /* limbs in use, top one non-zero (0 for zero) */
+    size_t cap;             /* limbs available */
+    int negative;           /* 1 if < 0 (never set for zero) */
+    union {
+        uint64_t inline_limbs[CALC_BIGINT_INLINE_LIMBS];    /* cap == CALC_BIGINT_INLINE_LIMBS */
+        uint64_t *heap;                                     /* cap > CALC_BIGINT_INLINE_LIMBS */
+    } u;
+} calc_bigint_t;
+
+/**
+ * Initialize to zero (never allocates)
+ */
+void calc_bigint_init(calc_bigint_t *x);
+
+/**
+ * Release heap storage and reset to zero
+ */
+void calc_bigint_free(calc_bigint_t *x);
+
+/**
+ * Copy src into dst
+ * @return 0 on success, -1 on allocation failure
+ */
+int calc_bigint_copy(calc_bigint_t *dst, const calc_bigint_t *src);
+
+/**
+ * Set from an integer (never allocates on an initialized value)
+ */
+void calc_bigint_from_int(calc_bigint_t *x, int v);
+void calc_bigint_from_int64(calc_bigint_t *x, int64_t v);
+
+/**
+ * Convert to an integer
+ * @param x Value
+ * @param out Receives x if it fits, else x modulo 2^32 (2^64), like the
+ *            wrapping batch API
+ * @return 0 if x fits, -1 if it doesn't
+ */
+int calc_bigint_to_int(const calc_bigint_t *x, int *out);
+int calc_bigint_to_int64(const calc_bigint_t *x, int64_t *out);
+
+/**
+ * Compare two values
+ * @return -1, 0 or 1 for a < b, a == b, a > b
+ */
+int calc_bigint_cmp(const calc_bigint_t *a, const calc_bigint_t *b);
+
+/**
+ * Get the sign
+ * @return -1, 0 or 1
+ */
+int calc_bigint_sign(const calc_bigint_t *x);
+
+/**
+ * r = a + b, r = a - b, r = a * b
+ * @return 0 on success, -1 on allocation failure
+ */
+int calc_bigint_add(calc_bigint_t *r, const calc_bigint_t *a, const calc_bigint_t *b);
+int calc_bigint_subtract(calc_bigint_t *r, const calc_bigint_t *a, const calc_bigint_t *b);
+int calc_bigint_multiply(calc_bigint_t *r, const calc_bigint_t *a, const calc_bigint_t *b);
+
+/**
+ * Truncating division: a = q * b + rem, |rem| < |b|, rem has a's sign
+ * @param q Quotient, or NULL
+ * @param rem Remainder, or NULL
+ * @param a Dividend
+ * @param b Divisor
+ * @return 0 on success, -1 on allocation failure
+ * @note q and rem are 0 if b is 0
+ */
+int calc_bigint_divide(calc_bigint_t *q, calc_bigint_t *rem, const calc_bigint_t *a,
+                       const calc_bigint_t *b);
+
+/**
+ * Format as decimal, like snprintf
+ * @param x Value
+ * @param buf Output buffer (NUL-terminated, truncated to size - 1 chars)
+ * @param size Size of buf, may be 0
+ * @return Length of the full decimal string, -1 on allocation failure
+ */
+int calc_bigint_to_string(const calc_bigint_t *x, char *buf, size_t size);
+
+/**
+ * Get / set the Karatsuba threshold (process-wide)
+ * @param limbs Smallest operand size, in limbs, multiplied with Karatsuba
+ *              (minimum 4; 0 = CALC_BIGINT_KARATSUBA_THRESHOLD)
+ */
+size_t calc_bigint_karatsuba_threshold(void);
+void calc_bigint_set_karatsuba_threshold(size_t limbs);
+
+#endif /* __CALC_BIGINT_H__ */
@@ -0,0 +1,123 @@
+#ifndef __CALC_COLUMN_H__
+#define __CALC_COLUMN_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Columnar int container for the batch APIs
+ *
+ * A column is a length plus a pointer to int storage and an optional
+ * validity bitmap (bit i % 8 of byte i / 8 set = row i valid, NULL = all
+ * rows valid). Owned columns are 64-byte aligned and padded to a whole
+ * cache line; views wrap caller memory or a read-only mmap'd file and are
+ * never copied. All batch entry points take columns by pointer and work on
+ * the storage in place.
+ */
+
+#define CALC_COLUMN_ALIGN 64
+
+/**
+ * Column flags
+ */
+enum {
+    CALC_COLUMN_HUGEPAGES = 1u << 0,       /* init: try hugepage-backed storage */
+    CALC_COLUMN_OWNED = 1u << 1,           /* storage freed by calc_column_free */
+    CALC_COLUMN_MAPPED = 1u << 2,          /* storage is an mmap'd region */
+    CALC_COLUMN_READONLY = 1u << 3,        /* can't be used as an output */
+    CALC_COLUMN_OWNED_VALIDITY = 1u << 4,  /* bitmap freed by calc_column_free */
+};
+
+typedef struct {
+    int *data;              /* row values */
+    uint8_t *validity;      /* validity bitmap, NULL = all valid */
+    size_t len;             /* number of rows */
+    size_t capacity;        /* rows available in data */
+    size_t map_size;        /* bytes to munmap (CALC_COLUMN_MAPPED) */
+    void *map_base;         /* start of the mapping (CALC_COLUMN_MAPPED) */
+    unsigned flags;
+} calc_column_t;
+
+/**
+ * Allocate an owned column of len rows (values uninitialized, all valid)
+ * @param col Column to initialize
+ * @param len Number of rows
+ * @param flags 0 or CALC_COLUMN_HUGEPAGES: explicit 2 MiB hugepages, then
+ *              transparent hugepages, then regular 64-byte aligned memory
+ * @return 0 on success, -1 on allocation failure
+ */
+int calc_column_init(calc_column_t *col, size_t len, unsigned flags);
+
+/**
+ * Wrap caller memory as a column without copying
+ * @param col Column to initialize
+ * @param data Row values (any alignment)
+ * @param len Number of rows
+ * @param validity Validity bitmap of (len + 7) / 8 bytes, or NULL
+ * @note The caller keeps ownership and must outlive the column
+ */
+void calc_column_view(calc_column_t *col, int *data, size_t len, uint8_t *validity);
+
+/**
+ * Map a file of native-endian ints as a read-only column
+ * @param col Column to initialize
+ * @param path File path
+ * @param offset Byte offset of the first row (multiple of sizeof(int))
+ * @param len Number of rows, 0 = up to the end of the file
+ * @return 0 on success, -1 if the file can't be opened or is too short
+ */
+int calc_column_map_file(calc_column_t *col, const char *path, size_t offset, size_t len);
+
+/**
+ * Release the column storage (owned and mapped columns) and reset it
+ */
+void calc_column_free(calc_column_t *col);
+
+/**
+ * Attach an all-valid bitmap to an owned column that has none
+ * @return 0 on success, -1 on allocation failure or for views
+ */
+int calc_column_add_validity(calc_column_t *col);
+
+/**
+ * Mark a row valid or null (adds a bitmap if needed)
+ * @return 0 on success, -1 if a bitmap is needed but can't be added
+ */
+int calc_column_set_valid(calc_column_t *col, size_t row, int valid);
+
+/**
+ * Check whether a row is valid
+ * @return 1 if valid, 0 if null
+ */
+int calc_column_is_valid(const calc_column_t *col, size_t row);
+
+/**
+ * Count null rows
+ */
+size_t calc_column_null_count(const calc_column_t *col);
+
+/**
+ * Column batch arithmetic: out[i] = a[i] op b[i]
+ *
+ * Runs the calc_xxx_n kernels on the column storage. out may be a or b.
+ * out->len becomes a->len, and a row is valid in out only if it is valid
+ * in both inputs (values of null rows are computed but meaningless).
+ *
+ * @return 0 on success, -1 if the lengths differ, out is read-only or too
+ *         small, or out needs a validity bitmap it can't get
+ */
+int calc_column_add(const calc_column_t *a, const calc_column_t *b, calc_column_t *out);
+int calc_column_subtract(const calc_column_t *a, const calc_column_t *b, calc_column_t *out);
+int calc_column_multiply(const calc_column_t *a, const calc_column_t *b, calc_column_t *out);
+int calc_column_divide(const calc_column_t *a, const calc_column_t *b, calc_column_t *out);
+
+/**
+ * Sum the valid rows of a column with a 64-bit accumulator
+ * @param col Input column
+ * @param max_threads Thread cap, as for calc_sum_reduce
+ * @param valid_rows If not NULL, receives the number of valid rows
+ * @return Sum of the valid rows
+ */
+int64_t calc_column_sum(const calc_column_t *col, unsigned max_threads, size_t *valid_rows);
+
+#endif /* __CALC_COLUMN_H__ */
@@ -0,0 +1,141 @@
+#ifndef __CALC_FIXED_H__
+#define __CALC_FIXED_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Fixed-point arithmetic (Q formats)
+ *
+ * Q16.16: 16 integer bits (sign included) and 16 fraction bits, range
+ * [-32768, 32768) in steps of 2^-16. Q1.31: sign plus 31 fraction bits,
+ * range [-1, 1) in steps of 2^-31.
+ *
+ * Products and quotients are computed exactly in 64 bits, rounded once
+ * with the requested mode and saturated to the format's range, so no
+ * precision is lost to a pre-shift and no result wraps. Division by 0
+ * returns 0, like calc_divide.
+ *
+ * Like the calc module, every scalar operation has a batch variant over
+ * arrays (AVX2 kernels picked with the batch API ISA, see calc.h). Batch
+ * results are identical to the scalar ones; out may alias a or b.
+ */
+
+typedef int32_t calc_q16_t;     /* Q16.16 */
+typedef int32_t calc_q31_t;     /* Q1.31 */
+
+#define CALC_Q16_FRAC_BITS 16
+#define CALC_Q31_FRAC_BITS 31
+#define CALC_Q16_ONE ((calc_q16_t)1 << CALC_Q16_FRAC_BITS)
+#define CALC_Q16_MAX INT32_MAX
+#define CALC_Q16_MIN INT32_MIN
+#define CALC_Q31_MAX INT32_MAX  /* 1 - 2^-31 */
+#define CALC_Q31_MIN INT32_MIN  /* -1 */
+
+/**
+ * Rounding mode for results that fall between two representable values
+ */
+typedef enum {
+    CALC_ROUND_TRUNC = 0,       /* toward zero, like integer division */
+    CALC_ROUND_FLOOR,           /* toward negative infinity (plain shift) */
+    CALC_ROUND_NEAREST,         /* to nearest, ties away from zero */
+    CALC_ROUND_EVEN,            /* to nearest, ties to even (banker's) */
+} calc_round_t;
+
+/*============================================================================
+ * Conversions (saturating)
+ *===========================================================================*/
+
+/**
+ * Convert an integer to Q16.16
+ * @return v * 2^16, saturated to [CALC_Q16_MIN, CALC_Q16_MAX]
+ */
+calc_q16_t calc_q16_from_int(int v);
+
+/**
+ * Convert Q16.16 to an integer
+ * @param v Q16.16 value
+ * @param mode How to drop the fraction
+ * @return Integer part of v, rounded
+ */
+int calc_q16_to_int(calc_q16_t v, calc_round_t mode);
+
+/**
+ * Convert a double to Q16.16 / Q1.31, rounding to nearest (ties away from
+ * zero) and saturating; NaN converts to 0
+ */
+calc_q16_t calc_q16_from_double(double v);
+calc_q31_t calc_q31_from_double(double v);
+
+/**
+ * Convert Q16.16 / Q1.31 to a double (always exact)
+ */
+double calc_q16_to_double(calc_q16_t v);
+double calc_q31_to_double(calc_q31_t v);
+
+/*============================================================================
+ * Scalar operations
+ *===========================================================================*/
+
+/**
+ * Saturating add / subtract (same for every Q format)
+ * @param a First operand
+ * @param b Second operand
+ * @return a + b (a - b), clamped to [INT32_MIN, INT32_MAX]
+ */
+int32_t calc_fixed_add(int32_t a, int32_t b);
+int32_t calc_fixed_subtract(int32_t a, int32_t b);
+
+/**
+ * Multiply two Q16.16 values
+ * @param a First operand
+ * @param b Second operand
+ * @param mode Rounding of the 32-bit fraction of the exact product
+ * @return a * b, rounded and saturated
+ */
+calc_q16_t calc_q16_multiply(calc_q16_t a, calc_q16_t b, calc_round_t mode);
+
+/**
+ * Divide two Q16.16 values
+ * @param a Dividend
+ * @param b Divisor
+ * @param mode Rounding of the exact quotient
+ * @return a / b, rounded and saturated
+ * @note Returns 0 if divisor is 0
+ */
+calc_q16_t calc_q16_divide(calc_q16_t a, calc_q16_t b, calc_round_t mode);
+
+/**
+ * Multiply two Q1.31 values
+ * @return a * b, rounded and saturated (-1 * -1 gives CALC_Q31_MAX)
+ */
+calc_q31_t calc_q31_multiply(calc_q31_t a, calc_q31_t b, calc_round_t mode);
+
+/**
+ * Divide two Q1.31 values
+ * @return a / b, rounded and saturated (|a| > |b|, or a == b, saturates;
+ *         a == -b is exactly -1, CALC_Q31_MIN)
+ * @note Returns 0 if divisor is 0
+ */
+calc_q31_t calc_q31_divide(calc_q31_t a, calc_q31_t b, calc_round_t mode);
+
+/*============================================================================
+ * Batch API: out[i] = op(a[i], b[i])
+ *
+ * Add, subtract and multiply have AVX2 kernels; divide has no SIMD integer
+ * instruction and the exact 64-bit quotient doesn't fit a double, so it
+ * runs the scalar loop.
+ *===========================================================================*/
+
+void calc_fixed_add_n(const int32_t *a, const int32_t *b, int32_t *out, size_t n);
+void calc_fixed_subtract_n(const int32_t *a, const int32_t *b, int32_t *out, size_t n);
+void calc_q16_multiply_n(const calc_q16_t *a, const calc_q16_t *b, calc_q16_t *out, size_t n,
+                         calc_round_t mode);
+void calc_q16_divide_n(const calc_q16_t *a, const calc_q16_t *b, calc_q16_t *out, size_t n,
+                       calc_round_t mode);
+void calc_q31_multiply_n(const calc_q31_t *a, const calc_q31_t *b, calc_q31_t *out, size_t n,
+                         calc_round_t mode);
+void calc_q31_divide_n(const calc_q31_t *a, const calc_q31_t *b, calc_q31_t *out, size_t n,
+                       calc_round_t mode);
+
+#endif /* __CALC_FIXED_H__ */
@@ -0,0 +1,67 @@
+#ifndef __CALC_INLINE_H__
+#define __CALC_INLINE_H__
+
+#include "calc.h"
+
+/*
+ * Inline versions of the calc primitives
+ *
+ * Same semantics as calc_add / calc_subtract / calc_multiply / calc_divide,
+ * but visible to the compiler so calls can be inlined and constant-folded.
+ *
+ * Opt-in: define CALC_INLINE before including this header (or build with
+ * -DCALC_INLINE) to route calc_xxx(a, b) calls in that translation unit to
+ * the inline versions. The out-of-line calc_xxx symbols in libsdk are not
+ * affected, so -Wl,--wrap=calc_xxx keeps working for code built without
+ * CALC_INLINE.
+ */
+
+/**
+ * Add two integers (inline)
+ * @param a First operand
+ * @param b Second operand
+ * @return Sum of a and b
+ */
+static inline int calc_add_inline(int a, int b) {
+    return a + b;
+}
+
+/**
+ * Subtract two integers (inline)
+ * @param a First operand
+ * @param b Second operand
+ * @return Difference of a and b (a - b)
+ */
+static inline int calc_subtract_inline(int a, int b) {
+    return a - b;
+}
+
+/**
+ * Multiply two integers (inline)
+ * @param a First operand
+ * @param b Second operand
+ * @return Product of a and b
+ */
+static inline int calc_multiply_inline(int a, int b) {
+    return a * b;
+}
+
+/**
+ * Divide two integers (inline)
+ * @param a Dividend
+ * @param b Divisor
+ * @return Quotient of a and b (a / b)
+ * @note Returns 0 if divisor is 0
+ */
+static inline int calc_divide_inline(int a, int b) {
+    return b == 0 ? 0 : a / b;
+}
+
+#ifdef CALC_INLINE
+#define calc_add(a, b) calc_add_inline((a), (b))
+#define calc_subtract(a, b) calc_subtract_inline((a), (b))
+#define calc_multiply(a, b) calc_multiply_inline((a), (b))
+#define calc_divide(a, b) calc_divide_inline((a), (b))
+#endif
+
+#endif /* __CALC_INLINE_H__ */
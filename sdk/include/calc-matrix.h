@@ -0,0 +1,64 @@
+#ifndef __CALC_MATRIX_H__
+#define __CALC_MATRIX_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Integer matrix multiply (GEMM)
+ *
+ * C = A * B for row-major int matrices: A is m x k, B is k x n, C is m x n,
+ * each stored contiguously. The product is cache-blocked: B is packed in
+ * panels of 256 rows that stay in L2, A in blocks of 96 x 256 that stay in
+ * L2 while a 16 KiB sliver of B sits in L1, and a 6-row register-blocked
+ * microkernel (AVX2 when the batch ISA allows it) produces each tile of C.
+ * Output tiles of 96 x 256 are independent tasks on the SDK thread pool.
+ *
+ * Every element of C is computed by one task, summing over k in the same
+ * order, so results don't depend on the thread count. C must not overlap
+ * A or B.
+ */
+
+/**
+ * Multiply two matrices with int32 accumulation
+ * @param a m x k matrix
+ * @param b k x n matrix
+ * @param c m x n result
+ * @param m Rows of A and C
+ * @param n Columns of B and C
+ * @param k Columns of A, rows of B (k == 0 sets C to 0)
+ * @param max_threads Cap on threads used for this call, caller included
+ *                    (0 = whole SDK thread pool, 1 = calling thread only)
+ * @note Products and sums wrap modulo 2^32, like the batch API, so C is
+ *       what a loop over calc_multiply / calc_add gives when nothing
+ *       overflows, and the low 32 bits of the exact result otherwise.
+ */
+void calc_matrix_multiply(const int *a, const int *b, int *c, size_t m, size_t n, size_t k,
+                          unsigned max_threads);
+
+/**
+ * Multiply two matrices with int64 accumulation
+ * @param a m x k matrix
+ * @param b k x n matrix
+ * @param c m x n result
+ * @param m Rows of A and C
+ * @param n Columns of B and C
+ * @param k Columns of A, rows of B (k == 0 sets C to 0)
+ * @param max_threads Cap on threads used for this call, caller included
+ *                    (0 = whole SDK thread pool, 1 = calling thread only)
+ * @note Exact as long as every partial sum fits in int64 (always true for
+ *       k == 1 or when |a| and |b| stay below 2^16 with k < 2^31);
+ *       otherwise wraps modulo 2^64.
+ */
+void calc_matrix_multiply64(const int *a, const int *b, int64_t *c, size_t m, size_t n, size_t k,
+                            unsigned max_threads);
+
+/**
+ * Scalar reference: the naive triple loop over calc_multiply / calc_add
+ *
+ * Follows the scalar semantics exactly and can be intercepted with
+ * -Wl,--wrap=calc_xxx. Use it to check the blocked paths.
+ */
+void calc_matrix_multiply_ref(const int *a, const int *b, int *c, size_t m, size_t n, size_t k);
+
+#endif /* __CALC_MATRIX_H__ */
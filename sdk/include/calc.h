@@ -1,6 +1,9 @@
 #ifndef __CALC_H__
 #define __CALC_H__
 
+#include <stddef.h>
+#include <stdint.h>
+
 /**
  * Add two integers
  * @param a First operand
@@ -34,4 +37,271 @@ int calc_multiply(int a, int b);
  */
 int calc_divide(int a, int b);
 
-#endif /* __CALC_H__ */
\ No newline at end of file
+/*============================================================================
+ * Batch API
+ *
+ * Element-wise variants of the calc primitives: out[i] = op(a[i], b[i]).
+ * The kernel set (SSE2 / AVX2 / AVX-512) is picked at runtime from the CPU
+ * features. The vector kernels wrap on overflow (two's complement).
+ * out may alias a or b.
+ *===========================================================================*/
+
+/**
+ * Instruction set used by the batch kernels
+ */
+typedef enum {
+    CALC_ISA_SCALAR = 0,
+    CALC_ISA_SSE2,
+    CALC_ISA_AVX2,
+    CALC_ISA_AVX512,
+} calc_isa_t;
+
+/**
+ * Add two arrays element by element
+ * @param a First operand array
+ * @param b Second operand array
+ * @param out Result array (a[i] + b[i])
+ * @param n Number of elements
+ */
+void calc_add_n(const int *a, const int *b, int *out, size_t n);
+
+/**
+ * Subtract two arrays element by element
+ * @param a First operand array
+ * @param b Second operand array
+ * @param out Result array (a[i] - b[i])
+ * @param n Number of elements
+ */
+void calc_subtract_n(const int *a, const int *b, int *out, size_t n);
+
+/**
+ * Multiply two arrays element by element
+ * @param a First operand array
+ * @param b Second operand array
+ * @param out Result array (a[i] * b[i])
+ * @param n Number of elements
+ */
+void calc_multiply_n(const int *a, const int *b, int *out, size_t n);
+
+/**
+ * Divide two arrays element by element
+ * @param a Dividend array
+ * @param b Divisor array
+ * @param out Result array (a[i] / b[i])
+ * @param n Number of elements
+ * @note out[i] is 0 wherever b[i] is 0
+ */
+void calc_divide_n(const int *a, const int *b, int *out, size_t n);
+
+/**
+ * Scalar references for the batch API
+ *
+ * These loop over calc_add / calc_subtract / calc_multiply / calc_divide one
+ * element at a time, so they follow the scalar semantics exactly and can be
+ * intercepted with -Wl,--wrap=calc_xxx. Use them to check the vector paths.
+ */
+void calc_add_n_ref(const int *a, const int *b, int *out, size_t n);
+void calc_subtract_n_ref(const int *a, const int *b, int *out, size_t n);
+void calc_multiply_n_ref(const int *a, const int *b, int *out, size_t n);
+void calc_divide_n_ref(const int *a, const int *b, int *out, size_t n);
+
+/**
+ * Get the instruction set used by the batch API
+ * @return Active ISA (best supported one unless overridden)
+ */
+calc_isa_t calc_batch_get_isa(void);
+
+/**
+ * Force the batch API onto a given instruction set
+ * @param isa ISA to use
+ * @return 0 on success, -1 if the CPU (or build) does not support it
+ */
+int calc_batch_set_isa(calc_isa_t isa);
+
+/**
+ * Check whether an instruction set is usable on this CPU
+ * @param isa ISA to check
+ * @return 1 if supported, 0 otherwise
+ */
+int calc_batch_isa_supported(calc_isa_t isa);
+
+/*============================================================================
+ * Precomputed Divider
+ *
+ * Division by a runtime-invariant divisor as a multiply-shift: build the
+ * divider once, then every quotient costs a 64-bit multiply instead of an
+ * idiv. Results match calc_divide, including 0 for a 0 divisor.
+ *===========================================================================*/
+
+/**
+ * Precomputed divisor (treat fields as opaque)
+ */
+typedef struct {
+    uint64_t magic;   /* ceil(2^shift / |divisor|), 0 for divisor 0 */
+    uint32_t shift;   /* 32 + ceil(log2(|divisor|)) */
+    uint32_t sign;    /* 0 for positive divisors, 0xFFFFFFFF for negative */
+} calc_divider_t;
+
+/**
+ * Build a divider for a divisor
+ * @param div Divider to initialize
+ * @param divisor Divisor (0 is allowed and always yields 0)
+ */
+void calc_divider_init(calc_divider_t *div, int divisor);
+
+/**
+ * Divide by a precomputed divisor
+ * @param div Divider built by calc_divider_init
+ * @param a Dividend
+ * @return Quotient truncated toward zero, same as calc_divide(a, divisor)
+ */
+int calc_divider_divide(const calc_divider_t *div, int a);
+
+/**
+ * Divide an array by a precomputed divisor
+ * @param div Divider built by calc_divider_init
+ * @param a Dividend array
+ * @param out Result array (a[i] / divisor), may alias a
+ * @param n Number of elements
+ */
+void calc_divider_divide_n(const calc_divider_t *div, const int *a, int *out, size_t n);
+
+/*============================================================================
+ * Overflow-Checked Arithmetic
+ *
+ * Built on the compiler overflow builtins. The wrapped (two's complement)
+ * result is always stored, the return value tells whether it overflowed.
+ *===========================================================================*/
+
+/**
+ * Add two integers with overflow check
+ * @param a First operand
+ * @param b Second operand
+ * @param result Receives a + b (wrapped on overflow)
+ * @return 0 on success, -1 on overflow
+ */
+int calc_add_checked(int a, int b, int *result);
+
+/**
+ * Subtract two integers with overflow check
+ * @param a First operand
+ * @param b Second operand
+ * @param result Receives a - b (wrapped on overflow)
+ * @return 0 on success, -1 on overflow
+ */
+int calc_subtract_checked(int a, int b, int *result);
+
+/**
+ * Multiply two integers with overflow check
+ * @param a First operand
+ * @param b Second operand
+ * @param result Receives a * b (wrapped on overflow)
+ * @return 0 on success, -1 on overflow
+ */
+int calc_multiply_checked(int a, int b, int *result);
+
+/**
+ * Divide two integers with overflow check
+ * @param a Dividend
+ * @param b Divisor
+ * @param result Receives a / b (0 if b is 0, INT_MIN for INT_MIN / -1)
+ * @return 0 on success, -1 on overflow (only INT_MIN / -1)
+ * @note Division by 0 is not an error: the result is 0, like calc_divide
+ */
+int calc_divide_checked(int a, int b, int *result);
+
+/*============================================================================
+ * Saturating Arithmetic
+ *
+ * Results clamp to INT_MIN / INT_MAX instead of overflowing.
+ *===========================================================================*/
+
+/**
+ * Add two integers, clamping to INT_MIN / INT_MAX
+ * @param a First operand
+ * @param b Second operand
+ * @return a + b, or INT_MIN / INT_MAX if it overflows
+ */
+int calc_add_sat(int a, int b);
+
+/**
+ * Subtract two integers, clamping to INT_MIN / INT_MAX
+ * @param a First operand
+ * @param b Second operand
+ * @return a - b, or INT_MIN / INT_MAX if it overflows
+ */
+int calc_subtract_sat(int a, int b);
+
+/**
+ * Multiply two integers, clamping to INT_MIN / INT_MAX
+ * @param a First operand
+ * @param b Second operand
+ * @return a * b, or INT_MIN / INT_MAX if it overflows
+ */
+int calc_multiply_sat(int a, int b);
+
+/**
+ * Divide two integers, clamping INT_MIN / -1 to INT_MAX
+ * @param a Dividend
+ * @param b Divisor
+ * @return a / b, INT_MAX for INT_MIN / -1
+ * @note Returns 0 if divisor is 0
+ */
+int calc_divide_sat(int a, int b);
+
+/**
+ * Saturating batch variants (branch-free)
+ *
+ * out[i] = op_sat(a[i], b[i]). If overflow_mask is not NULL it must hold
+ * (n + 7) / 8 bytes; bit (i % 8) of byte (i / 8) is set when lane i
+ * saturated, unused bits of the last byte are cleared.
+ *
+ * @return Number of lanes that saturated
+ */
+size_t calc_add_sat_n(const int *a, const int *b, int *out, uint8_t *overflow_mask, size_t n);
+size_t calc_subtract_sat_n(const int *a, const int *b, int *out, uint8_t *overflow_mask, size_t n);
+size_t calc_multiply_sat_n(const int *a, const int *b, int *out, uint8_t *overflow_mask, size_t n);
+size_t calc_divide_sat_n(const int *a, const int *b, int *out, uint8_t *overflow_mask, size_t n);
+
+/*============================================================================
+ * Reductions
+ *===========================================================================*/
+
+/**
+ * Sum an array of integers with a 64-bit accumulator
+ * @param a Input array
+ * @param n Number of elements
+ * @param max_threads Cap on threads used for this call, caller included
+ *                    (0 = whole SDK thread pool, 1 = calling thread only)
+ * @return a[0] + ... + a[n - 1], 0 for n == 0
+ *
+ * @note Large inputs are split into fixed 256 KiB chunks that run on the
+ *       SDK thread pool (see sdk-pool.h); the per-chunk sums are combined
+ *       in order, so the result is the same for every thread count. The sum
+ *       is exact for n < 2^32.
+ */
+int64_t calc_sum_reduce(const int *a, size_t n, unsigned max_threads);
+
+/**
+ * Prefix sums (scans)
+ *
+ * Inclusive: out[i] = a[0] + ... + a[i]
+ * Exclusive: out[i] = a[0] + ... + a[i - 1], out[0] = 0
+ *
+ * @param a Input array
+ * @param out Output array of n elements (may be the same as a for the
+ *            32-bit variants)
+ * @param n Number of elements
+ * @param max_threads Cap on threads used for this call, caller included
+ *                    (0 = whole SDK thread pool, 1 = calling thread only)
+ *
+ * @note The int variants wrap modulo 2^32 on overflow, like the batch API.
+ *       The 64-bit variants are exact for n < 2^32. Large inputs use a
+ *       two-pass (chunk sums, then chunk scans) scheme on the thread pool.
+ */
+void calc_inclusive_scan(const int *a, int *out, size_t n, unsigned max_threads);
+void calc_exclusive_scan(const int *a, int *out, size_t n, unsigned max_threads);
+void calc_inclusive_scan64(const int *a, int64_t *out, size_t n, unsigned max_threads);
+void calc_exclusive_scan64(const int *a, int64_t *out, size_t n, unsigned max_threads);
+
+#endif /* __CALC_H__ */
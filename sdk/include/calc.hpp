@@ -0,0 +1,221 @@
+#ifndef __CALC_HPP__
+#define __CALC_HPP__
+
+/*
+ * Type-generic C++17 interface to the calc module
+ *
+ * calc::add / subtract / multiply / divide are constexpr templates for
+ * int8_t .. int64_t, float and double, with the same semantics as the C
+ * calc_xxx functions (divide by 0 returns 0). With constant operands they
+ * fold at compile time:
+ *
+ *     static_assert(calc::divide(10, 0) == 0);
+ *
+ * calc::add_n / subtract_n / multiply_n / divide_n are the matching batch
+ * kernels for every element width. They use GCC vector extensions with
+ * 16-byte vectors (SSE2 on x86-64, NEON on AArch64), so no ISA flags are
+ * needed and the vector ABI stays the baseline one.
+ * int batches go to the C batch API and its runtime ISA dispatch.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+extern "C" {
+#include "calc.h"
+}
+
+namespace calc {
+
+/**
+ * Element types supported by the calc templates
+ */
+template <typename T>
+struct is_calc_type : std::integral_constant<bool,
+    std::is_same<T, int8_t>::value || std::is_same<T, int16_t>::value ||
+    std::is_same<T, int32_t>::value || std::is_same<T, int64_t>::value ||
+    std::is_same<T, float>::value || std::is_same<T, double>::value> {
+};
+
+template <typename T>
+inline constexpr bool is_calc_type_v = is_calc_type<T>::value;
+
+template <typename T>
+using enable_if_calc_type_t = std::enable_if_t<is_calc_type_v<T>, T>;
+
+/*============================================================================
+ * Scalar (constexpr)
+ *===========================================================================*/
+
+/**
+ * Add two values
+ * @return a + b
+ */
+template <typename T>
+constexpr enable_if_calc_type_t<T> add(T a, T b) noexcept {
+    return static_cast<T>(a + b);
+}
+
+/**
+ * Subtract two values
+ * @return a - b
+ */
+template <typename T>
+constexpr enable_if_calc_type_t<T> subtract(T a, T b) noexcept {
+    return static_cast<T>(a - b);
+}
+
+/**
+ * Multiply two values
+ * @return a * b
+ */
+template <typename T>
+constexpr enable_if_calc_type_t<T> multiply(T a, T b) noexcept {
+    return static_cast<T>(a * b);
+}
+
+/**
+ * Divide two values
+ * @return a / b
+ * @note Returns 0 if divisor is 0, like calc_divide. For integers, MIN / -1
+ *       wraps to MIN like the batch API instead of trapping
+ */
+template <typename T>
+constexpr enable_if_calc_type_t<T> divide(T a, T b) noexcept {
+    if constexpr (std::is_integral<T>::value) {
+        if (b == T(-1)) {
+            return static_cast<T>(std::make_unsigned_t<T>(0) - static_cast<std::make_unsigned_t<T>>(a));
+        }
+    }
+    return b == T(0) ? T(0) : static_cast<T>(a / b);
+}
+
+/*============================================================================
+ * Batch kernels
+ *===========================================================================*/
+
+namespace detail {
+
+template <typename T>
+struct vector_of {
+    typedef T type __attribute__((vector_size(16)));
+    static constexpr std::size_t lanes = 16 / sizeof(T);
+};
+
+struct add_op {
+    template <typename V>
+    V operator()(V a, V b) const { return a + b; }
+};
+
+struct subtract_op {
+    template <typename V>
+    V operator()(V a, V b) const { return a - b; }
+};
+
+struct multiply_op {
+    template <typename V>
+    V operator()(V a, V b) const { return a * b; }
+};
+
+template <typename T, bool = std::is_integral<T>::value>
+struct divide_op {
+    template <typename V>
+    V operator()(V a, V b) const {
+        // Divide zero lanes by 1, then clear them
+        V zero = b - b;
+        auto is_zero = b == zero;
+        V safe = is_zero ? zero + 1 : b;
+        V q = a / safe;
+        return is_zero ? zero : q;
+    }
+};
+
+// Integer lanes: MIN / -1 traps like a zero divisor, so -1 lanes divide by
+// 1 too and take the wrapped negation instead
+template <typename T>
+struct divide_op<T, true> {
+    template <typename V>
+    V operator()(V a, V b) const {
+        typedef std::make_unsigned_t<T> UV __attribute__((vector_size(16)));
+        V zero = b - b;
+        auto is_zero = b == zero;
+        auto is_minus_one = b == zero - 1;
+        V safe = (is_zero | is_minus_one) ? zero + 1 : b;
+        V q = a / safe;
+        V negated = (V)((UV)zero - (UV)a);
+        return is_zero ? zero : (is_minus_one ? negated : q);
+    }
+};
+
+template <typename T, typename VectorOp, typename ScalarOp>
+inline void apply_n(const T *a, const T *b, T *out, std::size_t n, VectorOp vop, ScalarOp sop) {
+    using V = typename vector_of<T>::type;
+    constexpr std::size_t lanes = vector_of<T>::lanes;
+    std::size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        V va, vb;
+        std::memcpy(&va, a + i, sizeof(V));
+        std::memcpy(&vb, b + i, sizeof(V));
+        V vr = vop(va, vb);
+        std::memcpy(out + i, &vr, sizeof(V));
+    }
+    for (; i < n; i++) {
+        out[i] = sop(a[i], b[i]);
+    }
+}
+
+} // namespace detail
+
+/**
+ * out[i] = a[i] + b[i]
+ */
+template <typename T>
+inline std::enable_if_t<is_calc_type_v<T>> add_n(const T *a, const T *b, T *out, std::size_t n) {
+    if constexpr (std::is_same<T, int>::value) {
+        calc_add_n(a, b, out, n);
+    } else {
+        detail::apply_n(a, b, out, n, detail::add_op(), add<T>);
+    }
+}
+
+/**
+ * out[i] = a[i] - b[i]
+ */
+template <typename T>
+inline std::enable_if_t<is_calc_type_v<T>> subtract_n(const T *a, const T *b, T *out, std::size_t n) {
+    if constexpr (std::is_same<T, int>::value) {
+        calc_subtract_n(a, b, out, n);
+    } else {
+        detail::apply_n(a, b, out, n, detail::subtract_op(), subtract<T>);
+    }
+}
+
+/**
+ * out[i] = a[i] * b[i]
+ */
+template <typename T>
+inline std::enable_if_t<is_calc_type_v<T>> multiply_n(const T *a, const T *b, T *out, std::size_t n) {
+    if constexpr (std::is_same<T, int>::value) {
+        calc_multiply_n(a, b, out, n);
+    } else {
+        detail::apply_n(a, b, out, n, detail::multiply_op(), multiply<T>);
+    }
+}
+
+/**
+ * out[i] = a[i] / b[i], 0 wherever b[i] is 0, MIN / -1 wraps to MIN
+ */
+template <typename T>
+inline std::enable_if_t<is_calc_type_v<T>> divide_n(const T *a, const T *b, T *out, std::size_t n) {
+    if constexpr (std::is_same<T, int>::value) {
+        calc_divide_n(a, b, out, n);
+    } else {
+        detail::apply_n(a, b, out, n, detail::divide_op<T>(), divide<T>);
+    }
+}
+
+} // namespace calc
+
+#endif /* __CALC_HPP__ */
@@ -0,0 +1,129 @@
+#ifndef __MULTI_CALC_EXPR_H__
+#define __MULTI_CALC_EXPR_H__
+
+#include <stddef.h>
+
+/*
+ * Formula engine for multi-calc
+ *
+ * Compiles a formula over named int inputs, e.g. "(a + b) * (c - d)", into
+ * register bytecode and evaluates it over batches. Every instruction runs
+ * on a block of MULTI_CALC_EXPR_BLOCK rows through the calc batch kernels,
+ * so interpreter dispatch costs one branch per 1024 rows.
+ *
+ * Grammar (usual precedence, left associative):
+ *     expr    := term (('+' | '-') term)*
+ *     term    := unary (('*' | '/') unary)*
+ *     unary   := ('-' | '+') unary | primary
+ *     primary := number | name | func '(' expr ',' expr ')' | '(' expr ')'
+ *     func    := add | subtract | multiply | divide  (optional calc_ prefix)
+ *
+ * Semantics follow the calc primitives: divide by 0 returns 0. Overflow
+ * wraps modulo 2^32 (INT_MIN / -1 = INT_MIN) like the calc batch API.
+ * Constant subterms are folded and repeated subterms are computed once.
+ * Nesting (parentheses, function calls and signs) is limited to
+ * MULTI_CALC_EXPR_MAX_DEPTH levels; deeper formulas are syntax errors at
+ * the first character past the limit.
+ *
+ * A formula set compiles several formulas over the same inputs into one
+ * DAG: a subterm shared by any of them (e.g. "a + b") is evaluated once per
+ * tile for all of them. Tiles shrink below MULTI_CALC_EXPR_BLOCK rows when
+ * a tile of every input, output and temporary would exceed
+ * MULTI_CALC_EXPR_TILE_BYTES, so intermediates stay in L2.
+ */
+
+#define MULTI_CALC_EXPR_BLOCK 1024
+#define MULTI_CALC_EXPR_TILE_BYTES (128 * 1024)
+#define MULTI_CALC_EXPR_MAX_DEPTH 256
+
+typedef struct multi_calc_expr multi_calc_expr_t;
+
+/**
+ * Compile a formula
+ * @param formula Formula text
+ * @param names Input names; input i is referenced by names[i]
+ * @param ninputs Number of inputs
+ * @param error_pos If not NULL, receives the byte offset of a syntax error
+ * @return Compiled formula, or NULL on a syntax error, an unknown name or
+ *         out of memory
+ */
+multi_calc_expr_t *multi_calc_expr_compile(const char *formula, const char *const *names,
+                                           size_t ninputs, size_t *error_pos);
+
+/**
+ * Free a compiled formula (NULL is ignored)
+ */
+void multi_calc_expr_free(multi_calc_expr_t *expr);
+
+/**
+ * Evaluate a formula for one row
+ * @param expr Compiled formula
+ * @param values values[i] is the value of input i
+ * @return Formula result (the first formula's for a formula set)
+ */
+int multi_calc_expr_eval(const multi_calc_expr_t *expr, const int *values);
+
+/**
+ * Evaluate a formula over n rows
+ * @param expr Compiled formula
+ * @param inputs inputs[i] is the array of n values of input i
+ * @param out Result array of n elements (must not overlap the inputs)
+ * @param n Number of rows
+ * @return 0 on success, -1 if scratch memory can't be allocated or expr is
+ *         a formula set with more than one formula
+ * @note Safe to call concurrently on the same compiled formula
+ */
+int multi_calc_expr_eval_n(const multi_calc_expr_t *expr, const int *const *inputs,
+                           int *out, size_t n);
+
+/*============================================================================
+ * Formula sets
+ *===========================================================================*/
+
+/**
+ * Compile statistics
+ */
+typedef struct {
+    size_t formulas;        /* formulas in the set */
+    size_t source_ops;      /* arithmetic ops as written in the formulas */
+    size_t ops;             /* ops left after CSE and constant folding */
+    size_t ops_eliminated;  /* source_ops - ops */
+    size_t tile_rows;       /* rows per evaluation tile */
+} multi_calc_expr_stats_t;
+
+/**
+ * Compile several formulas over the same inputs into one shared DAG
+ * @param formulas Formula texts; result i of the set is formulas[i]
+ * @param nformulas Number of formulas (at least 1)
+ * @param names Input names; input i is referenced by names[i]
+ * @param ninputs Number of inputs
+ * @param error_index If not NULL, receives the index of the formula with a
+ *                    syntax error
+ * @param error_pos If not NULL, receives the byte offset of the error in
+ *                  that formula
+ * @return Compiled set (free with multi_calc_expr_free), or NULL on a
+ *         syntax error, nformulas == 0 or out of memory
+ */
+multi_calc_expr_t *multi_calc_expr_compile_set(const char *const *formulas, size_t nformulas,
+                                               const char *const *names, size_t ninputs,
+                                               size_t *error_index, size_t *error_pos);
+
+/**
+ * Evaluate every formula of a set over n rows
+ * @param expr Compiled set (or single formula)
+ * @param inputs inputs[i] is the array of n values of input i
+ * @param outputs outputs[k] receives the n results of formula k (must not
+ *                overlap the inputs or each other)
+ * @param n Number of rows
+ * @return 0 on success, -1 if scratch memory can't be allocated
+ * @note Safe to call concurrently on the same compiled set
+ */
+int multi_calc_expr_eval_set_n(const multi_calc_expr_t *expr, const int *const *inputs,
+                               int *const *outputs, size_t n);
+
+/**
+ * Get compile statistics, e.g. how many ops CSE eliminated
+ */
+void multi_calc_expr_get_stats(const multi_calc_expr_t *expr, multi_calc_expr_stats_t *stats);
+
+#endif /* __MULTI_CALC_EXPR_H__ */
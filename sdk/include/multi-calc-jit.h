@@ -0,0 +1,71 @@
+#ifndef __MULTI_CALC_JIT_H__
+#define __MULTI_CALC_JIT_H__
+
+#include <stddef.h>
+
+/*
+ * Native-code mode for multi-calc formulas
+ *
+ * Formulas (same grammar and semantics as multi-calc-expr.h) are compiled
+ * to AVX2 machine code for x86-64, 8 rows per loop iteration. Code is
+ * written to private mmap'd pages that are switched from writable to
+ * executable before first use, so no page is ever writable and executable
+ * at the same time (W^X).
+ *
+ * Where native code can't be produced (non-x86-64 build, batch ISA below
+ * AVX2 when the formula is compiled, or the system refuses executable
+ * mappings) the formula runs on the bytecode interpreter instead, with
+ * identical results.
+ *
+ * Compiled formulas are cached by formula text and input names, so asking
+ * for the same formula again is a hash lookup.
+ */
+
+typedef struct multi_calc_jit multi_calc_jit_t;
+
+/**
+ * Get a compiled formula from the cache, compiling it on a miss
+ * @param formula Formula text
+ * @param names Input names; input i is referenced by names[i]
+ * @param ninputs Number of inputs
+ * @param error_pos If not NULL, receives the byte offset of a syntax error
+ * @return Compiled formula (release with multi_calc_jit_release), or NULL
+ *         on a syntax error or out of memory
+ * @note Thread-safe
+ */
+multi_calc_jit_t *multi_calc_jit_get(const char *formula, const char *const *names,
+                                     size_t ninputs, size_t *error_pos);
+
+/**
+ * Drop a reference returned by multi_calc_jit_get (NULL is ignored)
+ */
+void multi_calc_jit_release(multi_calc_jit_t *jit);
+
+/**
+ * Evaluate a compiled formula over n rows
+ * @param jit Compiled formula
+ * @param inputs inputs[i] is the array of n values of input i
+ * @param out Result array of n elements (must not overlap the inputs)
+ * @param n Number of rows
+ * @return 0 on success, -1 if scratch memory can't be allocated
+ * @note Safe to call concurrently on the same compiled formula
+ */
+int multi_calc_jit_eval_n(const multi_calc_jit_t *jit, const int *const *inputs, int *out, size_t n);
+
+/**
+ * Check whether a compiled formula runs as native code
+ * @return 1 for native code, 0 for the interpreter fallback
+ */
+int multi_calc_jit_is_native(const multi_calc_jit_t *jit);
+
+/**
+ * Get the number of cached formulas
+ */
+size_t multi_calc_jit_cache_size(void);
+
+/**
+ * Empty the cache (formulas still referenced stay valid until released)
+ */
+void multi_calc_jit_cache_clear(void);
+
+#endif /* __MULTI_CALC_JIT_H__ */
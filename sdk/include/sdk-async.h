@@ -0,0 +1,123 @@
+#ifndef __SDK_ASYNC_H__
+#define __SDK_ASYNC_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Asynchronous submission / completion interface for SDK batch work
+ *
+ * A ring owns a bounded submission queue, a completion queue and its own
+ * worker threads. Callers submit batch requests without blocking and get
+ * results back in one of three ways:
+ *   - sdk_async_poll: non-blocking reap from the completion queue
+ *   - sdk_async_eventfd: an eventfd that is readable while completions are
+ *     queued, for epoll / poll based event loops (then sdk_async_poll)
+ *   - a per-request callback, run on the worker thread at completion
+ *     (such requests never reach the completion queue)
+ *
+ * Operand and output arrays are owned by the caller and must stay valid
+ * until the request completes. A ring accepts at most `entries` requests
+ * that haven't been reaped yet, so the completion queue can't overflow.
+ */
+
+/**
+ * Request types
+ */
+typedef enum {
+    SDK_ASYNC_CALC_ADD,                 /* out[i] = a[i] + b[i] */
+    SDK_ASYNC_CALC_SUBTRACT,            /* out[i] = a[i] - b[i] */
+    SDK_ASYNC_CALC_MULTIPLY,            /* out[i] = a[i] * b[i] */
+    SDK_ASYNC_CALC_DIVIDE,              /* out[i] = a[i] / b[i], 0 if b[i] is 0 */
+    SDK_ASYNC_MULTI_CALC_EXPRESSION,    /* out[i] = (a[i] + b[i]) * (c[i] - d[i]) */
+    SDK_ASYNC_MULTI_CALC_AVERAGE,       /* result = average of a[0 .. n) */
+    SDK_ASYNC_OP_COUNT
+} sdk_async_op_t;
+
+/**
+ * Completion entry
+ */
+typedef struct {
+    uint64_t user_data;     /* copied from the request */
+    int status;             /* 0 = completed */
+    int result;             /* SDK_ASYNC_MULTI_CALC_AVERAGE result, else 0 */
+} sdk_async_cqe_t;
+
+/**
+ * Completion callback
+ * @param ctx callback_ctx of the request
+ * @param cqe Completion entry (only valid during the call)
+ */
+typedef void (*sdk_async_callback_fn)(void *ctx, const sdk_async_cqe_t *cqe);
+
+/**
+ * Submission entry
+ */
+typedef struct {
+    sdk_async_op_t op;
+    const int *a;
+    const int *b;                       /* unused by AVERAGE */
+    const int *c;                       /* EXPRESSION only */
+    const int *d;                       /* EXPRESSION only */
+    int *out;                           /* unused by AVERAGE */
+    size_t n;                           /* number of elements */
+    uint64_t user_data;                 /* returned in the completion */
+    sdk_async_callback_fn callback;     /* NULL = post to the completion queue */
+    void *callback_ctx;
+} sdk_async_sqe_t;
+
+typedef struct sdk_async sdk_async_t;
+
+/**
+ * Create a ring
+ * @param entries Maximum number of requests in flight (at least 1)
+ * @param nworkers Worker threads executing requests (0 = 1)
+ * @return Ring, or NULL if entries is 0 or resources can't be allocated
+ */
+sdk_async_t *sdk_async_create(unsigned entries, unsigned nworkers);
+
+/**
+ * Wait for every submitted request to finish, then free the ring
+ * @note Completions not yet reaped are discarded
+ */
+void sdk_async_destroy(sdk_async_t *ring);
+
+/**
+ * Queue a request (never blocks)
+ * @param ring Ring
+ * @param sqe Request, copied into the submission queue
+ * @return 0 on success, -1 if the ring is full or the request is invalid
+ *         (unknown op, or a NULL array for n > 0)
+ */
+int sdk_async_submit(sdk_async_t *ring, const sdk_async_sqe_t *sqe);
+
+/**
+ * Reap completions without blocking
+ * @param ring Ring
+ * @param cqes Receives up to max completions, in completion order
+ * @param max Capacity of cqes
+ * @return Number of completions reaped
+ */
+unsigned sdk_async_poll(sdk_async_t *ring, sdk_async_cqe_t *cqes, unsigned max);
+
+/**
+ * Reap completions, blocking until at least one is available
+ * @return Number of completions reaped, 0 once nothing is in flight and no
+ *         completion callback is running
+ */
+unsigned sdk_async_wait(sdk_async_t *ring, sdk_async_cqe_t *cqes, unsigned max);
+
+/**
+ * Get an eventfd that is readable while the completion queue is non-empty
+ * @return File descriptor owned by the ring, -1 if eventfd is unavailable
+ * @note Reaping with sdk_async_poll / sdk_async_wait resets it; don't read it
+ */
+int sdk_async_eventfd(const sdk_async_t *ring);
+
+/**
+ * Get the number of requests submitted and not yet reaped (callback
+ * requests count until their callback starts, so it may submit again)
+ */
+unsigned sdk_async_inflight(sdk_async_t *ring);
+
+#endif /* __SDK_ASYNC_H__ */
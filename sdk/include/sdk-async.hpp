@@ -0,0 +1,162 @@
+#ifndef __SDK_ASYNC_HPP__
+#define __SDK_ASYNC_HPP__
+
+/*
+ * C++20 coroutine interface to the SDK async rings
+ *
+ * sdk::async::op is an awaitable for one request: co_await submits it with
+ * a completion callback and suspends; the coroutine resumes on the ring's
+ * worker thread when the request completes. co_await yields the completion
+ * entry; status is -1 if the request couldn't be submitted (ring full or
+ * invalid request), in which case the coroutine isn't suspended.
+ *
+ *     sdk::async::ring ring(64);
+ *     sdk_async_cqe_t cqe = co_await sdk::async::add(ring, a, b, out, n);
+ *     int avg = (co_await sdk::async::average(ring, out, n)).result;
+ *
+ * The request arrays must outlive the co_await. A coroutine resumed on a
+ * worker thread must not destroy the ring it was resumed from.
+ */
+
+#if __cplusplus < 202002L
+#error "sdk-async.hpp requires C++20"
+#endif
+
+#include <coroutine>
+#include <cstddef>
+
+extern "C" {
+#include "sdk-async.h"
+}
+
+namespace sdk::async {
+
+/**
+ * Owning wrapper around sdk_async_t
+ */
+class ring {
+public:
+    explicit ring(unsigned entries, unsigned nworkers = 1)
+        : ring_(sdk_async_create(entries, nworkers)) {}
+    ~ring() { sdk_async_destroy(ring_); }
+
+    ring(const ring &) = delete;
+    ring &operator=(const ring &) = delete;
+
+    explicit operator bool() const noexcept { return ring_ != nullptr; }
+    sdk_async_t *get() const noexcept { return ring_; }
+
+private:
+    sdk_async_t *ring_;
+};
+
+/**
+ * Awaitable for one request
+ */
+class op {
+public:
+    op(sdk_async_t *ring, const sdk_async_sqe_t &sqe) noexcept : ring_(ring), sqe_(sqe) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) noexcept {
+        handle_ = handle;
+        sqe_.callback = &op::on_complete;
+        sqe_.callback_ctx = this;
+        if (ring_ == nullptr || sdk_async_submit(ring_, &sqe_) != 0) {
+            cqe_.user_data = sqe_.user_data;
+            cqe_.status = -1;
+            return false;  // resume right away
+        }
+        // From here on the worker may already have resumed the coroutine
+        return true;
+    }
+
+    sdk_async_cqe_t await_resume() const noexcept { return cqe_; }
+
+private:
+    static void on_complete(void *ctx, const sdk_async_cqe_t *cqe) {
+        op *self = static_cast<op *>(ctx);
+        self->cqe_ = *cqe;
+        self->handle_.resume();
+    }
+
+    sdk_async_t *ring_;
+    sdk_async_sqe_t sqe_;
+    sdk_async_cqe_t cqe_ = {};
+    std::coroutine_handle<> handle_;
+};
+
+namespace detail {
+
+inline op binary(const ring &r, sdk_async_op_t kind, const int *a, const int *b, int *out,
+                 std::size_t n) noexcept {
+    sdk_async_sqe_t sqe = {};
+    sqe.op = kind;
+    sqe.a = a;
+    sqe.b = b;
+    sqe.out = out;
+    sqe.n = n;
+    return op(r.get(), sqe);
+}
+
+} // namespace detail
+
+/**
+ * out[i] = a[i] + b[i]
+ */
+inline op add(const ring &r, const int *a, const int *b, int *out, std::size_t n) noexcept {
+    return detail::binary(r, SDK_ASYNC_CALC_ADD, a, b, out, n);
+}
+
+/**
+ * out[i] = a[i] - b[i]
+ */
+inline op subtract(const ring &r, const int *a, const int *b, int *out, std::size_t n) noexcept {
+    return detail::binary(r, SDK_ASYNC_CALC_SUBTRACT, a, b, out, n);
+}
+
+/**
+ * out[i] = a[i] * b[i]
+ */
+inline op multiply(const ring &r, const int *a, const int *b, int *out, std::size_t n) noexcept {
+    return detail::binary(r, SDK_ASYNC_CALC_MULTIPLY, a, b, out, n);
+}
+
+/**
+ * out[i] = a[i] / b[i], 0 wherever b[i] is 0
+ */
+inline op divide(const ring &r, const int *a, const int *b, int *out, std::size_t n) noexcept {
+    return detail::binary(r, SDK_ASYNC_CALC_DIVIDE, a, b, out, n);
+}
+
+/**
+ * out[i] = (a[i] + b[i]) * (c[i] - d[i])
+ */
+inline op expression(const ring &r, const int *a, const int *b, const int *c, const int *d,
+                     int *out, std::size_t n) noexcept {
+    sdk_async_sqe_t sqe = {};
+    sqe.op = SDK_ASYNC_MULTI_CALC_EXPRESSION;
+    sqe.a = a;
+    sqe.b = b;
+    sqe.c = c;
+    sqe.d = d;
+    sqe.out = out;
+    sqe.n = n;
+    return op(r.get(), sqe);
+}
+
+/**
+ * Average of values[0 .. n), returned in the completion's result
+ */
+inline op average(const ring &r, const int *values, std::size_t n) noexcept {
+    sdk_async_sqe_t sqe = {};
+    sqe.op = SDK_ASYNC_MULTI_CALC_AVERAGE;
+    sqe.a = values;
+    sqe.n = n;
+    return op(r.get(), sqe);
+}
+
+} // namespace sdk::async
+
+#endif /* __SDK_ASYNC_HPP__ */
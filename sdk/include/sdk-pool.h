@@ -0,0 +1,54 @@
+#ifndef __SDK_POOL_H__
+#define __SDK_POOL_H__
+
+#include <stddef.h>
+
+/*
+ * Persistent SDK thread pool
+ *
+ * Worker threads are started on first use and reused by every parallel SDK
+ * call. The default size is the number of online CPUs (caller included);
+ * the SDK_THREADS environment variable overrides it.
+ *
+ * One parallel_for runs at a time. A call made while the pool is busy, or
+ * from inside a pool task, runs serially on the calling thread, so nested
+ * and concurrent use never deadlocks.
+ */
+
+/**
+ * Task callback
+ * @param ctx User context passed to sdk_pool_parallel_for
+ * @param task Task index in [0, ntasks)
+ */
+typedef void (*sdk_pool_task_fn)(void *ctx, size_t task);
+
+/**
+ * Run fn(ctx, i) for every i in [0, ntasks) and wait for completion
+ * @param ntasks Number of tasks
+ * @param max_threads Cap on threads used for this call, caller included
+ *                    (0 = whole pool)
+ * @param fn Task callback
+ * @param ctx User context
+ * @note Tasks are handed out dynamically, in increasing index order
+ */
+void sdk_pool_parallel_for(size_t ntasks, unsigned max_threads, sdk_pool_task_fn fn, void *ctx);
+
+/**
+ * Get the pool size
+ * @return Number of threads a parallel call can use, caller included
+ */
+unsigned sdk_pool_size(void);
+
+/**
+ * Resize the pool
+ * @param nthreads New size, caller included (0 = number of online CPUs)
+ * @return 0 on success, -1 if the pool is busy or threads can't be created
+ */
+int sdk_pool_set_size(unsigned nthreads);
+
+/**
+ * Stop and join all worker threads (they restart on next use)
+ */
+void sdk_pool_shutdown(void);
+
+#endif /* __SDK_POOL_H__ */
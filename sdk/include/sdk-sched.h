@@ -0,0 +1,83 @@
+#ifndef __SDK_SCHED_H__
+#define __SDK_SCHED_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Work-stealing SDK scheduler
+ *
+ * For long lists of uneven jobs, where static partitioning leaves threads
+ * idle. Every worker owns a Chase-Lev deque of index ranges: it splits its
+ * range in halves, keeps the lower half and pushes the upper half onto the
+ * bottom of its deque, down to the grain size. Idle workers steal from the
+ * top of a random victim's deque, i.e. take the oldest and largest ranges,
+ * so load balances itself with few steals.
+ *
+ * Every index of [begin, end) is passed to the callback exactly once, in
+ * disjoint ranges. Output ordering is deterministic as long as the
+ * callback writes results by index: the schedule only decides which thread
+ * computes a row, never where its result goes.
+ *
+ * Like the pool, one run is active at a time; a run started while the
+ * scheduler is busy, or from inside a callback, executes serially on the
+ * calling thread.
+ */
+
+/**
+ * Range callback
+ * @param ctx User context passed to sdk_sched_run
+ * @param begin First index of the range
+ * @param end One past the last index of the range
+ */
+typedef void (*sdk_sched_range_fn)(void *ctx, size_t begin, size_t end);
+
+/**
+ * Scheduler counters (cumulative since start or the last reset)
+ */
+typedef struct {
+    uint64_t runs;          /* sdk_sched_run calls */
+    uint64_t ranges;        /* callback invocations */
+    uint64_t steals;        /* ranges taken from another worker's deque */
+} sdk_sched_stats_t;
+
+/**
+ * Run fn over [begin, end) on all workers and wait for completion
+ * @param begin First index
+ * @param end One past the last index
+ * @param grain Ranges of at most grain indexes aren't split further
+ *              (0 = 1, i.e. every index may go to a different worker)
+ * @param fn Range callback
+ * @param ctx User context
+ */
+void sdk_sched_run(size_t begin, size_t end, size_t grain, sdk_sched_range_fn fn, void *ctx);
+
+/**
+ * Get the number of workers
+ * @return Number of threads a run can use, caller included
+ */
+unsigned sdk_sched_workers(void);
+
+/**
+ * Set the number of workers
+ * @param nworkers New count, caller included (0 = sdk_pool_size())
+ * @return 0 on success, -1 if a run is active or threads can't be created
+ */
+int sdk_sched_set_workers(unsigned nworkers);
+
+/**
+ * Stop and join all worker threads (they restart on next use)
+ */
+void sdk_sched_shutdown(void);
+
+/**
+ * Read the counters
+ */
+void sdk_sched_get_stats(sdk_sched_stats_t *stats);
+
+/**
+ * Zero the counters
+ */
+void sdk_sched_reset_stats(void);
+
+#endif /* __SDK_SCHED_H__ */
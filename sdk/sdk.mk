@@ -5,7 +5,7 @@ SDK_SRC_DIR := sdk/src
 SDK_INC_DIR := sdk/include
 SDK_SRCS := $(wildcard $(SDK_SRC_DIR)/*.c)
 SDK_OBJS := $(patsubst $(SDK_SRC_DIR)/%.c, $(SDK_OUTPUT_DIR)/%.o, $(SDK_SRCS))
-SDK_HEADERS := $(wildcard $(SDK_INC_DIR)/*.h)
+SDK_HEADERS := $(wildcard $(SDK_INC_DIR)/*.h) $(wildcard $(SDK_INC_DIR)/*.hpp)
 
 # SDK library name
 SDK_LIB := $(OUTPUT_DIR)/libsdk.a
@@ -44,4 +44,42 @@ sdk_install: sdk
 	@cp -v $(SDK_LIB) $(SDK_INSTALL_LIB_DIR)/libsdk.a
 	@echo "SDK installed successfully to $(SDK_INSTALL_DIR)"
 	@echo "  Headers: $(SDK_INSTALL_INC_DIR)"
-	@echo "  Library: $(SDK_INSTALL_LIB_DIR)/libsdk.a"
\ No newline at end of file
+	@echo "  Library: $(SDK_INSTALL_LIB_DIR)/libsdk.a"
+
+# ----------------------------------------------------------------------------
+# Release profile: optimized, LTO-built libsdk for production
+#
+# Compiled with -DCALC_INLINE so multi-calc inlines the calc primitives
+# (see calc-inline.h). calc_add/calc_subtract/calc_multiply/calc_divide are
+# still exported. Unit tests keep linking the default (debug) library above,
+# so their -Wl,--wrap=calc_xxx mocking is unchanged.
+# ----------------------------------------------------------------------------
+
+SDK_RELEASE_OUTPUT_DIR := $(OUTPUT_DIR)/sdk_release
+SDK_RELEASE_OBJS := $(patsubst $(SDK_SRC_DIR)/%.c, $(SDK_RELEASE_OUTPUT_DIR)/%.o, $(SDK_SRCS))
+SDK_RELEASE_LIB := $(OUTPUT_DIR)/release/libsdk.a
+
+# Release flags (gcc-ar writes the LTO plugin symbol index)
+SDK_RELEASE_CFLAGS := -Wall -Wextra -O2 -flto -ffat-lto-objects -DCALC_INLINE -I$(SDK_INC_DIR)
+SDK_RELEASE_AR := gcc-ar
+
+# Build release SDK library
+.PHONY: sdk_release
+sdk_release: $(SDK_RELEASE_LIB)
+
+$(SDK_RELEASE_LIB): $(SDK_RELEASE_OBJS)
+	@echo "Building release SDK library: $@"
+	@$(MKDIR) $(dir $@)
+	$(SDK_RELEASE_AR) $(ARFLAGS) $@ $^
+	@echo "Release SDK library built successfully: $@"
+
+# Compile SDK source files (release)
+$(SDK_RELEASE_OUTPUT_DIR)/%.o: $(SDK_SRC_DIR)/%.c
+	@echo "Compiling (release): $<"
+	@$(MKDIR) $(dir $@)
+	$(CC) $(SDK_RELEASE_CFLAGS) -c $< -o $@
+
+# Clean release SDK artifacts
+.PHONY: clean-sdk-release
+clean-sdk-release:
+	$(RM) $(SDK_RELEASE_OUTPUT_DIR) $(SDK_RELEASE_LIB)
@@ -0,0 +1,338 @@
+#include "calc.h"
+#include "calc-isa-internal.h"
+
+typedef void (*calc_kernel_fn)(const int *a, const int *b, int *out, size_t n);
+
+struct calc_kernels {
+    calc_kernel_fn add;
+    calc_kernel_fn subtract;
+    calc_kernel_fn multiply;
+    calc_kernel_fn divide;
+};
+
+/*============================================================================
+ * Scalar kernels (also used for the tail of every vector kernel)
+ *===========================================================================*/
+
+static void scalar_add(const int *a, const int *b, int *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (int)((unsigned)a[i] + (unsigned)b[i]);
+    }
+}
+
+static void scalar_subtract(const int *a, const int *b, int *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (int)((unsigned)a[i] - (unsigned)b[i]);
+    }
+}
+
+static void scalar_multiply(const int *a, const int *b, int *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (int)((unsigned)a[i] * (unsigned)b[i]);
+    }
+}
+
+static void scalar_divide(const int *a, const int *b, int *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (b[i] == 0) {
+            out[i] = 0;
+        } else if (b[i] == -1) {
+            // INT_MIN / -1 wraps to INT_MIN, like the vector kernels
+            out[i] = (int)(0u - (unsigned)a[i]);
+        } else {
+            out[i] = a[i] / b[i];
+        }
+    }
+}
+
+#ifdef CALC_X86
+
+/*============================================================================
+ * SSE2 kernels (4 lanes)
+ *
+ * Integer division has no SIMD instruction, so divide converts to double:
+ * every int32 is exact in a double and the truncated quotient is exact too.
+ *===========================================================================*/
+
+__attribute__((target("sse2")))
+static void sse2_add(const int *a, const int *b, int *out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+        _mm_storeu_si128((__m128i *)(out + i), _mm_add_epi32(va, vb));
+    }
+    scalar_add(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static void sse2_subtract(const int *a, const int *b, int *out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+        _mm_storeu_si128((__m128i *)(out + i), _mm_sub_epi32(va, vb));
+    }
+    scalar_subtract(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static void sse2_multiply(const int *a, const int *b, int *out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+        // SSE2 has no 32-bit mullo: multiply even and odd lanes separately
+        __m128i even = _mm_mul_epu32(va, vb);
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(va, 32), _mm_srli_epi64(vb, 32));
+        __m128i lo = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                        _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+        _mm_storeu_si128((__m128i *)(out + i), lo);
+    }
+    scalar_multiply(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static void sse2_divide(const int *a, const int *b, int *out, size_t n) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+        __m128i is_zero = _mm_cmpeq_epi32(vb, zero);
+        // Divide zero lanes by 1 and clear them afterwards
+        vb = _mm_or_si128(_mm_andnot_si128(is_zero, vb), _mm_and_si128(is_zero, one));
+
+        __m128d qlo = _mm_div_pd(_mm_cvtepi32_pd(va), _mm_cvtepi32_pd(vb));
+        __m128d qhi = _mm_div_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(va, _MM_SHUFFLE(3, 2, 3, 2))),
+                                 _mm_cvtepi32_pd(_mm_shuffle_epi32(vb, _MM_SHUFFLE(3, 2, 3, 2))));
+        __m128i q = _mm_unpacklo_epi64(_mm_cvttpd_epi32(qlo), _mm_cvttpd_epi32(qhi));
+        _mm_storeu_si128((__m128i *)(out + i), _mm_andnot_si128(is_zero, q));
+    }
+    scalar_divide(a + i, b + i, out + i, n - i);
+}
+
+/*============================================================================
+ * AVX2 kernels (8 lanes)
+ *===========================================================================*/
+
+__attribute__((target("avx2")))
+static void avx2_add(const int *a, const int *b, int *out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_add_epi32(va, vb));
+    }
+    scalar_add(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void avx2_subtract(const int *a, const int *b, int *out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_sub_epi32(va, vb));
+    }
+    scalar_subtract(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void avx2_multiply(const int *a, const int *b, int *out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_mullo_epi32(va, vb));
+    }
+    scalar_multiply(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void avx2_divide(const int *a, const int *b, int *out, size_t n) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        __m256i is_zero = _mm256_cmpeq_epi32(vb, zero);
+        vb = _mm256_blendv_epi8(vb, one, is_zero);
+
+        __m256d qlo = _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(va)),
+                                    _mm256_cvtepi32_pd(_mm256_castsi256_si128(vb)));
+        __m256d qhi = _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(va, 1)),
+                                    _mm256_cvtepi32_pd(_mm256_extracti128_si256(vb, 1)));
+        __m256i q = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_cvttpd_epi32(qlo)),
+                                            _mm256_cvttpd_epi32(qhi), 1);
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_andnot_si256(is_zero, q));
+    }
+    scalar_divide(a + i, b + i, out + i, n - i);
+}
+
+/*============================================================================
+ * AVX-512 kernels (16 lanes)
+ *===========================================================================*/
+
+__attribute__((target("avx512f")))
+static void avx512_add(const int *a, const int *b, int *out, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i va = _mm512_loadu_si512((const void *)(a + i));
+        __m512i vb = _mm512_loadu_si512((const void *)(b + i));
+        _mm512_storeu_si512((void *)(out + i), _mm512_add_epi32(va, vb));
+    }
+    scalar_add(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+static void avx512_subtract(const int *a, const int *b, int *out, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i va = _mm512_loadu_si512((const void *)(a + i));
+        __m512i vb = _mm512_loadu_si512((const void *)(b + i));
+        _mm512_storeu_si512((void *)(out + i), _mm512_sub_epi32(va, vb));
+    }
+    scalar_subtract(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+static void avx512_multiply(const int *a, const int *b, int *out, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i va = _mm512_loadu_si512((const void *)(a + i));
+        __m512i vb = _mm512_loadu_si512((const void *)(b + i));
+        _mm512_storeu_si512((void *)(out + i), _mm512_mullo_epi32(va, vb));
+    }
+    scalar_multiply(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+static void avx512_divide(const int *a, const int *b, int *out, size_t n) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i one = _mm512_set1_epi32(1);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i va = _mm512_loadu_si512((const void *)(a + i));
+        __m512i vb = _mm512_loadu_si512((const void *)(b + i));
+        __mmask16 is_zero = _mm512_cmpeq_epi32_mask(vb, zero);
+        vb = _mm512_mask_mov_epi32(vb, is_zero, one);
+
+        __m512d qlo = _mm512_div_pd(_mm512_cvtepi32_pd(_mm512_castsi512_si256(va)),
+                                    _mm512_cvtepi32_pd(_mm512_castsi512_si256(vb)));
+        __m512d qhi = _mm512_div_pd(_mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(va, 1)),
+                                    _mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(vb, 1)));
+        __m512i q = _mm512_inserti64x4(_mm512_castsi256_si512(_mm512_cvttpd_epi32(qlo)),
+                                       _mm512_cvttpd_epi32(qhi), 1);
+        _mm512_storeu_si512((void *)(out + i), _mm512_maskz_mov_epi32((__mmask16)~is_zero, q));
+    }
+    scalar_divide(a + i, b + i, out + i, n - i);
+}
+
+#endif /* CALC_X86 */
+
+/*============================================================================
+ * Runtime dispatch
+ *===========================================================================*/
+
+static const struct calc_kernels calc_kernel_table[] = {
+    [CALC_ISA_SCALAR] = { scalar_add, scalar_subtract, scalar_multiply, scalar_divide },
+#ifdef CALC_X86
+    [CALC_ISA_SSE2]   = { sse2_add, sse2_subtract, sse2_multiply, sse2_divide },
+    [CALC_ISA_AVX2]   = { avx2_add, avx2_subtract, avx2_multiply, avx2_divide },
+    [CALC_ISA_AVX512] = { avx512_add, avx512_subtract, avx512_multiply, avx512_divide },
+#endif
+};
+
+// -1 until the first batch call picks the best supported ISA
+static int calc_active_isa = -1;
+
+int calc_batch_isa_supported(calc_isa_t isa) {
+    switch (isa) {
+    case CALC_ISA_SCALAR:
+        return 1;
+#ifdef CALC_X86
+    case CALC_ISA_SSE2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2") ? 1 : 0;
+    case CALC_ISA_AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? 1 : 0;
+    case CALC_ISA_AVX512:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx512f") ? 1 : 0;
+#endif
+    default:
+        return 0;
+    }
+}
+
+calc_isa_t calc_batch_get_isa(void) {
+    int isa = __atomic_load_n(&calc_active_isa, __ATOMIC_RELAXED);
+    if (isa < 0) {
+        isa = CALC_ISA_AVX512;
+        while (isa > CALC_ISA_SCALAR && !calc_batch_isa_supported((calc_isa_t)isa)) {
+            isa--;
+        }
+        __atomic_store_n(&calc_active_isa, isa, __ATOMIC_RELAXED);
+    }
+    return (calc_isa_t)isa;
+}
+
+int calc_batch_set_isa(calc_isa_t isa) {
+    if (!calc_batch_isa_supported(isa)) {
+        return -1;
+    }
+    __atomic_store_n(&calc_active_isa, (int)isa, __ATOMIC_RELAXED);
+    return 0;
+}
+
+static const struct calc_kernels *calc_active_kernels(void) {
+    return &calc_kernel_table[calc_batch_get_isa()];
+}
+
+void calc_add_n(const int *a, const int *b, int *out, size_t n) {
+    calc_active_kernels()->add(a, b, out, n);
+}
+
+void calc_subtract_n(const int *a, const int *b, int *out, size_t n) {
+    calc_active_kernels()->subtract(a, b, out, n);
+}
+
+void calc_multiply_n(const int *a, const int *b, int *out, size_t n) {
+    calc_active_kernels()->multiply(a, b, out, n);
+}
+
+void calc_divide_n(const int *a, const int *b, int *out, size_t n) {
+    calc_active_kernels()->divide(a, b, out, n);
+}
+
+/*============================================================================
+ * Scalar references (go through the wrappable calc_xxx primitives)
+ *===========================================================================*/
+
+void calc_add_n_ref(const int *a, const int *b, int *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = calc_add(a[i], b[i]);
+    }
+}
+
+void calc_subtract_n_ref(const int *a, const int *b, int *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = calc_subtract(a[i], b[i]);
+    }
+}
+
+void calc_multiply_n_ref(const int *a, const int *b, int *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = calc_multiply(a[i], b[i]);
+    }
+}
+
+void calc_divide_n_ref(const int *a, const int *b, int *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = calc_divide(a[i], b[i]);
+    }
+}
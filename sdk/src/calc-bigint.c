@@ -0,0 +1,559 @@
+#include <stdlib.h>
+#include <string.h>
+#include "calc-bigint.h"
+
+/*
+ * Magnitudes are little-endian arrays of 64-bit limbs; double-limb
+ * intermediates use unsigned __int128. mag_xxx helpers work on fixed-length
+ * arrays (leading zero limbs allowed); calc_bigint_xxx normalize.
+ */
+
+typedef unsigned __int128 u128;
+
+#define BIGINT_MIN_KARATSUBA 4  /* below this the Karatsuba split doesn't shrink */
+#define BIGINT_DECIMAL_CHUNK 10000000000000000000ull   /* 10^19 */
+
+static size_t bigint_karatsuba_limbs = CALC_BIGINT_KARATSUBA_THRESHOLD;
+
+/*============================================================================
+ * Storage
+ *===========================================================================*/
+
+static uint64_t *big_limbs(calc_bigint_t *x) {
+    return x->cap > CALC_BIGINT_INLINE_LIMBS ? x->u.heap : x->u.inline_limbs;
+}
+
+static const uint64_t *big_climbs(const calc_bigint_t *x) {
+    return x->cap > CALC_BIGINT_INLINE_LIMBS ? x->u.heap : x->u.inline_limbs;
+}
+
+// Make room for n limbs, keeping the value
+static int big_reserve(calc_bigint_t *x, size_t n) {
+    if (n <= x->cap) {
+        return 0;
+    }
+    size_t cap = x->cap * 2 > n ? x->cap * 2 : n;
+    uint64_t *heap;
+    if (x->cap > CALC_BIGINT_INLINE_LIMBS) {
+        heap = realloc(x->u.heap, cap * sizeof(uint64_t));
+    } else {
+        heap = malloc(cap * sizeof(uint64_t));
+        if (heap != NULL) {
+            memcpy(heap, x->u.inline_limbs, x->len * sizeof(uint64_t));
+        }
+    }
+    if (heap == NULL) {
+        return -1;
+    }
+    x->u.heap = heap;
+    x->cap = cap;
+    return 0;
+}
+
+static void big_normalize(calc_bigint_t *x) {
+    const uint64_t *d = big_climbs(x);
+    while (x->len > 0 && d[x->len - 1] == 0) {
+        x->len--;
+    }
+    if (x->len == 0) {
+        x->negative = 0;
+    }
+}
+
+// Replace *dst with *src, taking over its storage
+static void big_move(calc_bigint_t *dst, calc_bigint_t *src) {
+    if (dst != src) {
+        calc_bigint_free(dst);
+        *dst = *src;
+        calc_bigint_init(src);
+    }
+}
+
+void calc_bigint_init(calc_bigint_t *x) {
+    x->len = 0;
+    x->cap = CALC_BIGINT_INLINE_LIMBS;
+    x->negative = 0;
+}
+
+void calc_bigint_free(calc_bigint_t *x) {
+    if (x->cap > CALC_BIGINT_INLINE_LIMBS) {
+        free(x->u.heap);
+    }
+    calc_bigint_init(x);
+}
+
+int calc_bigint_copy(calc_bigint_t *dst, const calc_bigint_t *src) {
+    if (dst == src) {
+        return 0;
+    }
+    if (big_reserve(dst, src->len) != 0) {
+        return -1;
+    }
+    memcpy(big_limbs(dst), big_climbs(src), src->len * sizeof(uint64_t));
+    dst->len = src->len;
+    dst->negative = src->negative;
+    return 0;
+}
+
+/*============================================================================
+ * Conversions
+ *===========================================================================*/
+
+void calc_bigint_from_int64(calc_bigint_t *x, int64_t v) {
+    // An initialized value always has room for one limb
+    uint64_t mag = v < 0 ? -(uint64_t)v : (uint64_t)v;
+    big_limbs(x)[0] = mag;
+    x->len = mag != 0;
+    x->negative = v < 0;
+}
+
+void calc_bigint_from_int(calc_bigint_t *x, int v) {
+    calc_bigint_from_int64(x, v);
+}
+
+int calc_bigint_to_int64(const calc_bigint_t *x, int64_t *out) {
+    uint64_t mag = x->len > 0 ? big_climbs(x)[0] : 0;
+    *out = (int64_t)(x->negative ? -mag : mag);
+    if (x->len > 1) {
+        return -1;
+    }
+    return mag <= (x->negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX) ? 0 : -1;
+}
+
+int calc_bigint_to_int(const calc_bigint_t *x, int *out) {
+    int64_t v;
+    int fits = calc_bigint_to_int64(x, &v) == 0 && v >= INT32_MIN && v <= INT32_MAX;
+    *out = (int)(uint32_t)(uint64_t)v;
+    return fits ? 0 : -1;
+}
+
+/*============================================================================
+ * Magnitude helpers
+ *===========================================================================*/
+
+static int mag_cmp(const uint64_t *a, size_t an, const uint64_t *b, size_t bn) {
+    if (an != bn) {
+        return an < bn ? -1 : 1;
+    }
+    for (size_t i = an; i-- > 0;) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// r[0 .. an) = a + b for an >= bn; returns the carry out (r may alias a or b)
+static uint64_t mag_add(uint64_t *r, const uint64_t *a, size_t an, const uint64_t *b, size_t bn) {
+    uint64_t carry = 0;
+    size_t i = 0;
+    for (; i < bn; i++) {
+        u128 t = (u128)a[i] + b[i] + carry;
+        r[i] = (uint64_t)t;
+        carry = (uint64_t)(t >> 64);
+    }
+    for (; i < an; i++) {
+        uint64_t t = a[i] + carry;
+        carry = t < carry;
+        r[i] = t;
+    }
+    return carry;
+}
+
+// r[0 .. an) = a - b for a >= b (r may alias a or b)
+static void mag_sub(uint64_t *r, const uint64_t *a, size_t an, const uint64_t *b, size_t bn) {
+    uint64_t borrow = 0;
+    size_t i = 0;
+    for (; i < bn; i++) {
+        uint64_t x = a[i], y = b[i];
+        uint64_t d = x - y;
+        uint64_t b1 = x < y;
+        r[i] = d - borrow;
+        borrow = b1 | (d < borrow);
+    }
+    for (; i < an; i++) {
+        uint64_t x = a[i];
+        r[i] = x - borrow;
+        borrow = x < borrow;
+    }
+}
+
+// r[0 .. an + bn) = a * b, r must not alias a or b
+static void mag_mul_school(uint64_t *r, const uint64_t *a, size_t an, const uint64_t *b, size_t bn) {
+    memset(r, 0, (an + bn) * sizeof(uint64_t));
+    for (size_t j = 0; j < bn; j++) {
+        uint64_t carry = 0;
+        uint64_t bj = b[j];
+        for (size_t i = 0; i < an; i++) {
+            u128 t = (u128)a[i] * bj + r[i + j] + carry;
+            r[i + j] = (uint64_t)t;
+            carry = (uint64_t)(t >> 64);
+        }
+        r[an + j] = carry;
+    }
+}
+
+static int mag_mul(uint64_t *r, const uint64_t *a, size_t an, const uint64_t *b, size_t bn);
+
+/*
+ * Karatsuba for bn <= an < 2 * bn, split at m = ceil(an / 2):
+ *   a * b = z2 * B^2m + ((a0 + a1)(b0 + b1) - z0 - z2) * B^m + z0
+ * z0 = a0 * b0 and z2 = a1 * b1 go straight into the low and high halves
+ * of r; the middle product goes through scratch and is added at B^m.
+ */
+static int mag_mul_karatsuba(uint64_t *r, const uint64_t *a, size_t an, const uint64_t *b,
+                             size_t bn) {
+    size_t m = (an + 1) / 2;
+    size_t a1n = an - m, b1n = bn - m;
+    uint64_t *scratch = malloc((4 * m + 4) * sizeof(uint64_t));
+    if (scratch == NULL) {
+        return -1;
+    }
+    uint64_t *sa = scratch;             /* m + 1 limbs */
+    uint64_t *sb = sa + m + 1;          /* m + 1 limbs */
+    uint64_t *z1 = sb + m + 1;          /* 2m + 2 limbs */
+
+    if (mag_mul(r, a, m, b, m) != 0) {
+        free(scratch);
+        return -1;
+    }
+    if (b1n > 0) {
+        if (mag_mul(r + 2 * m, a + m, a1n, b + m, b1n) != 0) {
+            free(scratch);
+            return -1;
+        }
+    } else {
+        memset(r + 2 * m, 0, (an + bn - 2 * m) * sizeof(uint64_t));
+    }
+
+    sa[m] = mag_add(sa, a, m, a + m, a1n);
+    sb[m] = mag_add(sb, b, m, b + m, b1n);
+    if (mag_mul(z1, sa, m + 1, sb, m + 1) != 0) {
+        free(scratch);
+        return -1;
+    }
+    mag_sub(z1, z1, 2 * m + 2, r, 2 * m);
+    mag_sub(z1, z1, 2 * m + 2, r + 2 * m, an + bn - 2 * m);
+
+    // The middle term fits in what's left of r above B^m
+    size_t top = an + bn - m;
+    size_t z1n = 2 * m + 2 < top ? 2 * m + 2 : top;
+    mag_add(r + m, r + m, top, z1, z1n);
+    free(scratch);
+    return 0;
+}
+
+// r[0 .. an + bn) = a * b, r must not alias a or b
+static int mag_mul(uint64_t *r, const uint64_t *a, size_t an, const uint64_t *b, size_t bn) {
+    if (an < bn) {
+        const uint64_t *t = a;
+        a = b;
+        b = t;
+        size_t tn = an;
+        an = bn;
+        bn = tn;
+    }
+    if (bn < __atomic_load_n(&bigint_karatsuba_limbs, __ATOMIC_RELAXED)) {
+        mag_mul_school(r, a, an, b, bn);
+        return 0;
+    }
+    if (an < 2 * bn) {
+        return mag_mul_karatsuba(r, a, an, b, bn);
+    }
+
+    // Very unbalanced: multiply b by bn-limb slices of a and accumulate
+    uint64_t *piece = malloc(2 * bn * sizeof(uint64_t));
+    if (piece == NULL) {
+        return -1;
+    }
+    memset(r, 0, (an + bn) * sizeof(uint64_t));
+    for (size_t off = 0; off < an; off += bn) {
+        size_t len = an - off < bn ? an - off : bn;
+        if (mag_mul(piece, a + off, len, b, bn) != 0) {
+            free(piece);
+            return -1;
+        }
+        mag_add(r + off, r + off, an + bn - off, piece, len + bn);
+    }
+    free(piece);
+    return 0;
+}
+
+// q[0 .. an) = a / d, returns a % d (q may alias a)
+static uint64_t mag_divmod_1(uint64_t *q, const uint64_t *a, size_t an, uint64_t d) {
+    u128 rem = 0;
+    for (size_t i = an; i-- > 0;) {
+        u128 cur = (rem << 64) | a[i];
+        q[i] = (uint64_t)(cur / d);
+        rem = cur % d;
+    }
+    return (uint64_t)rem;
+}
+
+/*
+ * Knuth algorithm D (TAOCP 4.3.1) for an >= bn >= 2, b normalized so its
+ * top limb has the high bit set. q gets an - bn + 1 limbs, rem bn limbs.
+ */
+static int mag_divmod(uint64_t *q, uint64_t *rem, const uint64_t *a, size_t an, const uint64_t *b,
+                      size_t bn) {
+    uint64_t *un = malloc((an + 1 + bn) * sizeof(uint64_t));
+    if (un == NULL) {
+        return -1;
+    }
+    uint64_t *vn = un + an + 1;
+    int s = __builtin_clzll(b[bn - 1]);
+    for (size_t i = bn; i-- > 0;) {
+        vn[i] = (b[i] << s) | (s != 0 && i > 0 ? b[i - 1] >> (64 - s) : 0);
+    }
+    un[an] = s != 0 ? a[an - 1] >> (64 - s) : 0;
+    for (size_t i = an; i-- > 0;) {
+        un[i] = (a[i] << s) | (s != 0 && i > 0 ? a[i - 1] >> (64 - s) : 0);
+    }
+
+    for (size_t j = an - bn + 1; j-- > 0;) {
+        // Estimate the quotient limb from the top two limbs, then refine with the third
+        u128 num = ((u128)un[j + bn] << 64) | un[j + bn - 1];
+        u128 qhat = num / vn[bn - 1];
+        u128 rhat = num % vn[bn - 1];
+        while ((qhat >> 64) != 0 || qhat * vn[bn - 2] > ((rhat << 64) | un[j + bn - 2])) {
+            qhat--;
+            rhat += vn[bn - 1];
+            if ((rhat >> 64) != 0) {
+                break;
+            }
+        }
+
+        // un[j .. j + bn] -= qhat * vn
+        uint64_t borrow = 0, carry = 0;
+        for (size_t i = 0; i < bn; i++) {
+            u128 p = qhat * vn[i] + carry;
+            carry = (uint64_t)(p >> 64);
+            uint64_t x = un[i + j], y = (uint64_t)p;
+            uint64_t d = x - y;
+            uint64_t b1 = x < y;
+            un[i + j] = d - borrow;
+            borrow = b1 | (d < borrow);
+        }
+        uint64_t x = un[j + bn];
+        uint64_t d = x - carry;
+        int negative = x < carry || d < borrow;
+        un[j + bn] = d - borrow;
+
+        q[j] = (uint64_t)qhat;
+        if (negative) {
+            // qhat was one too large (rare): add vn back
+            q[j]--;
+            un[j + bn] += mag_add(un + j, un + j, bn, vn, bn);
+        }
+    }
+
+    for (size_t i = 0; i < bn; i++) {
+        rem[i] = (un[i] >> s) | (s != 0 ? un[i + 1] << (64 - s) : 0);
+    }
+    free(un);
+    return 0;
+}
+
+/*============================================================================
+ * Arithmetic
+ *===========================================================================*/
+
+int calc_bigint_cmp(const calc_bigint_t *a, const calc_bigint_t *b) {
+    if (a->negative != b->negative) {
+        return a->negative ? -1 : 1;
+    }
+    int c = mag_cmp(big_climbs(a), a->len, big_climbs(b), b->len);
+    return a->negative ? -c : c;
+}
+
+int calc_bigint_sign(const calc_bigint_t *x) {
+    return x->len == 0 ? 0 : x->negative ? -1 : 1;
+}
+
+// r = a + (b_negative ? -|b| : |b|)
+static int big_add_signed(calc_bigint_t *r, const calc_bigint_t *a, const calc_bigint_t *b,
+                          int b_negative) {
+    // x is the operand with the larger magnitude, which decides the sign
+    const calc_bigint_t *x = a, *y = b;
+    int x_negative = a->negative;
+    int same = a->negative == b_negative;
+    if (mag_cmp(big_climbs(a), a->len, big_climbs(b), b->len) < 0) {
+        x = b;
+        y = a;
+        x_negative = b_negative;
+    }
+
+    // In place is fine: limb i of the result depends on limb i of the inputs only
+    size_t n = x->len + 1;
+    calc_bigint_t t;
+    calc_bigint_init(&t);
+    calc_bigint_t *dst = r;
+    if (r->cap < n && (r == a || r == b)) {
+        dst = &t;   /* growing would move the operand's limbs */
+    }
+    if (big_reserve(dst, n) != 0) {
+        return -1;
+    }
+    uint64_t *d = big_limbs(dst);
+    if (same) {
+        d[x->len] = mag_add(d, big_climbs(x), x->len, big_climbs(y), y->len);
+    } else {
+        mag_sub(d, big_climbs(x), x->len, big_climbs(y), y->len);
+        d[x->len] = 0;
+    }
+    dst->len = n;
+    dst->negative = x_negative;
+    big_normalize(dst);
+    big_move(r, dst);
+    return 0;
+}
+
+int calc_bigint_add(calc_bigint_t *r, const calc_bigint_t *a, const calc_bigint_t *b) {
+    return big_add_signed(r, a, b, b->negative);
+}
+
+int calc_bigint_subtract(calc_bigint_t *r, const calc_bigint_t *a, const calc_bigint_t *b) {
+    return big_add_signed(r, a, b, b->len != 0 && !b->negative);
+}
+
+int calc_bigint_multiply(calc_bigint_t *r, const calc_bigint_t *a, const calc_bigint_t *b) {
+    if (a->len == 0 || b->len == 0) {
+        calc_bigint_from_int(r, 0);
+        return 0;
+    }
+    calc_bigint_t t;
+    calc_bigint_init(&t);
+    calc_bigint_t *dst = (r == a || r == b) ? &t : r;
+    size_t n = a->len + b->len;
+    if (big_reserve(dst, n) != 0 ||
+        mag_mul(big_limbs(dst), big_climbs(a), a->len, big_climbs(b), b->len) != 0) {
+        calc_bigint_free(&t);
+        return -1;
+    }
+    dst->len = n;
+    dst->negative = a->negative != b->negative;
+    big_normalize(dst);
+    big_move(r, dst);
+    return 0;
+}
+
+int calc_bigint_divide(calc_bigint_t *q, calc_bigint_t *rem, const calc_bigint_t *a,
+                       const calc_bigint_t *b) {
+    if (b->len == 0) {
+        if (q != NULL) {
+            calc_bigint_from_int(q, 0);
+        }
+        if (rem != NULL) {
+            calc_bigint_from_int(rem, 0);
+        }
+        return 0;
+    }
+
+    calc_bigint_t tq, tr;
+    calc_bigint_init(&tq);
+    calc_bigint_init(&tr);
+    if (mag_cmp(big_climbs(a), a->len, big_climbs(b), b->len) < 0) {
+        // |a| < |b|: q = 0, rem = a
+        if (calc_bigint_copy(&tr, a) != 0) {
+            return -1;
+        }
+    } else if (big_reserve(&tq, a->len - b->len + 1) != 0 || big_reserve(&tr, b->len) != 0) {
+        calc_bigint_free(&tq);
+        calc_bigint_free(&tr);
+        return -1;
+    } else if (b->len == 1) {
+        big_limbs(&tr)[0] = mag_divmod_1(big_limbs(&tq), big_climbs(a), a->len, big_climbs(b)[0]);
+        tq.len = a->len;
+        tr.len = 1;
+    } else {
+        if (mag_divmod(big_limbs(&tq), big_limbs(&tr), big_climbs(a), a->len, big_climbs(b),
+                       b->len) != 0) {
+            calc_bigint_free(&tq);
+            calc_bigint_free(&tr);
+            return -1;
+        }
+        tq.len = a->len - b->len + 1;
+        tr.len = b->len;
+    }
+    tq.negative = a->negative != b->negative;
+    tr.negative = a->negative;
+    big_normalize(&tq);
+    big_normalize(&tr);
+
+    // Operands are read in full before q / rem are touched, so they may alias
+    if (q != NULL) {
+        big_move(q, &tq);
+    }
+    if (rem != NULL) {
+        big_move(rem, &tr);
+    }
+    calc_bigint_free(&tq);
+    calc_bigint_free(&tr);
+    return 0;
+}
+
+/*============================================================================
+ * Decimal output
+ *===========================================================================*/
+
+int calc_bigint_to_string(const calc_bigint_t *x, char *buf, size_t size) {
+    // 10^19 < 2^64: at most len * 64 / log2(10^19) + 1 chunks of 19 digits
+    size_t nchunks = x->len * 64 / 63 + 1;
+    size_t digits_cap = nchunks * 19 + 2;
+    uint64_t stack_limbs[CALC_BIGINT_INLINE_LIMBS];
+    char stack_digits[CALC_BIGINT_INLINE_LIMBS * 20 + 3];
+    uint64_t *t = stack_limbs;
+    char *digits = stack_digits;
+    if (x->len > CALC_BIGINT_INLINE_LIMBS) {
+        t = malloc(x->len * sizeof(uint64_t));
+        digits = malloc(digits_cap);
+        if (t == NULL || digits == NULL) {
+            free(t);
+            free(digits);
+            return -1;
+        }
+    }
+    memcpy(t, big_climbs(x), x->len * sizeof(uint64_t));
+
+    // Digits come out least significant first
+    size_t nd = 0, n = x->len;
+    do {
+        uint64_t chunk = mag_divmod_1(t, t, n, BIGINT_DECIMAL_CHUNK);
+        while (n > 0 && t[n - 1] == 0) {
+            n--;
+        }
+        for (int i = 0; i < 19 && (n > 0 || chunk != 0 || i == 0); i++) {
+            digits[nd++] = (char)('0' + chunk % 10);
+            chunk /= 10;
+        }
+    } while (n > 0);
+    if (x->negative) {
+        digits[nd++] = '-';
+    }
+
+    for (size_t i = 0; i < nd && i + 1 < size; i++) {
+        buf[i] = digits[nd - 1 - i];
+    }
+    if (size > 0) {
+        buf[nd < size ? nd : size - 1] = '\0';
+    }
+    if (t != stack_limbs) {
+        free(t);
+        free(digits);
+    }
+    return (int)nd;
+}
+
+size_t calc_bigint_karatsuba_threshold(void) {
+    return __atomic_load_n(&bigint_karatsuba_limbs, __ATOMIC_RELAXED);
+}
+
+void calc_bigint_set_karatsuba_threshold(size_t limbs) {
+    if (limbs == 0) {
+        limbs = CALC_BIGINT_KARATSUBA_THRESHOLD;
+    }
+    if (limbs < BIGINT_MIN_KARATSUBA) {
+        limbs = BIGINT_MIN_KARATSUBA;
+    }
+    __atomic_store_n(&bigint_karatsuba_limbs, limbs, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,229 @@
+#include <limits.h>
+#include "calc.h"
+#include "calc-isa-internal.h"
+
+/*============================================================================
+ * Overflow-checked arithmetic
+ *===========================================================================*/
+
+int calc_add_checked(int a, int b, int *result) {
+    return __builtin_add_overflow(a, b, result) ? -1 : 0;
+}
+
+int calc_subtract_checked(int a, int b, int *result) {
+    return __builtin_sub_overflow(a, b, result) ? -1 : 0;
+}
+
+int calc_multiply_checked(int a, int b, int *result) {
+    return __builtin_mul_overflow(a, b, result) ? -1 : 0;
+}
+
+int calc_divide_checked(int a, int b, int *result) {
+    if (b == 0) {
+        *result = 0;
+        return 0;
+    }
+    if (a == INT_MIN && b == -1) {
+        *result = INT_MIN;
+        return -1;
+    }
+    *result = a / b;
+    return 0;
+}
+
+/*============================================================================
+ * Saturating lanes
+ *
+ * The clamp value only depends on operand signs: (x >> 31) ^ INT_MAX is
+ * INT_MIN for negative x and INT_MAX otherwise. The final select compiles
+ * to a cmov, so the lanes stay branch-free.
+ *===========================================================================*/
+
+static inline int sat_add_lane(int a, int b, unsigned *ovf) {
+    int r;
+    *ovf = __builtin_add_overflow(a, b, &r);
+    return *ovf ? ((a >> 31) ^ INT_MAX) : r;
+}
+
+static inline int sat_subtract_lane(int a, int b, unsigned *ovf) {
+    int r;
+    *ovf = __builtin_sub_overflow(a, b, &r);
+    return *ovf ? ((a >> 31) ^ INT_MAX) : r;
+}
+
+static inline int sat_multiply_lane(int a, int b, unsigned *ovf) {
+    int r;
+    *ovf = __builtin_mul_overflow(a, b, &r);
+    return *ovf ? (((a ^ b) >> 31) ^ INT_MAX) : r;
+}
+
+static inline int sat_divide_lane(int a, int b, unsigned *ovf) {
+    *ovf = (a == INT_MIN) & (b == -1);
+    // Swap in a safe divisor for the 0 and overflow lanes, then fix them up
+    int safe_b = (b == 0 || *ovf) ? 1 : b;
+    int q = a / safe_b;
+    q = *ovf ? INT_MAX : q;
+    return b == 0 ? 0 : q;
+}
+
+int calc_add_sat(int a, int b) {
+    unsigned ovf;
+    return sat_add_lane(a, b, &ovf);
+}
+
+int calc_subtract_sat(int a, int b) {
+    unsigned ovf;
+    return sat_subtract_lane(a, b, &ovf);
+}
+
+int calc_multiply_sat(int a, int b) {
+    unsigned ovf;
+    return sat_multiply_lane(a, b, &ovf);
+}
+
+int calc_divide_sat(int a, int b) {
+    unsigned ovf;
+    return sat_divide_lane(a, b, &ovf);
+}
+
+/*============================================================================
+ * Saturating batch kernels
+ *
+ * Both the scalar and the AVX2 kernels emit one mask byte per 8 lanes, so
+ * the AVX2 loop can store _mm256_movemask_ps directly.
+ *===========================================================================*/
+
+#define DEFINE_SCALAR_SAT_KERNEL(name, lane)                                   \
+    static size_t name(const int *a, const int *b, int *out,                   \
+                       uint8_t *overflow_mask, size_t n) {                     \
+        size_t count = 0;                                                      \
+        unsigned bits = 0;                                                     \
+        for (size_t i = 0; i < n; i++) {                                       \
+            unsigned ovf;                                                      \
+            out[i] = lane(a[i], b[i], &ovf);                                   \
+            count += ovf;                                                      \
+            bits |= ovf << (i % 8);                                            \
+            if (i % 8 == 7 || i == n - 1) {                                    \
+                if (overflow_mask != NULL) {                                   \
+                    overflow_mask[i / 8] = (uint8_t)bits;                      \
+                }                                                              \
+                bits = 0;                                                      \
+            }                                                                  \
+        }                                                                      \
+        return count;                                                          \
+    }
+
+DEFINE_SCALAR_SAT_KERNEL(scalar_add_sat, sat_add_lane)
+DEFINE_SCALAR_SAT_KERNEL(scalar_subtract_sat, sat_subtract_lane)
+DEFINE_SCALAR_SAT_KERNEL(scalar_multiply_sat, sat_multiply_lane)
+DEFINE_SCALAR_SAT_KERNEL(scalar_divide_sat, sat_divide_lane)
+
+#ifdef CALC_X86
+
+// Store one mask byte for 8 lanes whose overflow flag is the lane sign bit
+__attribute__((target("avx2")))
+static inline size_t avx2_store_mask(__m256i ovf, uint8_t *overflow_mask, size_t i) {
+    unsigned bits = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(ovf));
+    if (overflow_mask != NULL) {
+        overflow_mask[i / 8] = (uint8_t)bits;
+    }
+    return (size_t)__builtin_popcount(bits);
+}
+
+__attribute__((target("avx2")))
+static size_t avx2_add_sat(const int *a, const int *b, int *out, uint8_t *overflow_mask, size_t n) {
+    const __m256i max = _mm256_set1_epi32(INT_MAX);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        __m256i r = _mm256_add_epi32(va, vb);
+        // Overflow iff both operands differ in sign from the result
+        __m256i ovf = _mm256_srai_epi32(_mm256_and_si256(_mm256_xor_si256(va, r),
+                                                         _mm256_xor_si256(vb, r)), 31);
+        __m256i sat = _mm256_xor_si256(_mm256_srai_epi32(va, 31), max);
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_blendv_epi8(r, sat, ovf));
+        count += avx2_store_mask(ovf, overflow_mask, i);
+    }
+    return count + scalar_add_sat(a + i, b + i, out + i,
+                                  overflow_mask ? overflow_mask + i / 8 : NULL, n - i);
+}
+
+__attribute__((target("avx2")))
+static size_t avx2_subtract_sat(const int *a, const int *b, int *out, uint8_t *overflow_mask, size_t n) {
+    const __m256i max = _mm256_set1_epi32(INT_MAX);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        __m256i r = _mm256_sub_epi32(va, vb);
+        // Overflow iff the operands differ in sign and the result flips a's sign
+        __m256i ovf = _mm256_srai_epi32(_mm256_and_si256(_mm256_xor_si256(va, vb),
+                                                         _mm256_xor_si256(va, r)), 31);
+        __m256i sat = _mm256_xor_si256(_mm256_srai_epi32(va, 31), max);
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_blendv_epi8(r, sat, ovf));
+        count += avx2_store_mask(ovf, overflow_mask, i);
+    }
+    return count + scalar_subtract_sat(a + i, b + i, out + i,
+                                       overflow_mask ? overflow_mask + i / 8 : NULL, n - i);
+}
+
+__attribute__((target("avx2")))
+static size_t avx2_multiply_sat(const int *a, const int *b, int *out, uint8_t *overflow_mask, size_t n) {
+    const __m256i max = _mm256_set1_epi32(INT_MAX);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        // Full 64-bit products of the even and odd lanes
+        __m256i even = _mm256_mul_epi32(va, vb);
+        __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(va, 32), _mm256_srli_epi64(vb, 32));
+        __m256i lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+        __m256i hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+        // Overflow iff the high half is not the sign extension of the low half
+        __m256i ovf = _mm256_xor_si256(_mm256_cmpeq_epi32(hi, _mm256_srai_epi32(lo, 31)),
+                                       _mm256_set1_epi32(-1));
+        __m256i sat = _mm256_xor_si256(_mm256_srai_epi32(_mm256_xor_si256(va, vb), 31), max);
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_blendv_epi8(lo, sat, ovf));
+        count += avx2_store_mask(ovf, overflow_mask, i);
+    }
+    return count + scalar_multiply_sat(a + i, b + i, out + i,
+                                       overflow_mask ? overflow_mask + i / 8 : NULL, n - i);
+}
+
+#endif /* CALC_X86 */
+
+size_t calc_add_sat_n(const int *a, const int *b, int *out, uint8_t *overflow_mask, size_t n) {
+#ifdef CALC_X86
+    if (calc_batch_use_avx2()) {
+        return avx2_add_sat(a, b, out, overflow_mask, n);
+    }
+#endif
+    return scalar_add_sat(a, b, out, overflow_mask, n);
+}
+
+size_t calc_subtract_sat_n(const int *a, const int *b, int *out, uint8_t *overflow_mask, size_t n) {
+#ifdef CALC_X86
+    if (calc_batch_use_avx2()) {
+        return avx2_subtract_sat(a, b, out, overflow_mask, n);
+    }
+#endif
+    return scalar_subtract_sat(a, b, out, overflow_mask, n);
+}
+
+size_t calc_multiply_sat_n(const int *a, const int *b, int *out, uint8_t *overflow_mask, size_t n) {
+#ifdef CALC_X86
+    if (calc_batch_use_avx2()) {
+        return avx2_multiply_sat(a, b, out, overflow_mask, n);
+    }
+#endif
+    return scalar_multiply_sat(a, b, out, overflow_mask, n);
+}
+
+size_t calc_divide_sat_n(const int *a, const int *b, int *out, uint8_t *overflow_mask, size_t n) {
+    // Only INT_MIN / -1 can saturate, the scalar lane is already branch-free
+    return scalar_divide_sat(a, b, out, overflow_mask, n);
+}
@@ -0,0 +1,347 @@
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "calc.h"
+#include "calc-column.h"
+#include "sdk-pool.h"
+
+#define CALC_COLUMN_HUGEPAGE_SIZE ((size_t)2 << 20)
+
+// Rows per task for calc_column_sum (a multiple of 8, so bitmap bytes don't straddle tasks)
+#define CALC_COLUMN_CHUNK (64 * 1024)
+#define CALC_COLUMN_STACK_CHUNKS 64
+
+static size_t round_up(size_t x, size_t align) {
+    return (x + align - 1) / align * align;
+}
+
+static size_t validity_bytes(size_t rows) {
+    return (rows + 7) / 8;
+}
+
+/*============================================================================
+ * Storage
+ *===========================================================================*/
+
+static void *column_map_hugepages(size_t bytes, size_t *map_size, void **map_base) {
+    size_t size = round_up(bytes, CALC_COLUMN_HUGEPAGE_SIZE);
+    void *p;
+
+#ifdef MAP_HUGETLB
+    // Explicit hugepages only work when the admin reserved some
+    p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) {
+        *map_size = size;
+        *map_base = p;
+        return p;
+    }
+#endif
+
+    // Otherwise a 2 MiB aligned region the kernel can back with transparent hugepages
+    p = mmap(NULL, size + CALC_COLUMN_HUGEPAGE_SIZE, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        return NULL;
+    }
+    char *aligned = (char *)round_up((size_t)p, CALC_COLUMN_HUGEPAGE_SIZE);
+    size_t head = (size_t)(aligned - (char *)p);
+    if (head > 0) {
+        munmap(p, head);
+    }
+    if (CALC_COLUMN_HUGEPAGE_SIZE - head > 0) {
+        munmap(aligned + size, CALC_COLUMN_HUGEPAGE_SIZE - head);
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+    *map_size = size;
+    *map_base = aligned;
+    return aligned;
+}
+
+int calc_column_init(calc_column_t *col, size_t len, unsigned flags) {
+    memset(col, 0, sizeof(*col));
+    // Pad to a whole cache line so kernels never share the last line
+    size_t bytes = round_up(len * sizeof(int), CALC_COLUMN_ALIGN);
+    if (bytes == 0) {
+        bytes = CALC_COLUMN_ALIGN;
+    }
+
+    if (flags & CALC_COLUMN_HUGEPAGES) {
+        col->data = column_map_hugepages(bytes, &col->map_size, &col->map_base);
+        if (col->data != NULL) {
+            col->flags = CALC_COLUMN_HUGEPAGES | CALC_COLUMN_MAPPED;
+        }
+    }
+    if (col->data == NULL) {
+        void *p;
+        if (posix_memalign(&p, CALC_COLUMN_ALIGN, bytes) != 0) {
+            return -1;
+        }
+        col->data = p;
+    }
+
+    col->flags |= CALC_COLUMN_OWNED;
+    col->len = len;
+    col->capacity = bytes / sizeof(int);
+    return 0;
+}
+
+void calc_column_view(calc_column_t *col, int *data, size_t len, uint8_t *validity) {
+    memset(col, 0, sizeof(*col));
+    col->data = data;
+    col->validity = validity;
+    col->len = len;
+    col->capacity = len;
+}
+
+int calc_column_map_file(calc_column_t *col, const char *path, size_t offset, size_t len) {
+    memset(col, 0, sizeof(*col));
+    if (offset % sizeof(int) != 0) {
+        return -1;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < offset) {
+        close(fd);
+        return -1;
+    }
+    size_t avail = ((size_t)st.st_size - offset) / sizeof(int);
+    if (len == 0) {
+        len = avail;
+    }
+    if (len == 0 || len > avail) {
+        close(fd);
+        return -1;
+    }
+
+    // mmap offsets must be page aligned
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t map_offset = offset / page * page;
+    size_t map_size = offset - map_offset + len * sizeof(int);
+    void *p = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, (off_t)map_offset);
+    close(fd);
+    if (p == MAP_FAILED) {
+        return -1;
+    }
+
+    col->data = (int *)((char *)p + (offset - map_offset));
+    col->len = len;
+    col->capacity = len;
+    col->map_base = p;
+    col->map_size = map_size;
+    col->flags = CALC_COLUMN_MAPPED | CALC_COLUMN_READONLY;
+    return 0;
+}
+
+void calc_column_free(calc_column_t *col) {
+    if (col->flags & CALC_COLUMN_MAPPED) {
+        munmap(col->map_base, col->map_size);
+    } else if (col->flags & CALC_COLUMN_OWNED) {
+        free(col->data);
+    }
+    if (col->flags & CALC_COLUMN_OWNED_VALIDITY) {
+        free(col->validity);
+    }
+    memset(col, 0, sizeof(*col));
+}
+
+/*============================================================================
+ * Validity
+ *===========================================================================*/
+
+int calc_column_add_validity(calc_column_t *col) {
+    if (col->validity != NULL) {
+        return 0;
+    }
+    if (!(col->flags & CALC_COLUMN_OWNED)) {
+        return -1;
+    }
+    size_t bytes = validity_bytes(col->capacity);
+    col->validity = malloc(bytes > 0 ? bytes : 1);
+    if (col->validity == NULL) {
+        return -1;
+    }
+    memset(col->validity, 0xFF, bytes);
+    col->flags |= CALC_COLUMN_OWNED_VALIDITY;
+    return 0;
+}
+
+int calc_column_set_valid(calc_column_t *col, size_t row, int valid) {
+    if (col->validity == NULL) {
+        if (valid) {
+            return 0;
+        }
+        if (calc_column_add_validity(col) != 0) {
+            return -1;
+        }
+    }
+    uint8_t bit = (uint8_t)(1u << (row % 8));
+    col->validity[row / 8] = valid ? (col->validity[row / 8] | bit)
+                                   : (col->validity[row / 8] & (uint8_t)~bit);
+    return 0;
+}
+
+int calc_column_is_valid(const calc_column_t *col, size_t row) {
+    return col->validity == NULL || ((col->validity[row / 8] >> (row % 8)) & 1);
+}
+
+size_t calc_column_null_count(const calc_column_t *col) {
+    if (col->validity == NULL) {
+        return 0;
+    }
+    size_t valid = 0;
+    size_t full = col->len / 8;
+    for (size_t i = 0; i < full; i++) {
+        valid += (size_t)__builtin_popcount(col->validity[i]);
+    }
+    if (col->len % 8 != 0) {
+        unsigned tail = col->validity[full] & ((1u << (col->len % 8)) - 1);
+        valid += (size_t)__builtin_popcount(tail);
+    }
+    return col->len - valid;
+}
+
+/*============================================================================
+ * Batch arithmetic
+ *===========================================================================*/
+
+typedef void (*column_kernel_fn)(const int *a, const int *b, int *out, size_t n);
+
+static int column_binary(const calc_column_t *a, const calc_column_t *b, calc_column_t *out,
+                         column_kernel_fn kernel) {
+    if (a->len != b->len || (out->flags & CALC_COLUMN_READONLY) || out->capacity < a->len) {
+        return -1;
+    }
+    // Read the input bitmaps before out (which may alias a or b) gets one
+    const uint8_t *va = a->validity;
+    const uint8_t *vb = b->validity;
+    if ((va != NULL || vb != NULL) && calc_column_add_validity(out) != 0) {
+        return -1;
+    }
+
+    size_t len = a->len;
+    kernel(a->data, b->data, out->data, len);
+    out->len = len;
+
+    if (out->validity != NULL) {
+        size_t bytes = validity_bytes(len);
+        for (size_t i = 0; i < bytes; i++) {
+            out->validity[i] = (va != NULL ? va[i] : 0xFF) & (vb != NULL ? vb[i] : 0xFF);
+        }
+        if (len % 8 != 0) {
+            out->validity[bytes - 1] &= (uint8_t)((1u << (len % 8)) - 1);
+        }
+    }
+    return 0;
+}
+
+int calc_column_add(const calc_column_t *a, const calc_column_t *b, calc_column_t *out) {
+    return column_binary(a, b, out, calc_add_n);
+}
+
+int calc_column_subtract(const calc_column_t *a, const calc_column_t *b, calc_column_t *out) {
+    return column_binary(a, b, out, calc_subtract_n);
+}
+
+int calc_column_multiply(const calc_column_t *a, const calc_column_t *b, calc_column_t *out) {
+    return column_binary(a, b, out, calc_multiply_n);
+}
+
+int calc_column_divide(const calc_column_t *a, const calc_column_t *b, calc_column_t *out) {
+    return column_binary(a, b, out, calc_divide_n);
+}
+
+/*============================================================================
+ * Masked sum
+ *===========================================================================*/
+
+// Sum rows [begin, end) that are valid; runs of all-valid bytes use the SIMD reducer
+static int64_t masked_sum(const calc_column_t *col, size_t begin, size_t end, size_t *count) {
+    int64_t sum = 0;
+    size_t valid = 0;
+    size_t run = begin;  // start of the pending all-valid run
+
+    for (size_t row = begin; row < end; row += 8) {
+        uint8_t bits = col->validity[row / 8];
+        size_t rows = end - row < 8 ? end - row : 8;
+        if (bits == 0xFF && rows == 8) {
+            continue;
+        }
+        sum += calc_sum_reduce(col->data + run, row - run, 1);
+        valid += row - run;
+        for (size_t i = 0; i < rows; i++) {
+            if ((bits >> i) & 1) {
+                sum += col->data[row + i];
+                valid++;
+            }
+        }
+        run = row + rows;
+    }
+    sum += calc_sum_reduce(col->data + run, end - run, 1);
+    valid += end - run;
+
+    *count = valid;
+    return sum;
+}
+
+struct column_sum_job {
+    const calc_column_t *col;
+    int64_t *sum;
+    size_t *count;
+};
+
+static void column_sum_task(void *ctx, size_t task) {
+    struct column_sum_job *job = ctx;
+    size_t begin = task * CALC_COLUMN_CHUNK;
+    size_t end = job->col->len - begin < CALC_COLUMN_CHUNK ? job->col->len : begin + CALC_COLUMN_CHUNK;
+    job->sum[task] = masked_sum(job->col, begin, end, &job->count[task]);
+}
+
+int64_t calc_column_sum(const calc_column_t *col, unsigned max_threads, size_t *valid_rows) {
+    if (col->validity == NULL) {
+        if (valid_rows != NULL) {
+            *valid_rows = col->len;
+        }
+        return calc_sum_reduce(col->data, col->len, max_threads);
+    }
+
+    size_t nchunks = (col->len + CALC_COLUMN_CHUNK - 1) / CALC_COLUMN_CHUNK;
+    int64_t stack_sum[CALC_COLUMN_STACK_CHUNKS];
+    size_t stack_count[CALC_COLUMN_STACK_CHUNKS];
+    int64_t *sum = stack_sum;
+    size_t *count = stack_count;
+    size_t total_count = 0;
+    int64_t total = 0;
+
+    if (nchunks > CALC_COLUMN_STACK_CHUNKS) {
+        sum = malloc(nchunks * sizeof(*sum));
+        count = malloc(nchunks * sizeof(*count));
+    }
+    if (nchunks <= 1 || sum == NULL || count == NULL) {
+        total = masked_sum(col, 0, col->len, &total_count);
+    } else {
+        struct column_sum_job job = { col, sum, count };
+        sdk_pool_parallel_for(nchunks, max_threads, column_sum_task, &job);
+        for (size_t i = 0; i < nchunks; i++) {
+            total += sum[i];
+            total_count += count[i];
+        }
+    }
+
+    if (sum != stack_sum) {
+        free(sum);
+        free(count);
+    }
+    if (valid_rows != NULL) {
+        *valid_rows = total_count;
+    }
+    return total;
+}
@@ -0,0 +1,85 @@
+#include "calc.h"
+#include "calc-isa-internal.h"
+
+/*
+ * Round-up multiply-shift (Granlund & Montgomery): with l = ceil(log2(d))
+ * and m = ceil(2^(32 + l) / d), floor(n / d) == (n * m) >> (32 + l) for
+ * every n < 2^32. |a| <= 2^31 and m < 2^33, so n * m fits in 64 bits.
+ */
+void calc_divider_init(calc_divider_t *div, int divisor) {
+    if (divisor == 0) {
+        // magic 0 makes every quotient 0, like calc_divide
+        div->magic = 0;
+        div->shift = 0;
+        div->sign = 0;
+        return;
+    }
+
+    uint32_t d = divisor < 0 ? 0u - (uint32_t)divisor : (uint32_t)divisor;
+    uint32_t l = 0;
+    while ((1ULL << l) < d) {
+        l++;
+    }
+
+    div->shift = 32 + l;
+    div->magic = ((1ULL << div->shift) + d - 1) / d;
+    div->sign = divisor < 0 ? 0xFFFFFFFFu : 0u;
+}
+
+int calc_divider_divide(const calc_divider_t *div, int a) {
+    // Work on |a|, then apply the combined sign without branching
+    uint32_t sign = (uint32_t)(a >> 31);
+    uint32_t ua = ((uint32_t)a ^ sign) - sign;
+    uint32_t q = (uint32_t)(((uint64_t)ua * div->magic) >> div->shift);
+    sign ^= div->sign;
+    return (int)((q ^ sign) - sign);
+}
+
+#ifdef CALC_X86
+
+/*
+ * AVX2 kernel (8 lanes). _mm256_mul_epu32 only takes 32-bit operands, so the
+ * 33-bit magic is split into high and low halves.
+ */
+__attribute__((target("avx2")))
+static void avx2_divider_divide(const calc_divider_t *div, const int *a, int *out, size_t n) {
+    const __m256i mlo = _mm256_set1_epi64x((long long)(div->magic & 0xFFFFFFFFu));
+    const __m256i mhi = _mm256_set1_epi64x((long long)(div->magic >> 32));
+    const __m128i shift = _mm_cvtsi32_si128((int)div->shift);
+    const __m256i dsign = _mm256_set1_epi32((int)div->sign);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i sign = _mm256_xor_si256(_mm256_srai_epi32(va, 31), dsign);
+        __m256i ua = _mm256_abs_epi32(va);
+        __m256i ua_odd = _mm256_srli_epi64(ua, 32);
+
+        __m256i p_even = _mm256_add_epi64(_mm256_mul_epu32(ua, mlo),
+                                          _mm256_slli_epi64(_mm256_mul_epu32(ua, mhi), 32));
+        __m256i p_odd = _mm256_add_epi64(_mm256_mul_epu32(ua_odd, mlo),
+                                         _mm256_slli_epi64(_mm256_mul_epu32(ua_odd, mhi), 32));
+        __m256i q = _mm256_blend_epi32(_mm256_srl_epi64(p_even, shift),
+                                       _mm256_slli_epi64(_mm256_srl_epi64(p_odd, shift), 32),
+                                       0xAA);
+
+        q = _mm256_sub_epi32(_mm256_xor_si256(q, sign), sign);
+        _mm256_storeu_si256((__m256i *)(out + i), q);
+    }
+    for (; i < n; i++) {
+        out[i] = calc_divider_divide(div, a[i]);
+    }
+}
+
+#endif /* CALC_X86 */
+
+void calc_divider_divide_n(const calc_divider_t *div, const int *a, int *out, size_t n) {
+#ifdef CALC_X86
+    if (calc_batch_use_avx2()) {
+        avx2_divider_divide(div, a, out, n);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < n; i++) {
+        out[i] = calc_divider_divide(div, a[i]);
+    }
+}
@@ -0,0 +1,352 @@
+#include "calc.h"
+#include "calc-fixed.h"
+#include "calc-isa-internal.h"
+
+/*============================================================================
+ * Rounding and saturation
+ *
+ * Every rounding mode is floor((p + bias) / 2^s) for a per-value bias, so
+ * the scalar and vector paths share one formula:
+ *   FLOOR    0
+ *   TRUNC    2^s - 1 if p < 0 (rounds negatives up)
+ *   NEAREST  2^(s-1), minus 1 if p < 0 (ties away from zero)
+ *   EVEN     2^(s-1) - 1, plus 1 if floor(p / 2^s) is odd
+ * p is a product of two int32 (|p| <= 2^62), so p + bias can't overflow.
+ *===========================================================================*/
+
+static int64_t fixed_round_bias(int64_t p, int s, calc_round_t mode) {
+    int64_t half = (int64_t)1 << (s - 1);
+    switch (mode) {
+    case CALC_ROUND_TRUNC:
+        return p < 0 ? ((int64_t)1 << s) - 1 : 0;
+    case CALC_ROUND_NEAREST:
+        return half - (p < 0);
+    case CALC_ROUND_EVEN:
+        return half - 1 + ((p >> s) & 1);
+    default:
+        return 0;
+    }
+}
+
+static int32_t fixed_saturate(int64_t v) {
+    if (v > INT32_MAX) {
+        return INT32_MAX;
+    }
+    if (v < INT32_MIN) {
+        return INT32_MIN;
+    }
+    return (int32_t)v;
+}
+
+// Round p / 2^s to an int32 (1 <= s <= 31)
+static int32_t fixed_shift_round(int64_t p, int s, calc_round_t mode) {
+    return fixed_saturate((p + fixed_round_bias(p, s, mode)) >> s);
+}
+
+static int32_t fixed_multiply(int32_t a, int32_t b, int s, calc_round_t mode) {
+    return fixed_shift_round((int64_t)a * b, s, mode);
+}
+
+static int32_t fixed_divide(int32_t a, int32_t b, int s, calc_round_t mode) {
+    if (b == 0) {
+        return 0;
+    }
+    // |a| * 2^s < 2^62: the quotient is exact in 64 bits, even for b == -1
+    int64_t num = (int64_t)a * ((int64_t)1 << s);
+    int64_t q = num / b;
+    int64_t r = num % b;
+    if (r != 0 && mode != CALC_ROUND_TRUNC) {
+        int negative = (r < 0) != (b < 0);  // r has the sign of num
+        uint64_t r2 = 2 * (uint64_t)(r < 0 ? -r : r);
+        uint64_t bb = b < 0 ? -(uint64_t)b : (uint64_t)b;
+        int away;
+        switch (mode) {
+        case CALC_ROUND_NEAREST:
+            away = r2 >= bb;
+            break;
+        case CALC_ROUND_EVEN:
+            away = r2 > bb || (r2 == bb && (q & 1));
+            break;
+        default:
+            away = negative;  // FLOOR: only negative quotients move
+            break;
+        }
+        if (away) {
+            q += negative ? -1 : 1;
+        }
+    }
+    return fixed_saturate(q);
+}
+
+static int32_t fixed_from_double(double v, int s) {
+    double x = v * (double)((int64_t)1 << s);
+    if (x != x) {
+        return 0;  // NaN
+    }
+    if (x >= 2147483647.5) {
+        return INT32_MAX;
+    }
+    if (x <= -2147483648.5) {
+        return INT32_MIN;
+    }
+    // x - t is exact here, so ties are detected exactly
+    int64_t t = (int64_t)x;
+    double frac = x - (double)t;
+    if (frac >= 0.5) {
+        t++;
+    } else if (frac <= -0.5) {
+        t--;
+    }
+    return fixed_saturate(t);
+}
+
+/*============================================================================
+ * Scalar API
+ *===========================================================================*/
+
+calc_q16_t calc_q16_from_int(int v) {
+    return fixed_saturate((int64_t)v * CALC_Q16_ONE);
+}
+
+int calc_q16_to_int(calc_q16_t v, calc_round_t mode) {
+    return fixed_shift_round(v, CALC_Q16_FRAC_BITS, mode);
+}
+
+calc_q16_t calc_q16_from_double(double v) {
+    return fixed_from_double(v, CALC_Q16_FRAC_BITS);
+}
+
+calc_q31_t calc_q31_from_double(double v) {
+    return fixed_from_double(v, CALC_Q31_FRAC_BITS);
+}
+
+double calc_q16_to_double(calc_q16_t v) {
+    return (double)v / (double)CALC_Q16_ONE;
+}
+
+double calc_q31_to_double(calc_q31_t v) {
+    return (double)v / 2147483648.0;
+}
+
+int32_t calc_fixed_add(int32_t a, int32_t b) {
+    return fixed_saturate((int64_t)a + b);
+}
+
+int32_t calc_fixed_subtract(int32_t a, int32_t b) {
+    return fixed_saturate((int64_t)a - b);
+}
+
+calc_q16_t calc_q16_multiply(calc_q16_t a, calc_q16_t b, calc_round_t mode) {
+    return fixed_multiply(a, b, CALC_Q16_FRAC_BITS, mode);
+}
+
+calc_q16_t calc_q16_divide(calc_q16_t a, calc_q16_t b, calc_round_t mode) {
+    return fixed_divide(a, b, CALC_Q16_FRAC_BITS, mode);
+}
+
+calc_q31_t calc_q31_multiply(calc_q31_t a, calc_q31_t b, calc_round_t mode) {
+    return fixed_multiply(a, b, CALC_Q31_FRAC_BITS, mode);
+}
+
+calc_q31_t calc_q31_divide(calc_q31_t a, calc_q31_t b, calc_round_t mode) {
+    return fixed_divide(a, b, CALC_Q31_FRAC_BITS, mode);
+}
+
+/*============================================================================
+ * Scalar kernels (also used for the tail of every vector kernel)
+ *===========================================================================*/
+
+static void scalar_add(const int32_t *a, const int32_t *b, int32_t *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = calc_fixed_add(a[i], b[i]);
+    }
+}
+
+static void scalar_subtract(const int32_t *a, const int32_t *b, int32_t *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = calc_fixed_subtract(a[i], b[i]);
+    }
+}
+
+static void scalar_multiply(const int32_t *a, const int32_t *b, int32_t *out, size_t n, int s,
+                            calc_round_t mode) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = fixed_multiply(a[i], b[i], s, mode);
+    }
+}
+
+static void scalar_divide(const int32_t *a, const int32_t *b, int32_t *out, size_t n, int s,
+                          calc_round_t mode) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = fixed_divide(a[i], b[i], s, mode);
+    }
+}
+
+#ifdef CALC_X86
+
+/*============================================================================
+ * AVX2 kernels (8 lanes)
+ *
+ * Saturating add / subtract: overflow iff the operands' signs agree (add)
+ * or differ (subtract) and the result's sign differs from a; overflowed
+ * lanes take INT32_MAX or INT32_MIN by a's sign.
+ *
+ * Multiply: vpmuldq gives exact 64-bit products of the even lanes, and of
+ * the odd lanes after a 32-bit shift. Each product gets the rounding bias,
+ * is clamped with 64-bit compares, and the logical shift right by s leaves
+ * the result in the low half of the lane (AVX2 has no 64-bit arithmetic
+ * shift, and the low 32 bits are the same either way).
+ *===========================================================================*/
+
+__attribute__((target("avx2")))
+static __m256i avx2_saturate_blend(__m256i a, __m256i result, __m256i overflow) {
+    __m256i sat = _mm256_xor_si256(_mm256_srai_epi32(a, 31), _mm256_set1_epi32(INT32_MAX));
+    return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(result), _mm256_castsi256_ps(sat),
+                                                _mm256_castsi256_ps(overflow)));
+}
+
+__attribute__((target("avx2")))
+static void avx2_add(const int32_t *a, const int32_t *b, int32_t *out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        __m256i sum = _mm256_add_epi32(va, vb);
+        __m256i overflow = _mm256_and_si256(_mm256_xor_si256(va, sum), _mm256_xor_si256(vb, sum));
+        _mm256_storeu_si256((__m256i *)(out + i), avx2_saturate_blend(va, sum, overflow));
+    }
+    scalar_add(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void avx2_subtract(const int32_t *a, const int32_t *b, int32_t *out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        __m256i diff = _mm256_sub_epi32(va, vb);
+        __m256i overflow = _mm256_and_si256(_mm256_xor_si256(va, vb), _mm256_xor_si256(va, diff));
+        _mm256_storeu_si256((__m256i *)(out + i), avx2_saturate_blend(va, diff, overflow));
+    }
+    scalar_subtract(a + i, b + i, out + i, n - i);
+}
+
+struct avx2_round {
+    __m128i shift;      /* s, as a shift count */
+    __m256i half;       /* 2^(s-1) */
+    __m256i mask;       /* 2^s - 1 */
+    __m256i one;
+    __m256i hi;         /* 2^(31+s) - 1: largest p that doesn't saturate */
+    __m256i lo;         /* -2^(31+s) */
+    __m256i max;
+    __m256i min;
+};
+
+// Round and saturate 4 products in 64-bit lanes; result in the low 32 bits
+__attribute__((target("avx2")))
+static __m256i avx2_shift_round(__m256i p, const struct avx2_round *k, calc_round_t mode) {
+    __m256i negative = _mm256_cmpgt_epi64(_mm256_setzero_si256(), p);
+    __m256i bias;
+    switch (mode) {
+    case CALC_ROUND_TRUNC:
+        bias = _mm256_and_si256(negative, k->mask);
+        break;
+    case CALC_ROUND_NEAREST:
+        bias = _mm256_add_epi64(k->half, negative);
+        break;
+    case CALC_ROUND_EVEN:
+        bias = _mm256_add_epi64(_mm256_sub_epi64(k->half, k->one),
+                                _mm256_and_si256(_mm256_srl_epi64(p, k->shift), k->one));
+        break;
+    default:
+        bias = _mm256_setzero_si256();
+        break;
+    }
+    p = _mm256_add_epi64(p, bias);
+    __m256i r = _mm256_srl_epi64(p, k->shift);
+    r = _mm256_blendv_epi8(r, k->max, _mm256_cmpgt_epi64(p, k->hi));
+    return _mm256_blendv_epi8(r, k->min, _mm256_cmpgt_epi64(k->lo, p));
+}
+
+__attribute__((target("avx2")))
+static void avx2_multiply(const int32_t *a, const int32_t *b, int32_t *out, size_t n, int s,
+                          calc_round_t mode) {
+    const struct avx2_round k = {
+        _mm_cvtsi32_si128(s),
+        _mm256_set1_epi64x((int64_t)1 << (s - 1)),
+        _mm256_set1_epi64x(((int64_t)1 << s) - 1),
+        _mm256_set1_epi64x(1),
+        _mm256_set1_epi64x(((int64_t)1 << (31 + s)) - 1),
+        _mm256_set1_epi64x(-((int64_t)1 << (31 + s))),
+        _mm256_set1_epi64x(INT32_MAX),
+        _mm256_set1_epi64x((int64_t)(uint32_t)INT32_MIN),
+    };
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        __m256i even = _mm256_mul_epi32(va, vb);
+        __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(va, 32), _mm256_srli_epi64(vb, 32));
+        even = avx2_shift_round(even, &k, mode);
+        odd = _mm256_slli_epi64(avx2_shift_round(odd, &k, mode), 32);
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_blend_epi32(even, odd, 0xAA));
+    }
+    scalar_multiply(a + i, b + i, out + i, n - i, s, mode);
+}
+
+#endif /* CALC_X86 */
+
+/*============================================================================
+ * Batch API
+ *===========================================================================*/
+
+void calc_fixed_add_n(const int32_t *a, const int32_t *b, int32_t *out, size_t n) {
+#ifdef CALC_X86
+    if (calc_batch_use_avx2()) {
+        avx2_add(a, b, out, n);
+        return;
+    }
+#endif
+    scalar_add(a, b, out, n);
+}
+
+void calc_fixed_subtract_n(const int32_t *a, const int32_t *b, int32_t *out, size_t n) {
+#ifdef CALC_X86
+    if (calc_batch_use_avx2()) {
+        avx2_subtract(a, b, out, n);
+        return;
+    }
+#endif
+    scalar_subtract(a, b, out, n);
+}
+
+static void fixed_multiply_n(const int32_t *a, const int32_t *b, int32_t *out, size_t n, int s,
+                             calc_round_t mode) {
+#ifdef CALC_X86
+    if (calc_batch_use_avx2()) {
+        avx2_multiply(a, b, out, n, s, mode);
+        return;
+    }
+#endif
+    scalar_multiply(a, b, out, n, s, mode);
+}
+
+void calc_q16_multiply_n(const calc_q16_t *a, const calc_q16_t *b, calc_q16_t *out, size_t n,
+                         calc_round_t mode) {
+    fixed_multiply_n(a, b, out, n, CALC_Q16_FRAC_BITS, mode);
+}
+
+void calc_q16_divide_n(const calc_q16_t *a, const calc_q16_t *b, calc_q16_t *out, size_t n,
+                       calc_round_t mode) {
+    scalar_divide(a, b, out, n, CALC_Q16_FRAC_BITS, mode);
+}
+
+void calc_q31_multiply_n(const calc_q31_t *a, const calc_q31_t *b, calc_q31_t *out, size_t n,
+                         calc_round_t mode) {
+    fixed_multiply_n(a, b, out, n, CALC_Q31_FRAC_BITS, mode);
+}
+
+void calc_q31_divide_n(const calc_q31_t *a, const calc_q31_t *b, calc_q31_t *out, size_t n,
+                       calc_round_t mode) {
+    scalar_divide(a, b, out, n, CALC_Q31_FRAC_BITS, mode);
+}
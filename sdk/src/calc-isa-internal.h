@@ -0,0 +1,35 @@
+#ifndef __CALC_ISA_INTERNAL_H__
+#define __CALC_ISA_INTERNAL_H__
+
+#include "calc.h"
+
+/*
+ * Shared setup for the x86 SIMD kernels
+ *
+ * CALC_X86 is defined where the GNU x86 intrinsics are available, 32- or
+ * 64-bit. CALC_X86_64 is defined on x86-64 only, for code that needs
+ * 64-bit-only intrinsics or emits x86-64 machine code. Kernels are built
+ * with __attribute__((target(...))) and only called after a runtime check.
+ */
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CALC_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define CALC_X86_64 1
+#endif
+
+/**
+ * Check whether AVX2 kernels may run
+ *
+ * Follows the batch API ISA selection, so calc_batch_set_isa steers every
+ * SIMD path in the SDK. AVX-512 CPUs also have AVX2.
+ * @return 1 if the selected batch ISA is AVX2 or above, 0 otherwise
+ */
+static inline int calc_batch_use_avx2(void) {
+    return calc_batch_get_isa() >= CALC_ISA_AVX2;
+}
+
+#endif /* __CALC_ISA_INTERNAL_H__ */
@@ -0,0 +1,367 @@
+#include <stdlib.h>
+#include <string.h>
+#include "calc.h"
+#include "calc-matrix.h"
+#include "calc-isa-internal.h"
+#include "sdk-pool.h"
+
+/*
+ * Blocking (Goto / BLIS style)
+ *
+ * MATRIX_KC rows of B form a panel; each task packs the MATRIX_KC x
+ * MATRIX_NC part of it that its output tile needs (256 KiB as int32) and a
+ * MATRIX_MC x MATRIX_KC block of A (96 KiB). The microkernel then streams
+ * one MATRIX_KC x NR sliver of packed B (16 KiB, L1) against every MR-row
+ * strip of packed A (L2) and keeps the MR x NR tile of C in registers:
+ * 6 x 16 int32 (12 ymm accumulators) or 6 x 8 int64 (12 ymm).
+ *
+ * Packed strips are zero-padded to full MR / NR, so the kernels never see
+ * edges; partial tiles are only clipped when written back to C.
+ */
+#define MATRIX_MR 6
+#define MATRIX_NR32 16
+#define MATRIX_NR64 8
+#define MATRIX_KC 256
+#define MATRIX_MC 96
+#define MATRIX_NC 256
+
+typedef void (*matrix_kernel32_fn)(size_t kc, const int32_t *pa, const int32_t *pb, int32_t *acc);
+typedef void (*matrix_kernel64_fn)(size_t kc, const int32_t *pa, const int64_t *pb, int64_t *acc);
+
+/*============================================================================
+ * Packing
+ *===========================================================================*/
+
+// A[ic .. ic + mc) x [pc .. pc + kc) -> MR-row strips, column by column
+static void pack_a(const int *a, size_t lda, size_t ic, size_t mc, size_t pc, size_t kc,
+                   int32_t *pa) {
+    for (size_t ir = 0; ir < mc; ir += MATRIX_MR) {
+        size_t mr = mc - ir < MATRIX_MR ? mc - ir : MATRIX_MR;
+        const int *src = a + (ic + ir) * lda + pc;
+        for (size_t p = 0; p < kc; p++) {
+            size_t r = 0;
+            for (; r < mr; r++) {
+                pa[r] = src[r * lda + p];
+            }
+            for (; r < MATRIX_MR; r++) {
+                pa[r] = 0;
+            }
+            pa += MATRIX_MR;
+        }
+    }
+}
+
+// B[pc .. pc + kc) x [jc .. jc + nc) -> NR-column strips, row by row
+static void pack_b32(const int *b, size_t ldb, size_t pc, size_t kc, size_t jc, size_t nc,
+                     int32_t *pb) {
+    for (size_t jr = 0; jr < nc; jr += MATRIX_NR32) {
+        size_t nr = nc - jr < MATRIX_NR32 ? nc - jr : MATRIX_NR32;
+        const int *src = b + pc * ldb + jc + jr;
+        for (size_t p = 0; p < kc; p++) {
+            memcpy(pb, src + p * ldb, nr * sizeof(int32_t));
+            memset(pb + nr, 0, (MATRIX_NR32 - nr) * sizeof(int32_t));
+            pb += MATRIX_NR32;
+        }
+    }
+}
+
+// Same layout, sign-extended to int64 lanes for the widening multiply
+static void pack_b64(const int *b, size_t ldb, size_t pc, size_t kc, size_t jc, size_t nc,
+                     int64_t *pb) {
+    for (size_t jr = 0; jr < nc; jr += MATRIX_NR64) {
+        size_t nr = nc - jr < MATRIX_NR64 ? nc - jr : MATRIX_NR64;
+        const int *src = b + pc * ldb + jc + jr;
+        for (size_t p = 0; p < kc; p++) {
+            size_t c = 0;
+            for (; c < nr; c++) {
+                pb[c] = src[p * ldb + c];
+            }
+            for (; c < MATRIX_NR64; c++) {
+                pb[c] = 0;
+            }
+            pb += MATRIX_NR64;
+        }
+    }
+}
+
+/*============================================================================
+ * Scalar microkernels (unsigned arithmetic: wraps instead of overflowing)
+ *===========================================================================*/
+
+static void scalar_kernel32(size_t kc, const int32_t *pa, const int32_t *pb, int32_t *acc) {
+    uint32_t t[MATRIX_MR][MATRIX_NR32] = { { 0 } };
+    for (size_t p = 0; p < kc; p++) {
+        for (int r = 0; r < MATRIX_MR; r++) {
+            uint32_t av = (uint32_t)pa[r];
+            for (int c = 0; c < MATRIX_NR32; c++) {
+                t[r][c] += av * (uint32_t)pb[c];
+            }
+        }
+        pa += MATRIX_MR;
+        pb += MATRIX_NR32;
+    }
+    memcpy(acc, t, sizeof(t));
+}
+
+static void scalar_kernel64(size_t kc, const int32_t *pa, const int64_t *pb, int64_t *acc) {
+    uint64_t t[MATRIX_MR][MATRIX_NR64] = { { 0 } };
+    for (size_t p = 0; p < kc; p++) {
+        for (int r = 0; r < MATRIX_MR; r++) {
+            int64_t av = pa[r];
+            for (int c = 0; c < MATRIX_NR64; c++) {
+                t[r][c] += (uint64_t)(av * pb[c]);
+            }
+        }
+        pa += MATRIX_MR;
+        pb += MATRIX_NR64;
+    }
+    memcpy(acc, t, sizeof(t));
+}
+
+#ifdef CALC_X86
+
+/*============================================================================
+ * AVX2 microkernels
+ *
+ * Per k step: two loads of packed B, then for each of the 6 rows one
+ * broadcast of A and two multiply-adds into that row's accumulators.
+ * int32: vpmulld keeps the low 32 bits of each product (wraps like the
+ * batch multiply). int64: vpmuldq multiplies the low 32 bits of each
+ * 64-bit lane into a full signed 64-bit product.
+ *===========================================================================*/
+
+#define MATRIX_ROW32(r)                                                     \
+    do {                                                                    \
+        __m256i va = _mm256_set1_epi32(pa[r]);                              \
+        c##r##0 = _mm256_add_epi32(c##r##0, _mm256_mullo_epi32(va, b0));    \
+        c##r##1 = _mm256_add_epi32(c##r##1, _mm256_mullo_epi32(va, b1));    \
+    } while (0)
+
+__attribute__((target("avx2")))
+static void avx2_kernel32(size_t kc, const int32_t *pa, const int32_t *pb, int32_t *acc) {
+    __m256i c00 = _mm256_setzero_si256(), c01 = _mm256_setzero_si256();
+    __m256i c10 = _mm256_setzero_si256(), c11 = _mm256_setzero_si256();
+    __m256i c20 = _mm256_setzero_si256(), c21 = _mm256_setzero_si256();
+    __m256i c30 = _mm256_setzero_si256(), c31 = _mm256_setzero_si256();
+    __m256i c40 = _mm256_setzero_si256(), c41 = _mm256_setzero_si256();
+    __m256i c50 = _mm256_setzero_si256(), c51 = _mm256_setzero_si256();
+    for (size_t p = 0; p < kc; p++) {
+        __m256i b0 = _mm256_loadu_si256((const __m256i *)pb);
+        __m256i b1 = _mm256_loadu_si256((const __m256i *)(pb + 8));
+        MATRIX_ROW32(0);
+        MATRIX_ROW32(1);
+        MATRIX_ROW32(2);
+        MATRIX_ROW32(3);
+        MATRIX_ROW32(4);
+        MATRIX_ROW32(5);
+        pa += MATRIX_MR;
+        pb += MATRIX_NR32;
+    }
+    __m256i *out = (__m256i *)acc;
+    _mm256_storeu_si256(out + 0, c00);
+    _mm256_storeu_si256(out + 1, c01);
+    _mm256_storeu_si256(out + 2, c10);
+    _mm256_storeu_si256(out + 3, c11);
+    _mm256_storeu_si256(out + 4, c20);
+    _mm256_storeu_si256(out + 5, c21);
+    _mm256_storeu_si256(out + 6, c30);
+    _mm256_storeu_si256(out + 7, c31);
+    _mm256_storeu_si256(out + 8, c40);
+    _mm256_storeu_si256(out + 9, c41);
+    _mm256_storeu_si256(out + 10, c50);
+    _mm256_storeu_si256(out + 11, c51);
+}
+
+#define MATRIX_ROW64(r)                                                     \
+    do {                                                                    \
+        __m256i va = _mm256_set1_epi64x(pa[r]);                             \
+        c##r##0 = _mm256_add_epi64(c##r##0, _mm256_mul_epi32(va, b0));      \
+        c##r##1 = _mm256_add_epi64(c##r##1, _mm256_mul_epi32(va, b1));      \
+    } while (0)
+
+__attribute__((target("avx2")))
+static void avx2_kernel64(size_t kc, const int32_t *pa, const int64_t *pb, int64_t *acc) {
+    __m256i c00 = _mm256_setzero_si256(), c01 = _mm256_setzero_si256();
+    __m256i c10 = _mm256_setzero_si256(), c11 = _mm256_setzero_si256();
+    __m256i c20 = _mm256_setzero_si256(), c21 = _mm256_setzero_si256();
+    __m256i c30 = _mm256_setzero_si256(), c31 = _mm256_setzero_si256();
+    __m256i c40 = _mm256_setzero_si256(), c41 = _mm256_setzero_si256();
+    __m256i c50 = _mm256_setzero_si256(), c51 = _mm256_setzero_si256();
+    for (size_t p = 0; p < kc; p++) {
+        __m256i b0 = _mm256_loadu_si256((const __m256i *)pb);
+        __m256i b1 = _mm256_loadu_si256((const __m256i *)(pb + 4));
+        MATRIX_ROW64(0);
+        MATRIX_ROW64(1);
+        MATRIX_ROW64(2);
+        MATRIX_ROW64(3);
+        MATRIX_ROW64(4);
+        MATRIX_ROW64(5);
+        pa += MATRIX_MR;
+        pb += MATRIX_NR64;
+    }
+    __m256i *out = (__m256i *)acc;
+    _mm256_storeu_si256(out + 0, c00);
+    _mm256_storeu_si256(out + 1, c01);
+    _mm256_storeu_si256(out + 2, c10);
+    _mm256_storeu_si256(out + 3, c11);
+    _mm256_storeu_si256(out + 4, c20);
+    _mm256_storeu_si256(out + 5, c21);
+    _mm256_storeu_si256(out + 6, c30);
+    _mm256_storeu_si256(out + 7, c31);
+    _mm256_storeu_si256(out + 8, c40);
+    _mm256_storeu_si256(out + 9, c41);
+    _mm256_storeu_si256(out + 10, c50);
+    _mm256_storeu_si256(out + 11, c51);
+}
+
+#endif /* CALC_X86 */
+
+/*============================================================================
+ * Driver
+ *===========================================================================*/
+
+struct matrix_job {
+    const int *a;
+    const int *b;
+    void *c;                    /* int * or int64_t * */
+    size_t m, n, k;
+    size_t mblocks;             /* output tiles per column of tiles */
+    int wide;                   /* int64 accumulation */
+    matrix_kernel32_fn kernel32;
+    matrix_kernel64_fn kernel64;
+};
+
+// Unpacked fallback for one output tile when the pack buffers can't be allocated
+static void naive_tile(const struct matrix_job *job, size_t ic, size_t mc, size_t jc, size_t nc) {
+    for (size_t i = ic; i < ic + mc; i++) {
+        for (size_t j = jc; j < jc + nc; j++) {
+            uint64_t sum = 0;
+            for (size_t p = 0; p < job->k; p++) {
+                sum += (uint64_t)((int64_t)job->a[i * job->k + p] * job->b[p * job->n + j]);
+            }
+            // The low 32 bits of the exact sum are the wrapped int32 sum
+            if (job->wide) {
+                ((int64_t *)job->c)[i * job->n + j] = (int64_t)sum;
+            } else {
+                ((int *)job->c)[i * job->n + j] = (int)(uint32_t)sum;
+            }
+        }
+    }
+}
+
+static void matrix_task(void *ctx, size_t task) {
+    const struct matrix_job *job = ctx;
+    size_t ic = (task % job->mblocks) * MATRIX_MC;
+    size_t jc = (task / job->mblocks) * MATRIX_NC;
+    size_t mc = job->m - ic < MATRIX_MC ? job->m - ic : MATRIX_MC;
+    size_t nc = job->n - jc < MATRIX_NC ? job->n - jc : MATRIX_NC;
+    size_t nr = job->wide ? MATRIX_NR64 : MATRIX_NR32;
+    size_t kc_max = job->k < MATRIX_KC ? job->k : MATRIX_KC;
+    size_t pa_len = (mc + MATRIX_MR - 1) / MATRIX_MR * MATRIX_MR * kc_max;
+    size_t pb_len = (nc + nr - 1) / nr * nr * kc_max;
+
+    int32_t *pa = NULL;
+    void *pb = NULL;
+    if (posix_memalign((void **)&pa, 64, pa_len * sizeof(int32_t)) != 0 ||
+        posix_memalign(&pb, 64, pb_len * (job->wide ? sizeof(int64_t) : sizeof(int32_t))) != 0) {
+        free(pa);
+        naive_tile(job, ic, mc, jc, nc);
+        return;
+    }
+
+    for (size_t pc = 0; pc < job->k; pc += MATRIX_KC) {
+        size_t kc = job->k - pc < MATRIX_KC ? job->k - pc : MATRIX_KC;
+        pack_a(job->a, job->k, ic, mc, pc, kc, pa);
+        if (job->wide) {
+            pack_b64(job->b, job->n, pc, kc, jc, nc, pb);
+        } else {
+            pack_b32(job->b, job->n, pc, kc, jc, nc, pb);
+        }
+
+        // B sliver outer (stays in L1), A strips inner (stream from L2)
+        for (size_t jr = 0; jr < nc; jr += nr) {
+            size_t ncols = nc - jr < nr ? nc - jr : nr;
+            for (size_t ir = 0; ir < mc; ir += MATRIX_MR) {
+                size_t nrows = mc - ir < MATRIX_MR ? mc - ir : MATRIX_MR;
+                const int32_t *a_strip = pa + ir * kc;
+                if (job->wide) {
+                    int64_t acc[MATRIX_MR * MATRIX_NR64];
+                    job->kernel64(kc, a_strip, (const int64_t *)pb + jr * kc, acc);
+                    int64_t *c = (int64_t *)job->c + (ic + ir) * job->n + jc + jr;
+                    for (size_t r = 0; r < nrows; r++) {
+                        for (size_t j = 0; j < ncols; j++) {
+                            int64_t v = acc[r * MATRIX_NR64 + j];
+                            c[r * job->n + j] =
+                                pc == 0 ? v : (int64_t)((uint64_t)c[r * job->n + j] + (uint64_t)v);
+                        }
+                    }
+                } else {
+                    int32_t acc[MATRIX_MR * MATRIX_NR32];
+                    job->kernel32(kc, a_strip, (const int32_t *)pb + jr * kc, acc);
+                    int *c = (int *)job->c + (ic + ir) * job->n + jc + jr;
+                    for (size_t r = 0; r < nrows; r++) {
+                        for (size_t j = 0; j < ncols; j++) {
+                            int32_t v = acc[r * MATRIX_NR32 + j];
+                            c[r * job->n + j] =
+                                pc == 0 ? v : (int)((uint32_t)c[r * job->n + j] + (uint32_t)v);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    free(pa);
+    free(pb);
+}
+
+static void matrix_multiply(const int *a, const int *b, void *c, size_t m, size_t n, size_t k,
+                            unsigned max_threads, int wide) {
+    if (m == 0 || n == 0) {
+        return;
+    }
+    if (k == 0) {
+        memset(c, 0, m * n * (wide ? sizeof(int64_t) : sizeof(int)));
+        return;
+    }
+
+    struct matrix_job job = { a, b, c, m, n, k, (m + MATRIX_MC - 1) / MATRIX_MC, wide,
+                              scalar_kernel32, scalar_kernel64 };
+#ifdef CALC_X86
+    if (calc_batch_use_avx2()) {
+        job.kernel32 = avx2_kernel32;
+        job.kernel64 = avx2_kernel64;
+    }
+#endif
+
+    size_t ntasks = job.mblocks * ((n + MATRIX_NC - 1) / MATRIX_NC);
+    if (ntasks == 1 || max_threads == 1) {
+        for (size_t t = 0; t < ntasks; t++) {
+            matrix_task(&job, t);
+        }
+        return;
+    }
+    sdk_pool_parallel_for(ntasks, max_threads, matrix_task, &job);
+}
+
+void calc_matrix_multiply(const int *a, const int *b, int *c, size_t m, size_t n, size_t k,
+                          unsigned max_threads) {
+    matrix_multiply(a, b, c, m, n, k, max_threads, 0);
+}
+
+void calc_matrix_multiply64(const int *a, const int *b, int64_t *c, size_t m, size_t n, size_t k,
+                            unsigned max_threads) {
+    matrix_multiply(a, b, c, m, n, k, max_threads, 1);
+}
+
+void calc_matrix_multiply_ref(const int *a, const int *b, int *c, size_t m, size_t n, size_t k) {
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            int sum = 0;
+            for (size_t p = 0; p < k; p++) {
+                sum = calc_add(sum, calc_multiply(a[i * k + p], b[p * n + j]));
+            }
+            c[i * n + j] = sum;
+        }
+    }
+}
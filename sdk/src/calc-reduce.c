@@ -0,0 +1,267 @@
+#include <stdlib.h>
+#include "calc.h"
+#include "calc-isa-internal.h"
+#include "sdk-pool.h"
+
+/*
+ * One task per 64K ints (256 KiB): big enough to amortize the hand-off,
+ * small enough to stay in L2 and to balance across threads. The chunk size
+ * is a whole number of 4 KiB pages, so with a page-aligned input no page is
+ * shared by two tasks and pages first-touched by a thread stay local to its
+ * NUMA node.
+ */
+#define CALC_REDUCE_CHUNK (64 * 1024)
+
+// Partial sums for up to this many chunks live on the stack
+#define CALC_REDUCE_STACK_CHUNKS 64
+
+static int64_t scalar_sum(const int *a, size_t n) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += a[i];
+    }
+    return sum;
+}
+
+// x86-64 only: the kernels move int64 lanes with _mm_cvtsi128_si64 / _mm_extract_epi64
+#ifdef CALC_X86_64
+
+__attribute__((target("avx2")))
+static int64_t avx2_sum(const int *a, size_t n) {
+    // Sign-extend 4 ints at a time into two independent 64-bit accumulators
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(va)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(va, 1)));
+    }
+    __m256i acc = _mm256_add_epi64(acc0, acc1);
+    __m128i s = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    int64_t sum = _mm_cvtsi128_si64(s) + _mm_extract_epi64(s, 1);
+    return sum + scalar_sum(a + i, n - i);
+}
+
+#endif /* CALC_X86_64 */
+
+static int64_t calc_sum_block(const int *a, size_t n) {
+#ifdef CALC_X86_64
+    if (calc_batch_use_avx2()) {
+        return avx2_sum(a, n);
+    }
+#endif
+    return scalar_sum(a, n);
+}
+
+struct sum_job {
+    const int *a;
+    size_t n;
+    int64_t *partial;
+};
+
+static void sum_task(void *ctx, size_t task) {
+    struct sum_job *job = ctx;
+    size_t begin = task * CALC_REDUCE_CHUNK;
+    size_t len = job->n - begin < CALC_REDUCE_CHUNK ? job->n - begin : CALC_REDUCE_CHUNK;
+    job->partial[task] = calc_sum_block(job->a + begin, len);
+}
+
+int64_t calc_sum_reduce(const int *a, size_t n, unsigned max_threads) {
+    size_t nchunks = (n + CALC_REDUCE_CHUNK - 1) / CALC_REDUCE_CHUNK;
+    if (nchunks <= 1) {
+        return calc_sum_block(a, n);
+    }
+
+    int64_t stack_partial[CALC_REDUCE_STACK_CHUNKS];
+    int64_t *partial = stack_partial;
+    if (nchunks > CALC_REDUCE_STACK_CHUNKS) {
+        partial = malloc(nchunks * sizeof(*partial));
+        if (partial == NULL) {
+            return calc_sum_block(a, n);
+        }
+    }
+
+    struct sum_job job = { a, n, partial };
+    sdk_pool_parallel_for(nchunks, max_threads, sum_task, &job);
+
+    // Combine in chunk order so the result doesn't depend on scheduling
+    int64_t sum = 0;
+    for (size_t i = 0; i < nchunks; i++) {
+        sum += partial[i];
+    }
+
+    if (partial != stack_partial) {
+        free(partial);
+    }
+    return sum;
+}
+
+/*============================================================================
+ * Prefix scans
+ *
+ * Large inputs use reduce-then-scan: pass 1 sums every chunk in parallel,
+ * the chunk offsets are scanned serially, then pass 2 scans every chunk in
+ * parallel starting from its offset. Input is read twice and written once,
+ * and out may alias a because pass 1 never writes.
+ *
+ * 32-bit scans run on uint32_t, so they wrap modulo 2^32 like the batch API
+ * instead of hitting signed overflow.
+ *===========================================================================*/
+
+static uint32_t scalar_scan32(const int *a, int *out, size_t n, uint32_t carry, int exclusive) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t v = (uint32_t)a[i];
+        out[i] = (int)(exclusive ? carry : carry + v);
+        carry += v;
+    }
+    return carry;
+}
+
+static int64_t scalar_scan64(const int *a, int64_t *out, size_t n, int64_t carry, int exclusive) {
+    for (size_t i = 0; i < n; i++) {
+        int64_t v = a[i];
+        out[i] = exclusive ? carry : carry + v;
+        carry += v;
+    }
+    return carry;
+}
+
+#ifdef CALC_X86_64
+
+/*
+ * In-register scan of 8 int32 lanes: log-step shifts within each 128-bit
+ * half, then the low half's total is added to the high half.
+ */
+__attribute__((target("avx2")))
+static uint32_t avx2_scan32(const int *a, int *out, size_t n, uint32_t carry, int exclusive) {
+    const __m256i last = _mm256_set1_epi32(7);
+    __m256i vcarry = _mm256_set1_epi32((int)carry);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i x = _mm256_add_epi32(va, _mm256_slli_si256(va, 4));
+        x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+        __m256i lo_total = _mm256_permute2x128_si256(_mm256_shuffle_epi32(x, 0xFF),
+                                                     _mm256_shuffle_epi32(x, 0xFF), 0x08);
+        x = _mm256_add_epi32(_mm256_add_epi32(x, lo_total), vcarry);
+        _mm256_storeu_si256((__m256i *)(out + i), exclusive ? _mm256_sub_epi32(x, va) : x);
+        vcarry = _mm256_permutevar8x32_epi32(x, last);
+    }
+    carry = (uint32_t)_mm256_cvtsi256_si32(vcarry);
+    return scalar_scan32(a + i, out + i, n - i, carry, exclusive);
+}
+
+// Same for 4 int64 lanes, sign-extended from 4 ints at a time
+__attribute__((target("avx2")))
+static int64_t avx2_scan64(const int *a, int64_t *out, size_t n, int64_t carry, int exclusive) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i vcarry = _mm256_set1_epi64x(carry);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)(a + i)));
+        __m256i x = _mm256_add_epi64(va, _mm256_slli_si256(va, 8));
+        __m256i lo_total = _mm256_blend_epi32(zero, _mm256_permute4x64_epi64(x, 0x55), 0xF0);
+        x = _mm256_add_epi64(_mm256_add_epi64(x, lo_total), vcarry);
+        _mm256_storeu_si256((__m256i *)(out + i), exclusive ? _mm256_sub_epi64(x, va) : x);
+        vcarry = _mm256_permute4x64_epi64(x, 0xFF);
+    }
+    carry = _mm_cvtsi128_si64(_mm256_castsi256_si128(vcarry));
+    return scalar_scan64(a + i, out + i, n - i, carry, exclusive);
+}
+
+#endif /* CALC_X86_64 */
+
+static uint32_t calc_scan32_block(const int *a, int *out, size_t n, uint32_t carry, int exclusive) {
+#ifdef CALC_X86_64
+    if (calc_batch_use_avx2()) {
+        return avx2_scan32(a, out, n, carry, exclusive);
+    }
+#endif
+    return scalar_scan32(a, out, n, carry, exclusive);
+}
+
+static int64_t calc_scan64_block(const int *a, int64_t *out, size_t n, int64_t carry, int exclusive) {
+#ifdef CALC_X86_64
+    if (calc_batch_use_avx2()) {
+        return avx2_scan64(a, out, n, carry, exclusive);
+    }
+#endif
+    return scalar_scan64(a, out, n, carry, exclusive);
+}
+
+struct scan_job {
+    const int *a;
+    void *out;                /* int * or int64_t * */
+    size_t n;
+    int64_t *offset;          /* chunk sums, then chunk start offsets */
+    int wide;
+    int exclusive;
+};
+
+static void scan_task(void *ctx, size_t task) {
+    struct scan_job *job = ctx;
+    size_t begin = task * CALC_REDUCE_CHUNK;
+    size_t len = job->n - begin < CALC_REDUCE_CHUNK ? job->n - begin : CALC_REDUCE_CHUNK;
+    if (job->wide) {
+        calc_scan64_block(job->a + begin, (int64_t *)job->out + begin, len,
+                          job->offset[task], job->exclusive);
+    } else {
+        calc_scan32_block(job->a + begin, (int *)job->out + begin, len,
+                          (uint32_t)job->offset[task], job->exclusive);
+    }
+}
+
+static void calc_scan(const int *a, void *out, size_t n, unsigned max_threads, int wide, int exclusive) {
+    size_t nchunks = (n + CALC_REDUCE_CHUNK - 1) / CALC_REDUCE_CHUNK;
+    int64_t stack_offset[CALC_REDUCE_STACK_CHUNKS];
+    int64_t *offset = stack_offset;
+
+    // Two passes only pay off when another thread can help
+    int serial = nchunks <= 1 || max_threads == 1 || sdk_pool_size() == 1;
+    if (!serial && nchunks > CALC_REDUCE_STACK_CHUNKS) {
+        offset = malloc(nchunks * sizeof(*offset));
+        serial = offset == NULL;
+    }
+    if (serial) {
+        if (wide) {
+            calc_scan64_block(a, out, n, 0, exclusive);
+        } else {
+            calc_scan32_block(a, out, n, 0, exclusive);
+        }
+        return;
+    }
+
+    struct sum_job sums = { a, n, offset };
+    sdk_pool_parallel_for(nchunks, max_threads, sum_task, &sums);
+
+    int64_t carry = 0;
+    for (size_t i = 0; i < nchunks; i++) {
+        int64_t chunk_sum = offset[i];
+        offset[i] = carry;
+        carry += chunk_sum;
+    }
+
+    struct scan_job job = { a, out, n, offset, wide, exclusive };
+    sdk_pool_parallel_for(nchunks, max_threads, scan_task, &job);
+
+    if (offset != stack_offset) {
+        free(offset);
+    }
+}
+
+void calc_inclusive_scan(const int *a, int *out, size_t n, unsigned max_threads) {
+    calc_scan(a, out, n, max_threads, 0, 0);
+}
+
+void calc_exclusive_scan(const int *a, int *out, size_t n, unsigned max_threads) {
+    calc_scan(a, out, n, max_threads, 0, 1);
+}
+
+void calc_inclusive_scan64(const int *a, int64_t *out, size_t n, unsigned max_threads) {
+    calc_scan(a, out, n, max_threads, 1, 0);
+}
+
+void calc_exclusive_scan64(const int *a, int64_t *out, size_t n, unsigned max_threads) {
+    calc_scan(a, out, n, max_threads, 1, 1);
+}
@@ -1,27 +1,267 @@
-#include <stdio.h>
+#include <errno.h>
 #include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
 #include "greeting.h"
 
-const char* say_hello(const char* name) {
-    static char buffer[256];
+#define GREETING_BUFFER_SIZE 256
+#define GREETING_IOV_MAX 1024   /* iovecs on the stack per writev() (16 KiB) */
+
+static const char hello_prefix[] = "Hello, ";
+static const char goodbye_prefix[] = "Goodbye, ";
+static const char default_name[] = "stranger";
+static const char suffix[] = "!";
+
+// Copy as much of src as fits in buf[*pos .. avail)
+static void greeting_append(char* buf, size_t avail, size_t* pos, const char* src, size_t len) {
+    size_t n = avail - *pos < len ? avail - *pos : len;
+    memcpy(buf + *pos, src, n);
+    *pos += n;
+}
 
-    if (name == NULL || strlen(name) == 0) {
-        snprintf(buffer, sizeof(buffer), "Hello, stranger!");
-    } else {
-        snprintf(buffer, sizeof(buffer), "Hello, %s!", name);
+// prefix + name + suffix, assembled with memcpy (no format parsing)
+static size_t greeting_build(const char* prefix, size_t prefix_len, const char* name,
+                             size_t name_len, char* buf, size_t size) {
+    if (name == NULL) {
+        name_len = 0;
+    } else if (name_len == GREETING_NAME_STRLEN) {
+        name_len = strlen(name);
+    }
+    if (name_len == 0) {
+        name = default_name;
+        name_len = sizeof(default_name) - 1;
     }
 
-    return buffer;
+    size_t total = prefix_len + name_len + sizeof(suffix) - 1;
+    if (size == 0) {
+        return total;
+    }
+    size_t avail = size - 1;
+    size_t pos = 0;
+    greeting_append(buf, avail, &pos, prefix, prefix_len);
+    greeting_append(buf, avail, &pos, name, name_len);
+    greeting_append(buf, avail, &pos, suffix, sizeof(suffix) - 1);
+    buf[pos] = '\0';
+    return total;
 }
 
-const char* say_goodbye(const char* name) {
-    static char buffer[256];
+size_t say_hello_r(const char* name, size_t name_len, char* buf, size_t size) {
+    return greeting_build(hello_prefix, sizeof(hello_prefix) - 1, name, name_len, buf, size);
+}
+
+size_t say_goodbye_r(const char* name, size_t name_len, char* buf, size_t size) {
+    return greeting_build(goodbye_prefix, sizeof(goodbye_prefix) - 1, name, name_len, buf, size);
+}
+
+// Every message back-to-back into one arena: stop writing at the first
+// message that doesn't fit whole, but keep counting for the return value
+static size_t greeting_build_n(const char* prefix, size_t prefix_len, const char* const* names,
+                               size_t count, char sep, char* arena, size_t size,
+                               size_t* offsets) {
+    size_t pos = 0;
+    int fits = 1;
+
+    for (size_t i = 0; i < count; i++) {
+        const char* name = names[i];
+        size_t name_len = name != NULL ? strlen(name) : 0;
+        if (name_len == 0) {
+            name = default_name;
+            name_len = sizeof(default_name) - 1;
+        }
+        size_t len = prefix_len + name_len + sizeof(suffix) - 1 + 1;
+
+        if (offsets != NULL) {
+            offsets[i] = pos;
+        }
+        fits = fits && len <= size - pos;
+        if (fits) {
+            char* out = arena + pos;
+            memcpy(out, prefix, prefix_len);
+            out += prefix_len;
+            memcpy(out, name, name_len);
+            out += name_len;
+            memcpy(out, suffix, sizeof(suffix) - 1);
+            out[sizeof(suffix) - 1] = sep;
+        }
+        pos += len;
+    }
+    if (offsets != NULL) {
+        offsets[count] = pos;
+    }
+    return pos;
+}
+
+size_t say_hello_n(const char* const* names, size_t count, char sep,
+                   char* arena, size_t size, size_t* offsets) {
+    return greeting_build_n(hello_prefix, sizeof(hello_prefix) - 1, names, count, sep,
+                            arena, size, offsets);
+}
+
+size_t say_goodbye_n(const char* const* names, size_t count, char sep,
+                     char* arena, size_t size, size_t* offsets) {
+    return greeting_build_n(goodbye_prefix, sizeof(goodbye_prefix) - 1, names, count, sep,
+                            arena, size, offsets);
+}
+
+// writev() every iovec, resuming after short writes and EINTR (iov is consumed)
+static int greeting_writev_all(int fd, struct iovec* iov, int iovcnt, size_t* written) {
+    while (iovcnt > 0) {
+        ssize_t n = writev(fd, iov, iovcnt);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (n == 0) {
+            // Every iovec is non-empty, so no progress means the fd is stuck
+            errno = EIO;
+            return -1;
+        }
+        *written += (size_t)n;
+
+        // Drop the iovecs written whole, advance into the partial one
+        size_t done = (size_t)n;
+        while (iovcnt > 0 && done >= iov->iov_len) {
+            done -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char*)iov->iov_base + done;
+            iov->iov_len -= done;
+        }
+    }
+    return 0;
+}
+
+// prefix, name, tail as three iovecs pointing at the original bytes
+static struct iovec* greeting_iov(struct iovec* iov, const char* prefix, size_t prefix_len,
+                                  const char* name, size_t name_len, const char* tail,
+                                  size_t tail_len) {
+    if (name == NULL) {
+        name_len = 0;
+    } else if (name_len == GREETING_NAME_STRLEN) {
+        name_len = strlen(name);
+    }
+    if (name_len == 0) {
+        name = default_name;
+        name_len = sizeof(default_name) - 1;
+    }
+    iov[0].iov_base = (void*)prefix;
+    iov[0].iov_len = prefix_len;
+    iov[1].iov_base = (void*)name;
+    iov[1].iov_len = name_len;
+    iov[2].iov_base = (void*)tail;
+    iov[2].iov_len = tail_len;
+    return iov + 3;
+}
+
+static int greeting_write(int fd, const char* prefix, size_t prefix_len, const char* name,
+                          size_t name_len, size_t* written) {
+    struct iovec iov[3];
+    size_t total = 0;
 
-    if (name == NULL || strlen(name) == 0) {
-        snprintf(buffer, sizeof(buffer), "Goodbye, stranger!");
-    } else {
-        snprintf(buffer, sizeof(buffer), "Goodbye, %s!", name);
+    greeting_iov(iov, prefix, prefix_len, name, name_len, suffix, sizeof(suffix) - 1);
+    int rc = greeting_writev_all(fd, iov, 3, &total);
+    if (written != NULL) {
+        *written = total;
     }
+    return rc;
+}
+
+// iovecs per writev() call: IOV_MAX capped to the stack array, whole greetings only
+static int greeting_iov_batch(void) {
+    static int batch;   // 0 until the first call
+    int n = __atomic_load_n(&batch, __ATOMIC_RELAXED);
+    if (n == 0) {
+        long max = sysconf(_SC_IOV_MAX);
+        if (max < 0 || max > GREETING_IOV_MAX) {
+            max = GREETING_IOV_MAX;   // no limit reported, or more than we keep
+        }
+        n = max < 3 ? 3 : (int)max / 3 * 3;
+        __atomic_store_n(&batch, n, __ATOMIC_RELAXED);
+    }
+    return n;
+}
+
+static int greeting_write_n(int fd, const char* prefix, size_t prefix_len,
+                            const char* const* names, size_t count, char sep,
+                            size_t* written) {
+    struct iovec iov[GREETING_IOV_MAX];
+    const char tail[] = { suffix[0], sep };   // suffix + separator, one iovec
+    int batch = greeting_iov_batch();
+    size_t total = 0;
+    int rc = 0;
+
+    for (size_t i = 0; i < count && rc == 0;) {
+        struct iovec* end = iov;
+        for (; i < count && end < iov + batch; i++) {
+            end = greeting_iov(end, prefix, prefix_len, names[i], GREETING_NAME_STRLEN,
+                               tail, sizeof(tail));
+        }
+        rc = greeting_writev_all(fd, iov, (int)(end - iov), &total);
+    }
+    if (written != NULL) {
+        *written = total;
+    }
+    return rc;
+}
+
+int say_hello_write(int fd, const char* name, size_t name_len, size_t* written) {
+    return greeting_write(fd, hello_prefix, sizeof(hello_prefix) - 1, name, name_len, written);
+}
+
+int say_goodbye_write(int fd, const char* name, size_t name_len, size_t* written) {
+    return greeting_write(fd, goodbye_prefix, sizeof(goodbye_prefix) - 1, name, name_len,
+                          written);
+}
+
+int say_hello_write_n(int fd, const char* const* names, size_t count, char sep,
+                      size_t* written) {
+    return greeting_write_n(fd, hello_prefix, sizeof(hello_prefix) - 1, names, count, sep,
+                            written);
+}
+
+int say_goodbye_write_n(int fd, const char* const* names, size_t count, char sep,
+                        size_t* written) {
+    return greeting_write_n(fd, goodbye_prefix, sizeof(goodbye_prefix) - 1, names, count, sep,
+                            written);
+}
+
+/*
+ * Legacy buffers: one shared static buffer per function, or one per thread
+ * and function in thread-local mode. TLS buffers live in the thread's
+ * static TLS block, so switching modes never allocates or locks.
+ */
+#ifdef GREETING_THREAD_LOCAL
+static int greeting_tls_mode = 1;
+#else
+static int greeting_tls_mode = 0;
+#endif
+
+void greeting_set_thread_local(int enable) {
+    __atomic_store_n(&greeting_tls_mode, enable != 0, __ATOMIC_RELAXED);
+}
+
+int greeting_thread_local_enabled(void) {
+    return __atomic_load_n(&greeting_tls_mode, __ATOMIC_RELAXED);
+}
+
+const char* say_hello(const char* name) {
+    static char buffer[GREETING_BUFFER_SIZE];
+    static __thread char tls_buffer[GREETING_BUFFER_SIZE];
+    char* out = greeting_thread_local_enabled() ? tls_buffer : buffer;
+
+    say_hello_r(name, GREETING_NAME_STRLEN, out, GREETING_BUFFER_SIZE);
+    return out;
+}
+
+const char* say_goodbye(const char* name) {
+    static char buffer[GREETING_BUFFER_SIZE];
+    static __thread char tls_buffer[GREETING_BUFFER_SIZE];
+    char* out = greeting_thread_local_enabled() ? tls_buffer : buffer;
 
-    return buffer;
+    say_goodbye_r(name, GREETING_NAME_STRLEN, out, GREETING_BUFFER_SIZE);
+    return out;
 }
@@ -0,0 +1,82 @@
+#ifndef __MULTI_CALC_EXPR_INTERNAL_H__
+#define __MULTI_CALC_EXPR_INTERNAL_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "multi-calc-expr.h"
+
+/*
+ * Bytecode layout shared by the formula interpreter and its back ends
+ *
+ * Registers are numbered inputs first, then constants, then outputs, then
+ * temporaries. Instructions are "dst = a op b" over registers, in
+ * dependency order; every output register is written exactly once.
+ */
+
+enum expr_op {
+    EXPR_OP_ADD,
+    EXPR_OP_SUB,
+    EXPR_OP_MUL,
+    EXPR_OP_DIV,
+    EXPR_OP_COPY,       /* dst = a */
+};
+
+typedef struct {
+    uint8_t op;
+    uint8_t reserved;
+    uint16_t dst;
+    uint16_t a;
+    uint16_t b;
+} expr_insn_t;
+
+struct multi_calc_expr {
+    size_t ninputs;
+    size_t nconsts;
+    size_t noutputs;
+    size_t ntemps;
+    size_t nregs;
+    int *consts;
+    expr_insn_t *insns;
+    size_t ninsns;
+    size_t source_ops;  /* arithmetic ops in the source formulas */
+};
+
+static inline size_t expr_const_reg(const struct multi_calc_expr *expr, size_t i) {
+    return expr->ninputs + i;
+}
+
+static inline size_t expr_output_reg(const struct multi_calc_expr *expr, size_t i) {
+    return expr->ninputs + expr->nconsts + i;
+}
+
+static inline size_t expr_temp_base(const struct multi_calc_expr *expr) {
+    return expr->ninputs + expr->nconsts + expr->noutputs;
+}
+
+/**
+ * Scalar semantics of one op (wrapping, divide by 0 returns 0)
+ */
+int expr_apply(int op, int a, int b);
+
+/**
+ * Compile several formulas into one program with shared subexpressions;
+ * output i is formulas[i]
+ * @param error_index If not NULL, receives the index of the failing formula
+ */
+struct multi_calc_expr *expr_compile_many(const char *const *formulas, size_t nformulas,
+                                          const char *const *names, size_t ninputs,
+                                          size_t *error_index, size_t *error_pos);
+
+/**
+ * Rows per evaluation tile: MULTI_CALC_EXPR_BLOCK, or fewer when one tile
+ * of every register wouldn't fit in MULTI_CALC_EXPR_TILE_BYTES
+ */
+size_t expr_tile_rows(const struct multi_calc_expr *expr);
+
+/**
+ * Evaluate a compiled program over n rows, writing outputs[i] for output i
+ */
+int expr_eval_many_n(const struct multi_calc_expr *expr, const int *const *inputs,
+                     int *const *outputs, size_t n);
+
+#endif /* __MULTI_CALC_EXPR_INTERNAL_H__ */
@@ -0,0 +1,645 @@
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include "calc.h"
+#include "multi-calc-expr.h"
+#include "multi-calc-expr-internal.h"
+
+/*============================================================================
+ * Scalar semantics (same as the calc batch kernels)
+ *===========================================================================*/
+
+int expr_apply(int op, int a, int b) {
+    switch (op) {
+    case EXPR_OP_ADD:
+        return (int)((uint32_t)a + (uint32_t)b);
+    case EXPR_OP_SUB:
+        return (int)((uint32_t)a - (uint32_t)b);
+    case EXPR_OP_MUL:
+        return (int)((uint32_t)a * (uint32_t)b);
+    case EXPR_OP_DIV:
+        if (b == 0) {
+            return 0;
+        }
+        if (b == -1) {
+            return (int)(0u - (uint32_t)a);  // INT_MIN / -1 wraps to INT_MIN
+        }
+        return a / b;
+    default:
+        return a;  // EXPR_OP_COPY
+    }
+}
+
+/*============================================================================
+ * Expression graph
+ *
+ * The parser builds a node table in dependency order. Nodes are hash-consed:
+ * an open-addressing index keyed on (kind, value, a, b) maps a node to its
+ * slot, so asking for a node that already exists returns the existing one
+ * in O(1) and repeated subterms (also across formulas) become one node.
+ *===========================================================================*/
+
+#define EXPR_NONE UINT32_MAX
+
+enum {
+    NODE_INPUT = 16,    /* value = input index */
+    NODE_CONST = 17,    /* value = constant */
+};
+
+typedef struct {
+    int kind;           /* enum expr_op or NODE_INPUT / NODE_CONST */
+    int value;
+    uint32_t a;
+    uint32_t b;
+} expr_node_t;
+
+struct expr_builder {
+    expr_node_t *nodes;
+    size_t nnodes;
+    size_t cap;
+    uint32_t *index;    /* node numbers, EXPR_NONE when empty */
+    size_t index_mask;  /* index slots - 1, at most half full */
+    const char *const *names;
+    size_t ninputs;
+    size_t source_ops;
+    const char *src;    /* formula being parsed */
+    const char *p;      /* parse position */
+    size_t depth;       /* nested unary / primary levels */
+};
+
+static size_t node_hash(int kind, int value, uint32_t x, uint32_t y) {
+    uint64_t h = ((uint64_t)(uint32_t)kind << 32 | (uint32_t)value) * 0x9E3779B97F4A7C15ull;
+    h ^= ((uint64_t)x << 32 | y) + (h >> 29);
+    h *= 0xBF58476D1CE4E5B9ull;
+    return (size_t)(h ^ (h >> 32));
+}
+
+static int builder_grow_index(struct expr_builder *b) {
+    size_t slots = b->index ? (b->index_mask + 1) * 2 : 64;
+    uint32_t *index = malloc(slots * sizeof(uint32_t));
+    if (index == NULL) {
+        return -1;
+    }
+    memset(index, 0xff, slots * sizeof(uint32_t));  // all EXPR_NONE
+    for (size_t i = 0; i < b->nnodes; i++) {
+        const expr_node_t *n = &b->nodes[i];
+        size_t h = node_hash(n->kind, n->value, n->a, n->b) & (slots - 1);
+        while (index[h] != EXPR_NONE) {
+            h = (h + 1) & (slots - 1);
+        }
+        index[h] = (uint32_t)i;
+    }
+    free(b->index);
+    b->index = index;
+    b->index_mask = slots - 1;
+    return 0;
+}
+
+static uint32_t builder_node(struct expr_builder *b, int kind, int value, uint32_t x, uint32_t y) {
+    if (x == EXPR_NONE || y == EXPR_NONE) {
+        return EXPR_NONE;
+    }
+    // Commutative ops get a canonical operand order so a + b == b + a
+    if ((kind == EXPR_OP_ADD || kind == EXPR_OP_MUL) && x > y) {
+        uint32_t t = x;
+        x = y;
+        y = t;
+    }
+    if ((b->nnodes + 1) * 2 > (b->index ? b->index_mask + 1 : 0) && builder_grow_index(b) != 0) {
+        return EXPR_NONE;
+    }
+    size_t h = node_hash(kind, value, x, y) & b->index_mask;
+    for (; b->index[h] != EXPR_NONE; h = (h + 1) & b->index_mask) {
+        const expr_node_t *n = &b->nodes[b->index[h]];
+        if (n->kind == kind && n->value == value && n->a == x && n->b == y) {
+            return b->index[h];
+        }
+    }
+
+    if (b->nnodes == b->cap) {
+        size_t cap = b->cap ? b->cap * 2 : 32;
+        expr_node_t *nodes = cap < EXPR_NONE ? realloc(b->nodes, cap * sizeof(*nodes)) : NULL;
+        if (nodes == NULL) {
+            return EXPR_NONE;  // b->nodes is still valid and freed by the caller
+        }
+        b->nodes = nodes;
+        b->cap = cap;
+    }
+    b->nodes[b->nnodes] = (expr_node_t){ kind, value, x, y };
+    b->index[h] = (uint32_t)b->nnodes;
+    return (uint32_t)b->nnodes++;
+}
+
+static uint32_t builder_leaf(struct expr_builder *b, int kind, int value) {
+    return builder_node(b, kind, value, 0, 0);
+}
+
+static uint32_t builder_op(struct expr_builder *b, int op, uint32_t x, uint32_t y) {
+    if (x == EXPR_NONE || y == EXPR_NONE) {
+        return EXPR_NONE;
+    }
+    // Fold constant subterms
+    if (b->nodes[x].kind == NODE_CONST && b->nodes[y].kind == NODE_CONST) {
+        return builder_leaf(b, NODE_CONST, expr_apply(op, b->nodes[x].value, b->nodes[y].value));
+    }
+    return builder_node(b, op, 0, x, y);
+}
+
+/*============================================================================
+ * Parser (recursive descent, see the grammar in multi-calc-expr.h)
+ *
+ * On error the parse position is left at the offending character and
+ * EXPR_NONE is returned up the call chain. Every level of parentheses,
+ * function call or sign goes through parse_unary, which bounds the
+ * recursion at MULTI_CALC_EXPR_MAX_DEPTH so hostile input can't overflow
+ * the stack.
+ *===========================================================================*/
+
+static uint32_t parse_expr(struct expr_builder *b);
+static uint32_t parse_unary(struct expr_builder *b);
+
+static void skip_space(struct expr_builder *b) {
+    while (isspace((unsigned char)*b->p)) {
+        b->p++;
+    }
+}
+
+static int expect_char(struct expr_builder *b, char c) {
+    skip_space(b);
+    if (*b->p != c) {
+        return 0;
+    }
+    b->p++;
+    return 1;
+}
+
+static int is_name_char(char c) {
+    return isalnum((unsigned char)c) || c == '_';
+}
+
+static int func_op(const char *name, size_t len) {
+    static const struct {
+        const char *name;
+        int op;
+    } funcs[] = {
+        { "add", EXPR_OP_ADD }, { "subtract", EXPR_OP_SUB },
+        { "multiply", EXPR_OP_MUL }, { "divide", EXPR_OP_DIV },
+    };
+    if (len > 5 && strncmp(name, "calc_", 5) == 0) {
+        name += 5;
+        len -= 5;
+    }
+    for (size_t i = 0; i < sizeof(funcs) / sizeof(funcs[0]); i++) {
+        if (strlen(funcs[i].name) == len && strncmp(funcs[i].name, name, len) == 0) {
+            return funcs[i].op;
+        }
+    }
+    return -1;
+}
+
+static uint32_t parse_number(struct expr_builder *b) {
+    uint64_t v = 0;
+    const char *start = b->p;
+    while (isdigit((unsigned char)*b->p)) {
+        v = v * 10 + (uint64_t)(*b->p - '0');
+        if (v > UINT32_MAX) {
+            b->p = start;
+            return EXPR_NONE;
+        }
+        b->p++;
+    }
+    // Literals up to 2^32 - 1 wrap, so -2147483648 is INT_MIN
+    return builder_leaf(b, NODE_CONST, (int)(uint32_t)v);
+}
+
+static uint32_t parse_name(struct expr_builder *b) {
+    const char *start = b->p;
+    while (is_name_char(*b->p)) {
+        b->p++;
+    }
+    size_t len = (size_t)(b->p - start);
+
+    skip_space(b);
+    if (*b->p == '(') {
+        int op = func_op(start, len);
+        if (op < 0) {
+            b->p = start;
+            return EXPR_NONE;
+        }
+        b->p++;
+        uint32_t x = parse_expr(b);
+        if (x == EXPR_NONE || !expect_char(b, ',')) {
+            return EXPR_NONE;
+        }
+        uint32_t y = parse_expr(b);
+        if (y == EXPR_NONE || !expect_char(b, ')')) {
+            return EXPR_NONE;
+        }
+        b->source_ops++;
+        return builder_op(b, op, x, y);
+    }
+
+    for (size_t i = 0; i < b->ninputs; i++) {
+        if (strlen(b->names[i]) == len && strncmp(b->names[i], start, len) == 0) {
+            return builder_leaf(b, NODE_INPUT, (int)i);
+        }
+    }
+    b->p = start;  // unknown name
+    return EXPR_NONE;
+}
+
+static uint32_t parse_primary(struct expr_builder *b) {
+    skip_space(b);
+    if (isdigit((unsigned char)*b->p)) {
+        return parse_number(b);
+    }
+    if (isalpha((unsigned char)*b->p) || *b->p == '_') {
+        return parse_name(b);
+    }
+    if (*b->p == '(') {
+        b->p++;
+        uint32_t x = parse_expr(b);
+        if (x == EXPR_NONE || !expect_char(b, ')')) {
+            return EXPR_NONE;
+        }
+        return x;
+    }
+    return EXPR_NONE;
+}
+
+static uint32_t parse_unary_nested(struct expr_builder *b) {
+    if (*b->p == '-') {
+        b->p++;
+        uint32_t x = parse_unary(b);
+        if (x == EXPR_NONE) {
+            return EXPR_NONE;
+        }
+        b->source_ops++;
+        return builder_op(b, EXPR_OP_SUB, builder_leaf(b, NODE_CONST, 0), x);
+    }
+    if (*b->p == '+') {
+        b->p++;
+        return parse_unary(b);
+    }
+    return parse_primary(b);
+}
+
+static uint32_t parse_unary(struct expr_builder *b) {
+    skip_space(b);
+    if (b->depth == MULTI_CALC_EXPR_MAX_DEPTH) {
+        return EXPR_NONE;  // too deep, error at this character
+    }
+    b->depth++;
+    uint32_t x = parse_unary_nested(b);
+    b->depth--;
+    return x;
+}
+
+static uint32_t parse_term(struct expr_builder *b) {
+    uint32_t x = parse_unary(b);
+    for (;;) {
+        skip_space(b);
+        if (x == EXPR_NONE || (*b->p != '*' && *b->p != '/')) {
+            return x;
+        }
+        int op = *b->p == '*' ? EXPR_OP_MUL : EXPR_OP_DIV;
+        b->p++;
+        b->source_ops++;
+        x = builder_op(b, op, x, parse_unary(b));
+    }
+}
+
+static uint32_t parse_expr(struct expr_builder *b) {
+    uint32_t x = parse_term(b);
+    for (;;) {
+        skip_space(b);
+        if (x == EXPR_NONE || (*b->p != '+' && *b->p != '-')) {
+            return x;
+        }
+        int op = *b->p == '+' ? EXPR_OP_ADD : EXPR_OP_SUB;
+        b->p++;
+        b->source_ops++;
+        x = builder_op(b, op, x, parse_term(b));
+    }
+}
+
+static uint32_t parse_formula(struct expr_builder *b, const char *formula) {
+    b->src = formula;
+    b->p = formula;
+    uint32_t root = parse_expr(b);
+    skip_space(b);
+    return (root != EXPR_NONE && *b->p == '\0') ? root : EXPR_NONE;
+}
+
+/*============================================================================
+ * Code generation
+ *
+ * Live op nodes are emitted in node (dependency) order. An op node that is
+ * a formula result computes straight into its output register; any other
+ * op node gets a temporary, which is released after its last use so the
+ * scratch set stays small.
+ *===========================================================================*/
+
+static struct multi_calc_expr *builder_codegen(const struct expr_builder *b,
+                                               const uint32_t *roots, size_t nroots) {
+    size_t nnodes = b->nnodes;
+    uint8_t *live = calloc(nnodes ? nnodes : 1, 1);
+    uint32_t *reg = malloc((nnodes ? nnodes : 1) * sizeof(uint32_t));
+    uint32_t *last_use = malloc((nnodes ? nnodes : 1) * sizeof(uint32_t));
+    uint32_t *out_of = malloc((nnodes ? nnodes : 1) * sizeof(uint32_t));
+    uint32_t *free_temps = malloc((nnodes ? nnodes : 1) * sizeof(uint32_t));
+    struct multi_calc_expr *expr = calloc(1, sizeof(*expr));
+    if (!live || !reg || !last_use || !out_of || !free_temps || !expr) {
+        goto fail;
+    }
+
+    for (size_t k = 0; k < nroots; k++) {
+        live[roots[k]] = 1;
+    }
+    size_t nops = 0;
+    for (size_t i = nnodes; i-- > 0;) {
+        if (live[i] && b->nodes[i].kind < NODE_INPUT) {
+            live[b->nodes[i].a] = 1;
+            live[b->nodes[i].b] = 1;
+            nops++;
+        }
+    }
+
+    // Register numbering: inputs, constants, outputs, temporaries
+    expr->ninputs = b->ninputs;
+    expr->noutputs = nroots;
+    expr->source_ops = b->source_ops;
+    for (size_t i = 0; i < nnodes; i++) {
+        expr->nconsts += live[i] && b->nodes[i].kind == NODE_CONST;
+    }
+    expr->consts = malloc((expr->nconsts ? expr->nconsts : 1) * sizeof(int));
+    expr->insns = malloc((nops + nroots) * sizeof(expr_insn_t));
+    if (expr->consts == NULL || expr->insns == NULL) {
+        goto fail;
+    }
+
+    size_t nconsts = 0;
+    for (size_t i = 0; i < nnodes; i++) {
+        out_of[i] = EXPR_NONE;
+        last_use[i] = EXPR_NONE;
+        if (!live[i]) {
+            continue;
+        }
+        const expr_node_t *n = &b->nodes[i];
+        if (n->kind == NODE_INPUT) {
+            reg[i] = (uint32_t)n->value;
+        } else if (n->kind == NODE_CONST) {
+            expr->consts[nconsts] = n->value;
+            reg[i] = (uint32_t)expr_const_reg(expr, nconsts++);
+        } else {
+            last_use[n->a] = (uint32_t)i;
+            last_use[n->b] = (uint32_t)i;
+        }
+    }
+    for (size_t k = nroots; k-- > 0;) {
+        out_of[roots[k]] = (uint32_t)k;  // first output wins
+    }
+
+    size_t temp_base = expr_temp_base(expr);
+    size_t nfree = 0;
+    for (size_t i = 0; i < nnodes; i++) {
+        const expr_node_t *n = &b->nodes[i];
+        if (!live[i] || n->kind >= NODE_INPUT) {
+            continue;
+        }
+        // Release operand temporaries first, dst may reuse one of them
+        uint32_t operands[2] = { n->a, n->b };
+        for (int k = 0; k < (n->a == n->b ? 1 : 2); k++) {
+            uint32_t x = operands[k];
+            if (last_use[x] == i && out_of[x] == EXPR_NONE && b->nodes[x].kind < NODE_INPUT) {
+                free_temps[nfree++] = reg[x];
+            }
+        }
+
+        if (out_of[i] != EXPR_NONE) {
+            reg[i] = (uint32_t)expr_output_reg(expr, out_of[i]);
+        } else if (nfree > 0) {
+            reg[i] = free_temps[--nfree];
+        } else {
+            reg[i] = (uint32_t)(temp_base + expr->ntemps++);
+        }
+        expr->insns[expr->ninsns++] = (expr_insn_t){
+            (uint8_t)n->kind, 0, (uint16_t)reg[i], (uint16_t)reg[n->a], (uint16_t)reg[n->b]
+        };
+    }
+
+    // Results that are leaves or duplicates of an earlier output
+    for (size_t k = 0; k < nroots; k++) {
+        uint32_t root = roots[k];
+        if (out_of[root] != k || b->nodes[root].kind >= NODE_INPUT) {
+            uint16_t dst = (uint16_t)expr_output_reg(expr, k);
+            expr->insns[expr->ninsns++] = (expr_insn_t){ EXPR_OP_COPY, 0, dst, (uint16_t)reg[root], 0 };
+        }
+    }
+
+    expr->nregs = temp_base + expr->ntemps;
+    if (expr->nregs > UINT16_MAX) {
+        goto fail;
+    }
+
+    free(live);
+    free(reg);
+    free(last_use);
+    free(out_of);
+    free(free_temps);
+    return expr;
+
+fail:
+    free(live);
+    free(reg);
+    free(last_use);
+    free(out_of);
+    free(free_temps);
+    multi_calc_expr_free(expr);
+    return NULL;
+}
+
+struct multi_calc_expr *expr_compile_many(const char *const *formulas, size_t nformulas,
+                                          const char *const *names, size_t ninputs,
+                                          size_t *error_index, size_t *error_pos) {
+    struct expr_builder b = { 0 };
+    b.names = names;
+    b.ninputs = ninputs;
+    struct multi_calc_expr *expr = NULL;
+
+    uint32_t *roots = malloc((nformulas ? nformulas : 1) * sizeof(uint32_t));
+    if (roots == NULL) {
+        return NULL;
+    }
+    for (size_t k = 0; k < nformulas; k++) {
+        roots[k] = parse_formula(&b, formulas[k]);
+        if (roots[k] == EXPR_NONE) {
+            if (error_index != NULL) {
+                *error_index = k;
+            }
+            if (error_pos != NULL) {
+                *error_pos = (size_t)(b.p - b.src);
+            }
+            goto out;
+        }
+    }
+    expr = builder_codegen(&b, roots, nformulas);
+
+out:
+    free(roots);
+    free(b.nodes);
+    free(b.index);
+    return expr;
+}
+
+/*============================================================================
+ * Interpreter
+ *===========================================================================*/
+
+size_t expr_tile_rows(const struct multi_calc_expr *expr) {
+    // Keep one tile of every register (inputs, outputs and scratch) in cache
+    size_t rows = MULTI_CALC_EXPR_TILE_BYTES / (expr->nregs * sizeof(int) + 1);
+    rows &= ~(size_t)63;
+    if (rows < 64) {
+        return 64;
+    }
+    return rows < MULTI_CALC_EXPR_BLOCK ? rows : MULTI_CALC_EXPR_BLOCK;
+}
+
+int expr_eval_many_n(const struct multi_calc_expr *expr, const int *const *inputs,
+                     int *const *outputs, size_t n) {
+    size_t tile = expr_tile_rows(expr);
+    size_t block = n < tile ? n : tile;
+    size_t scratch_regs = expr->nconsts + expr->ntemps;
+    int *scratch = malloc((scratch_regs * block + 1) * sizeof(int));
+    int **reg = malloc(expr->nregs * sizeof(int *));
+    if (scratch == NULL || reg == NULL) {
+        free(scratch);
+        free(reg);
+        return -1;
+    }
+
+    // Constant blocks are filled once, temporaries are reused for every block
+    for (size_t i = 0; i < expr->nconsts; i++) {
+        int *c = scratch + i * block;
+        reg[expr_const_reg(expr, i)] = c;
+        for (size_t j = 0; j < block; j++) {
+            c[j] = expr->consts[i];
+        }
+    }
+    for (size_t i = 0; i < expr->ntemps; i++) {
+        reg[expr_temp_base(expr) + i] = scratch + (expr->nconsts + i) * block;
+    }
+
+    for (size_t base = 0; base < n; base += block) {
+        size_t len = n - base < block ? n - base : block;
+        for (size_t i = 0; i < expr->ninputs; i++) {
+            reg[i] = (int *)(inputs[i] + base);  // inputs are only read
+        }
+        for (size_t k = 0; k < expr->noutputs; k++) {
+            reg[expr_output_reg(expr, k)] = outputs[k] + base;
+        }
+
+        // One dispatch per instruction per block
+        for (size_t i = 0; i < expr->ninsns; i++) {
+            const expr_insn_t *insn = &expr->insns[i];
+            const int *a = reg[insn->a];
+            const int *b = reg[insn->b];
+            int *dst = reg[insn->dst];
+            switch (insn->op) {
+            case EXPR_OP_ADD:
+                calc_add_n(a, b, dst, len);
+                break;
+            case EXPR_OP_SUB:
+                calc_subtract_n(a, b, dst, len);
+                break;
+            case EXPR_OP_MUL:
+                calc_multiply_n(a, b, dst, len);
+                break;
+            case EXPR_OP_DIV:
+                calc_divide_n(a, b, dst, len);
+                break;
+            default:
+                memmove(dst, a, len * sizeof(int));
+                break;
+            }
+        }
+    }
+
+    free(scratch);
+    free(reg);
+    return 0;
+}
+
+/*============================================================================
+ * Public API
+ *===========================================================================*/
+
+multi_calc_expr_t *multi_calc_expr_compile(const char *formula, const char *const *names,
+                                           size_t ninputs, size_t *error_pos) {
+    return expr_compile_many(&formula, 1, names, ninputs, NULL, error_pos);
+}
+
+void multi_calc_expr_free(multi_calc_expr_t *expr) {
+    if (expr == NULL) {
+        return;
+    }
+    free(expr->consts);
+    free(expr->insns);
+    free(expr);
+}
+
+int multi_calc_expr_eval(const multi_calc_expr_t *expr, const int *values) {
+    int small[64];
+    int *reg = expr->nregs <= 64 ? small : malloc(expr->nregs * sizeof(int));
+    if (reg == NULL) {
+        return 0;
+    }
+
+    memcpy(reg, values, expr->ninputs * sizeof(int));
+    memcpy(reg + expr->ninputs, expr->consts, expr->nconsts * sizeof(int));
+    for (size_t i = 0; i < expr->ninsns; i++) {
+        const expr_insn_t *insn = &expr->insns[i];
+        reg[insn->dst] = expr_apply(insn->op, reg[insn->a], reg[insn->b]);
+    }
+    int result = reg[expr_output_reg(expr, 0)];
+
+    if (reg != small) {
+        free(reg);
+    }
+    return result;
+}
+
+int multi_calc_expr_eval_n(const multi_calc_expr_t *expr, const int *const *inputs,
+                           int *out, size_t n) {
+    if (expr->noutputs != 1) {
+        return -1;
+    }
+    return expr_eval_many_n(expr, inputs, &out, n);
+}
+
+multi_calc_expr_t *multi_calc_expr_compile_set(const char *const *formulas, size_t nformulas,
+                                               const char *const *names, size_t ninputs,
+                                               size_t *error_index, size_t *error_pos) {
+    if (nformulas == 0) {
+        return NULL;
+    }
+    return expr_compile_many(formulas, nformulas, names, ninputs, error_index, error_pos);
+}
+
+int multi_calc_expr_eval_set_n(const multi_calc_expr_t *expr, const int *const *inputs,
+                               int *const *outputs, size_t n) {
+    return expr_eval_many_n(expr, inputs, outputs, n);
+}
+
+void multi_calc_expr_get_stats(const multi_calc_expr_t *expr, multi_calc_expr_stats_t *stats) {
+    size_t ops = 0;
+    for (size_t i = 0; i < expr->ninsns; i++) {
+        ops += expr->insns[i].op != EXPR_OP_COPY;
+    }
+    stats->formulas = expr->noutputs;
+    stats->source_ops = expr->source_ops;
+    stats->ops = ops;
+    stats->ops_eliminated = expr->source_ops - ops;
+    stats->tile_rows = expr_tile_rows(expr);
+}
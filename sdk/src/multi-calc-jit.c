@@ -0,0 +1,437 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "calc.h"
+#include "calc-isa-internal.h"
+#include "multi-calc-jit.h"
+#include "multi-calc-expr-internal.h"
+
+#ifdef CALC_X86_64
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Generated code signature: rows [0, n) with n a multiple of 8, slots
+ * holds one 32-byte vector per const / temp register (consts pre-filled)
+ */
+typedef void (*jit_fn)(const int *const *inputs, int *const *outputs, size_t n, void *slots);
+
+struct multi_calc_jit {
+    int refcount;
+    struct multi_calc_expr *expr;
+    jit_fn native;          /* NULL = interpreter */
+    void *code;
+    size_t code_size;
+    char *key;
+    size_t key_len;
+    uint64_t hash;
+    struct multi_calc_jit *next;
+};
+
+/*============================================================================
+ * x86-64 AVX2 code generator
+ *
+ * Register use (all caller-saved in the SysV ABI):
+ *   rdi = inputs, rsi = outputs, rcx = slots, rdx = row byte offset,
+ *   r8 = end byte offset, rax = scratch pointer, ymm0-ymm5 = values
+ * Every bytecode register lives in memory (an input / output array or a
+ * slot), so an instruction is load, load, op, store.
+ *===========================================================================*/
+
+#ifdef CALC_X86_64
+
+#define JIT_MAX_INSN_BYTES 160  /* upper bound for one bytecode instruction */
+
+typedef struct {
+    uint8_t *p;
+    const struct multi_calc_expr *expr;
+} jit_buf_t;
+
+static void emit(jit_buf_t *b, const uint8_t *bytes, size_t n) {
+    memcpy(b->p, bytes, n);
+    b->p += n;
+}
+
+static void emit8(jit_buf_t *b, uint8_t v) {
+    *b->p++ = v;
+}
+
+static void emit32(jit_buf_t *b, uint32_t v) {
+    memcpy(b->p, &v, 4);
+    b->p += 4;
+}
+
+/*
+ * VEX prefix for 256-bit ops on ymm0-ymm7 / legacy base registers.
+ * map: 1 = 0F, 2 = 0F38, 3 = 0F3A; pp: 0 = none, 1 = 66, 2 = F3
+ */
+static void emit_vex(jit_buf_t *b, int map, int pp, int vvvv, uint8_t opcode) {
+    uint8_t tail = (uint8_t)(((~vvvv & 0xF) << 3) | 0x04 | pp);
+    if (map == 1) {
+        emit8(b, 0xC5);
+        emit8(b, (uint8_t)(0x80 | tail));
+    } else {
+        emit8(b, 0xC4);
+        emit8(b, (uint8_t)(0xE0 | map));
+        emit8(b, tail);  // W = 0
+    }
+    emit8(b, opcode);
+}
+
+// op ymm(reg), ymm(vvvv), ymm(rm)
+static void emit_vex_rr(jit_buf_t *b, int map, int pp, uint8_t opcode, int reg, int vvvv, int rm) {
+    emit_vex(b, map, pp, vvvv, opcode);
+    emit8(b, (uint8_t)(0xC0 | (reg << 3) | rm));
+}
+
+// Address of bytecode register r for the current rows, as a ModRM tail
+static void emit_operand(jit_buf_t *b, int ymm, size_t r) {
+    const struct multi_calc_expr *expr = b->expr;
+    size_t out_base = expr_output_reg(expr, 0);
+    if (r < expr->ninputs || (r >= out_base && r < out_base + expr->noutputs)) {
+        emit8(b, (uint8_t)((ymm << 3) | 0x04));  // [rax + rdx]
+        emit8(b, 0x10);
+    } else {
+        emit8(b, (uint8_t)(0x80 | (ymm << 3) | 0x01));  // [rcx + disp32]
+        emit32(b, (uint32_t)(r * 32));
+    }
+}
+
+// mov rax, [rdi / rsi + 8 * k] when r is an input / output register
+static void emit_array_pointer(jit_buf_t *b, size_t r) {
+    const struct multi_calc_expr *expr = b->expr;
+    size_t out_base = expr_output_reg(expr, 0);
+    if (r < expr->ninputs) {
+        emit(b, (const uint8_t[]){ 0x48, 0x8B, 0x87 }, 3);
+        emit32(b, (uint32_t)(r * 8));
+    } else if (r >= out_base && r < out_base + expr->noutputs) {
+        emit(b, (const uint8_t[]){ 0x48, 0x8B, 0x86 }, 3);
+        emit32(b, (uint32_t)((r - out_base) * 8));
+    }
+}
+
+static void emit_load(jit_buf_t *b, int ymm, size_t r) {
+    emit_array_pointer(b, r);
+    emit_vex(b, 1, 2, 0, 0x6F);  // vmovdqu ymm, m256
+    emit_operand(b, ymm, r);
+}
+
+static void emit_store(jit_buf_t *b, int ymm, size_t r) {
+    emit_array_pointer(b, r);
+    emit_vex(b, 1, 2, 0, 0x7F);  // vmovdqu m256, ymm
+    emit_operand(b, ymm, r);
+}
+
+/*
+ * ymm0 = ymm0 / ymm1 with the calc semantics. Like the batch kernels,
+ * each half goes through double: int32 quotients are exact there, and
+ * INT_MIN / -1 converts back to INT_MIN. Zero divisors are masked to 0.
+ */
+static void emit_divide(jit_buf_t *b) {
+    emit_vex_rr(b, 1, 2, 0xE6, 2, 0, 0);            // vcvtdq2pd ymm2, xmm0
+    emit_vex_rr(b, 1, 2, 0xE6, 3, 0, 1);            // vcvtdq2pd ymm3, xmm1
+    emit_vex_rr(b, 1, 1, 0x5E, 2, 2, 3);            // vdivpd ymm2, ymm2, ymm3
+    emit_vex_rr(b, 1, 1, 0xE6, 2, 0, 2);            // vcvttpd2dq xmm2, ymm2
+    emit_vex_rr(b, 3, 1, 0x39, 0, 0, 4);            // vextracti128 xmm4, ymm0, 1
+    emit8(b, 1);
+    emit_vex_rr(b, 3, 1, 0x39, 1, 0, 5);            // vextracti128 xmm5, ymm1, 1
+    emit8(b, 1);
+    emit_vex_rr(b, 1, 2, 0xE6, 4, 0, 4);            // vcvtdq2pd ymm4, xmm4
+    emit_vex_rr(b, 1, 2, 0xE6, 5, 0, 5);            // vcvtdq2pd ymm5, xmm5
+    emit_vex_rr(b, 1, 1, 0x5E, 4, 4, 5);            // vdivpd ymm4, ymm4, ymm5
+    emit_vex_rr(b, 1, 1, 0xE6, 4, 0, 4);            // vcvttpd2dq xmm4, ymm4
+    emit_vex_rr(b, 3, 1, 0x38, 2, 2, 4);            // vinserti128 ymm2, ymm2, xmm4, 1
+    emit8(b, 1);
+    emit_vex_rr(b, 1, 1, 0xEF, 3, 3, 3);            // vpxor ymm3, ymm3, ymm3
+    emit_vex_rr(b, 1, 1, 0x76, 3, 1, 3);            // vpcmpeqd ymm3, ymm1, ymm3
+    emit_vex_rr(b, 1, 1, 0xDF, 0, 3, 2);            // vpandn ymm0, ymm3, ymm2
+}
+
+static size_t jit_code_bound(const struct multi_calc_expr *expr) {
+    return 64 + expr->ninsns * JIT_MAX_INSN_BYTES;
+}
+
+static void jit_generate(jit_buf_t *b) {
+    const struct multi_calc_expr *expr = b->expr;
+
+    emit(b, (const uint8_t[]){ 0x49, 0x89, 0xD0 }, 3);        // mov r8, rdx
+    emit(b, (const uint8_t[]){ 0x49, 0xC1, 0xE0, 0x02 }, 4);  // shl r8, 2
+    emit(b, (const uint8_t[]){ 0x31, 0xD2 }, 2);              // xor edx, edx
+
+    uint8_t *loop = b->p;
+    emit(b, (const uint8_t[]){ 0x4C, 0x39, 0xC2 }, 3);        // cmp rdx, r8
+    emit(b, (const uint8_t[]){ 0x0F, 0x83 }, 2);              // jae done
+    uint8_t *exit_rel = b->p;
+    emit32(b, 0);
+
+    for (size_t i = 0; i < expr->ninsns; i++) {
+        const expr_insn_t *insn = &expr->insns[i];
+        emit_load(b, 0, insn->a);
+        if (insn->op != EXPR_OP_COPY) {
+            emit_load(b, 1, insn->b);
+        }
+        switch (insn->op) {
+        case EXPR_OP_ADD:
+            emit_vex_rr(b, 1, 1, 0xFE, 0, 0, 1);  // vpaddd ymm0, ymm0, ymm1
+            break;
+        case EXPR_OP_SUB:
+            emit_vex_rr(b, 1, 1, 0xFA, 0, 0, 1);  // vpsubd ymm0, ymm0, ymm1
+            break;
+        case EXPR_OP_MUL:
+            emit_vex_rr(b, 2, 1, 0x40, 0, 0, 1);  // vpmulld ymm0, ymm0, ymm1
+            break;
+        case EXPR_OP_DIV:
+            emit_divide(b);
+            break;
+        default:
+            break;
+        }
+        emit_store(b, 0, insn->dst);
+    }
+
+    emit(b, (const uint8_t[]){ 0x48, 0x83, 0xC2, 0x20 }, 4);  // add rdx, 32
+    emit8(b, 0xE9);                                           // jmp loop
+    emit32(b, (uint32_t)(int32_t)(loop - (b->p + 4)));
+
+    uint32_t rel = (uint32_t)(int32_t)(b->p - (exit_rel + 4));
+    memcpy(exit_rel, &rel, 4);
+    emit(b, (const uint8_t[]){ 0xC5, 0xF8, 0x77 }, 3);        // vzeroupper
+    emit8(b, 0xC3);                                           // ret
+}
+
+static int jit_compile_native(struct multi_calc_jit *jit) {
+    if (!calc_batch_use_avx2() ||
+        jit->expr->nregs * 32 > INT32_MAX) {
+        return -1;
+    }
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = (jit_code_bound(jit->expr) + page - 1) / page * page;
+    void *code = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code == MAP_FAILED) {
+        return -1;
+    }
+
+    jit_buf_t b = { code, jit->expr };
+    jit_generate(&b);
+
+    // W^X: drop write access before the code becomes executable
+    if (mprotect(code, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(code, size);
+        return -1;
+    }
+    __builtin___clear_cache((char *)code, (char *)b.p);
+
+    jit->code = code;
+    jit->code_size = size;
+    jit->native = (jit_fn)code;
+    return 0;
+}
+
+static void jit_free_native(struct multi_calc_jit *jit) {
+    if (jit->code != NULL) {
+        munmap(jit->code, jit->code_size);
+    }
+}
+
+#else
+
+static int jit_compile_native(struct multi_calc_jit *jit) {
+    (void)jit;
+    return -1;
+}
+
+static void jit_free_native(struct multi_calc_jit *jit) {
+    (void)jit;
+}
+
+#endif /* CALC_X86_64 */
+
+/*============================================================================
+ * Cache (formula text + input names -> compiled formula)
+ *===========================================================================*/
+
+#define JIT_CACHE_BUCKETS 64
+
+static struct {
+    pthread_mutex_t lock;
+    struct multi_calc_jit *buckets[JIT_CACHE_BUCKETS];
+    size_t count;
+} jit_cache = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+// Key: formula, then every input name, each NUL-terminated
+static char *jit_make_key(const char *formula, const char *const *names, size_t ninputs, size_t *len) {
+    size_t n = strlen(formula) + 1;
+    for (size_t i = 0; i < ninputs; i++) {
+        n += strlen(names[i]) + 1;
+    }
+    char *key = malloc(n);
+    if (key == NULL) {
+        return NULL;
+    }
+    char *p = key;
+    size_t l = strlen(formula) + 1;
+    memcpy(p, formula, l);
+    p += l;
+    for (size_t i = 0; i < ninputs; i++) {
+        l = strlen(names[i]) + 1;
+        memcpy(p, names[i], l);
+        p += l;
+    }
+    *len = n;
+    return key;
+}
+
+// FNV-1a
+static uint64_t jit_hash(const char *key, size_t len) {
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ (uint8_t)key[i]) * 1099511628211ULL;
+    }
+    return h;
+}
+
+static void jit_destroy(struct multi_calc_jit *jit) {
+    jit_free_native(jit);
+    multi_calc_expr_free(jit->expr);
+    free(jit->key);
+    free(jit);
+}
+
+multi_calc_jit_t *multi_calc_jit_get(const char *formula, const char *const *names,
+                                     size_t ninputs, size_t *error_pos) {
+    size_t key_len;
+    char *key = jit_make_key(formula, names, ninputs, &key_len);
+    if (key == NULL) {
+        return NULL;
+    }
+    uint64_t hash = jit_hash(key, key_len);
+    struct multi_calc_jit **bucket = &jit_cache.buckets[hash % JIT_CACHE_BUCKETS];
+
+    pthread_mutex_lock(&jit_cache.lock);
+    for (struct multi_calc_jit *jit = *bucket; jit != NULL; jit = jit->next) {
+        if (jit->hash == hash && jit->key_len == key_len && memcmp(jit->key, key, key_len) == 0) {
+            __atomic_add_fetch(&jit->refcount, 1, __ATOMIC_RELAXED);
+            pthread_mutex_unlock(&jit_cache.lock);
+            free(key);
+            return jit;
+        }
+    }
+    pthread_mutex_unlock(&jit_cache.lock);
+
+    // Compile outside the lock
+    struct multi_calc_jit *jit = calloc(1, sizeof(*jit));
+    if (jit == NULL) {
+        free(key);
+        return NULL;
+    }
+    jit->key = key;
+    jit->key_len = key_len;
+    jit->hash = hash;
+    jit->expr = multi_calc_expr_compile(formula, names, ninputs, error_pos);
+    if (jit->expr == NULL) {
+        jit_destroy(jit);
+        return NULL;
+    }
+    jit_compile_native(jit);  // interpreter fallback on failure
+    jit->refcount = 2;        // caller + cache
+
+    pthread_mutex_lock(&jit_cache.lock);
+    for (struct multi_calc_jit *other = *bucket; other != NULL; other = other->next) {
+        if (other->hash == hash && other->key_len == key_len && memcmp(other->key, key, key_len) == 0) {
+            // Another thread won the race, use its copy
+            __atomic_add_fetch(&other->refcount, 1, __ATOMIC_RELAXED);
+            pthread_mutex_unlock(&jit_cache.lock);
+            jit_destroy(jit);
+            return other;
+        }
+    }
+    jit->next = *bucket;
+    *bucket = jit;
+    jit_cache.count++;
+    pthread_mutex_unlock(&jit_cache.lock);
+    return jit;
+}
+
+void multi_calc_jit_release(multi_calc_jit_t *jit) {
+    if (jit != NULL && __atomic_sub_fetch(&jit->refcount, 1, __ATOMIC_ACQ_REL) == 0) {
+        jit_destroy(jit);
+    }
+}
+
+size_t multi_calc_jit_cache_size(void) {
+    pthread_mutex_lock(&jit_cache.lock);
+    size_t count = jit_cache.count;
+    pthread_mutex_unlock(&jit_cache.lock);
+    return count;
+}
+
+void multi_calc_jit_cache_clear(void) {
+    pthread_mutex_lock(&jit_cache.lock);
+    struct multi_calc_jit *list = NULL;
+    for (size_t i = 0; i < JIT_CACHE_BUCKETS; i++) {
+        while (jit_cache.buckets[i] != NULL) {
+            struct multi_calc_jit *jit = jit_cache.buckets[i];
+            jit_cache.buckets[i] = jit->next;
+            jit->next = list;
+            list = jit;
+        }
+    }
+    jit_cache.count = 0;
+    pthread_mutex_unlock(&jit_cache.lock);
+
+    while (list != NULL) {
+        struct multi_calc_jit *next = list->next;
+        multi_calc_jit_release(list);
+        list = next;
+    }
+}
+
+/*============================================================================
+ * Evaluation
+ *===========================================================================*/
+
+int multi_calc_jit_is_native(const multi_calc_jit_t *jit) {
+    return jit->native != NULL;
+}
+
+int multi_calc_jit_eval_n(const multi_calc_jit_t *jit, const int *const *inputs, int *out, size_t n) {
+    const struct multi_calc_expr *expr = jit->expr;
+    size_t n8 = n / 8 * 8;
+    if (jit->native == NULL || n8 == 0) {
+        return expr_eval_many_n(expr, inputs, &out, n);
+    }
+
+    // One 32-byte slot per register, consts broadcast once per call
+    int *slots = aligned_alloc(32, expr->nregs * 32);
+    if (slots == NULL) {
+        return -1;
+    }
+    for (size_t i = 0; i < expr->nconsts; i++) {
+        int *slot = slots + expr_const_reg(expr, i) * 8;
+        for (int k = 0; k < 8; k++) {
+            slot[k] = expr->consts[i];
+        }
+    }
+    int *const outputs[1] = { out };
+    jit->native(inputs, outputs, n8, slots);
+    free(slots);
+
+    if (n8 == n) {
+        return 0;
+    }
+
+    // Fewer than 8 rows left: interpret them
+    const int **tail = malloc((expr->ninputs + 1) * sizeof(*tail));
+    if (tail == NULL) {
+        return -1;
+    }
+    for (size_t i = 0; i < expr->ninputs; i++) {
+        tail[i] = inputs[i] + n8;
+    }
+    int *tail_out = out + n8;
+    int ret = expr_eval_many_n(expr, tail, &tail_out, n - n8);
+    free(tail);
+    return ret;
+}
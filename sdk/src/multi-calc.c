@@ -1,5 +1,13 @@
+#include <limits.h>
+#include <stdlib.h>
 #include "multi-calc.h"
 #include "calc.h"
+#include "calc-inline.h"  // inlines calc_xxx only when built with -DCALC_INLINE
+#include "calc-isa-internal.h"
+#include "sdk-pool.h"
+
+// Precomputed divide-by-3, same as calc_divider_init(&div, 3)
+static const calc_divider_t divide_by_3 = { 0x155555556ULL, 34, 0 };
 
 int multi_calc_expression(int a, int b, int c, int d) {
     // Calculate (a + b) * (c - d)
@@ -9,10 +17,414 @@ int multi_calc_expression(int a, int b, int c, int d) {
     return result;
 }
 
+/*============================================================================
+ * Fused expression kernels
+ *
+ * One pass over a, b, c and d with no temporaries: 4 loads and 1 store per
+ * element instead of the 9 loads and 3 stores of calc_add_n, calc_subtract_n
+ * and calc_multiply_n over intermediate arrays. Arithmetic wraps modulo
+ * 2^32 like the calc batch API.
+ *===========================================================================*/
+
+static inline int expression_lane(int a, int b, int c, int d) {
+    return (int)(((uint32_t)a + (uint32_t)b) * ((uint32_t)c - (uint32_t)d));
+}
+
+static void scalar_expression(const int *a, const int *b, const int *c, const int *d,
+                              int *out, size_t out_stride, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i * out_stride] = expression_lane(a[i], b[i], c[i], d[i]);
+    }
+}
+
+#ifdef CALC_X86
+
+__attribute__((target("avx2")))
+static void avx2_expression(const int *a, const int *b, const int *c, const int *d,
+                            int *out, size_t out_stride, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i sum = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(a + i)),
+                                       _mm256_loadu_si256((const __m256i *)(b + i)));
+        __m256i diff = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i *)(c + i)),
+                                        _mm256_loadu_si256((const __m256i *)(d + i)));
+        __m256i r = _mm256_mullo_epi32(sum, diff);
+        if (out_stride == 1) {
+            _mm256_storeu_si256((__m256i *)(out + i), r);
+        } else {
+            int lanes[8];
+            _mm256_storeu_si256((__m256i *)lanes, r);
+            for (int k = 0; k < 8; k++) {
+                out[(i + k) * out_stride] = lanes[k];
+            }
+        }
+    }
+    scalar_expression(a + i, b + i, c + i, d + i, out + i * out_stride, out_stride, n - i);
+}
+
+__attribute__((target("avx512f")))
+static void avx512_expression(const int *a, const int *b, const int *c, const int *d,
+                              int *out, size_t out_stride, size_t n) {
+    // Scatter offsets for strided output (fits int32 for any sane stride)
+    const __m512i index = _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+                                                               8, 9, 10, 11, 12, 13, 14, 15),
+                                             _mm512_set1_epi32((int)out_stride));
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i sum = _mm512_add_epi32(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+        __m512i diff = _mm512_sub_epi32(_mm512_loadu_si512(c + i), _mm512_loadu_si512(d + i));
+        __m512i r = _mm512_mullo_epi32(sum, diff);
+        if (out_stride == 1) {
+            _mm512_storeu_si512(out + i, r);
+        } else {
+            _mm512_i32scatter_epi32(out + i * out_stride, index, r, 4);
+        }
+    }
+    scalar_expression(a + i, b + i, c + i, d + i, out + i * out_stride, out_stride, n - i);
+}
+
+#endif /* CALC_X86 */
+
+void multi_calc_expression_stride(const int *a, const int *b, const int *c, const int *d,
+                                  int *out, size_t out_stride, size_t n) {
+#ifdef CALC_X86
+    // Follow the calc batch API ISA selection
+    calc_isa_t isa = calc_batch_get_isa();
+    if (isa >= CALC_ISA_AVX512 && out_stride <= INT32_MAX / 16) {
+        avx512_expression(a, b, c, d, out, out_stride, n);
+        return;
+    }
+    if (isa >= CALC_ISA_AVX2) {
+        avx2_expression(a, b, c, d, out, out_stride, n);
+        return;
+    }
+#endif
+    scalar_expression(a, b, c, d, out, out_stride, n);
+}
+
+void multi_calc_expression_n(const int *a, const int *b, const int *c, const int *d,
+                             int *out, size_t n) {
+    multi_calc_expression_stride(a, b, c, d, out, 1, n);
+}
+
+int multi_calc_expression_column(const calc_column_t *a, const calc_column_t *b,
+                                 const calc_column_t *c, const calc_column_t *d,
+                                 calc_column_t *out) {
+    size_t len = a->len;
+    if (b->len != len || c->len != len || d->len != len ||
+        (out->flags & CALC_COLUMN_READONLY) || out->capacity < len) {
+        return -1;
+    }
+    const uint8_t *valid[4] = { a->validity, b->validity, c->validity, d->validity };
+    int nullable = valid[0] || valid[1] || valid[2] || valid[3];
+    if (nullable && calc_column_add_validity(out) != 0) {
+        return -1;
+    }
+
+    multi_calc_expression_n(a->data, b->data, c->data, d->data, out->data, len);
+    out->len = len;
+
+    if (out->validity != NULL) {
+        size_t bytes = (len + 7) / 8;
+        for (size_t i = 0; i < bytes; i++) {
+            uint8_t v = 0xFF;
+            for (int k = 0; k < 4; k++) {
+                v &= valid[k] != NULL ? valid[k][i] : 0xFF;
+            }
+            out->validity[i] = v;
+        }
+        if (len % 8 != 0) {
+            out->validity[bytes - 1] &= (uint8_t)((1u << (len % 8)) - 1);
+        }
+    }
+    return 0;
+}
+
 int multi_calc_average(int a, int b, int c) {
     // Calculate (a + b + c) / 3
     int sum1 = calc_add(a, b);          // a + b
     int sum2 = calc_add(sum1, c);       // (a + b) + c
-    int result = calc_divide(sum2, 3);  // (a + b + c) / 3
+    int result = calc_divider_divide(&divide_by_3, sum2);  // (a + b + c) / 3
     return result;
-}
\ No newline at end of file
+}
+
+int multi_calc_average_n(const int *values, size_t n, unsigned max_threads) {
+    if (n == 0) {
+        return 0;
+    }
+    int64_t sum = calc_sum_reduce(values, n, max_threads);
+    return (int)(sum / (int64_t)n);
+}
+
+int multi_calc_average_column(const calc_column_t *col, unsigned max_threads) {
+    size_t valid_rows;
+    int64_t sum = calc_column_sum(col, max_threads, &valid_rows);
+    if (valid_rows == 0) {
+        return 0;
+    }
+    return (int)(sum / (int64_t)valid_rows);
+}
+
+/*============================================================================
+ * Streaming average
+ *===========================================================================*/
+
+// calc_sum_reduce is exact below 2^32 values, feed it in smaller slices
+#define AVG_PUSH_SLICE ((size_t)1 << 30)
+
+static __int128 avg_sum(const multi_calc_avg_t *acc) {
+    return (__int128)(((unsigned __int128)(uint64_t)acc->sum_hi << 64) | acc->sum_lo);
+}
+
+static void avg_add(multi_calc_avg_t *acc, __int128 value, uint64_t count) {
+    unsigned __int128 sum = (unsigned __int128)avg_sum(acc) + (unsigned __int128)value;
+    acc->sum_lo = (uint64_t)sum;
+    acc->sum_hi = (int64_t)(uint64_t)(sum >> 64);
+    acc->count += count;
+}
+
+void multi_calc_avg_init(multi_calc_avg_t *acc) {
+    acc->count = 0;
+    acc->sum_lo = 0;
+    acc->sum_hi = 0;
+}
+
+void multi_calc_avg_push(multi_calc_avg_t *acc, int value) {
+    avg_add(acc, value, 1);
+}
+
+void multi_calc_avg_push_n(multi_calc_avg_t *acc, const int *values, size_t n) {
+    while (n > 0) {
+        size_t len = n < AVG_PUSH_SLICE ? n : AVG_PUSH_SLICE;
+        avg_add(acc, calc_sum_reduce(values, len, 1), len);
+        values += len;
+        n -= len;
+    }
+}
+
+void multi_calc_avg_merge(multi_calc_avg_t *dst, const multi_calc_avg_t *src) {
+    avg_add(dst, avg_sum(src), src->count);
+}
+
+int multi_calc_avg_finalize(const multi_calc_avg_t *acc) {
+    if (acc->count == 0) {
+        return 0;
+    }
+    // Both signed, so the quotient truncates toward zero like int division
+    return (int)(avg_sum(acc) / (__int128)acc->count);
+}
+
+/*============================================================================
+ * Fused statistics
+ *
+ * Values are consumed in blocks of STATS_BLOCK ints, so memory is read
+ * once: the first sweep over a block gives its exact sum, min and max, the
+ * second one (from L1) its sum of squared deviations from the block mean.
+ * Blocks are folded into the running state with the pairwise update of
+ * Chan, Golub and LeVeque, which keeps the variance stable for large n.
+ *===========================================================================*/
+
+#define STATS_BLOCK 512
+#define STATS_CHUNK (64 * 1024)     /* ints per thread-pool task */
+#define STATS_STACK_CHUNKS 64
+
+typedef struct {
+    int64_t sum;
+    int min;
+    int max;
+} stats_block_t;
+
+static void scalar_stats_block(const int *v, size_t n, stats_block_t *b) {
+    int64_t sum = 0;
+    int lo = INT_MAX, hi = INT_MIN;
+    for (size_t i = 0; i < n; i++) {
+        sum += v[i];
+        lo = v[i] < lo ? v[i] : lo;
+        hi = v[i] > hi ? v[i] : hi;
+    }
+    b->sum = sum;
+    b->min = lo;
+    b->max = hi;
+}
+
+static double scalar_stats_m2(const int *v, size_t n, double mean) {
+    double m2 = 0;
+    for (size_t i = 0; i < n; i++) {
+        double d = (double)v[i] - mean;
+        m2 += d * d;
+    }
+    return m2;
+}
+
+#ifdef CALC_X86
+
+__attribute__((target("avx2")))
+static void avx2_stats_block(const int *v, size_t n, stats_block_t *b) {
+    __m256i vsum = _mm256_setzero_si256();
+    __m256i vmin = _mm256_set1_epi32(INT_MAX);
+    __m256i vmax = _mm256_set1_epi32(INT_MIN);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(v + i));
+        vmin = _mm256_min_epi32(vmin, x);
+        vmax = _mm256_max_epi32(vmax, x);
+        vsum = _mm256_add_epi64(vsum, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+        vsum = _mm256_add_epi64(vsum, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+    }
+
+    int64_t sums[4];
+    int mins[8], maxs[8];
+    _mm256_storeu_si256((__m256i *)sums, vsum);
+    _mm256_storeu_si256((__m256i *)mins, vmin);
+    _mm256_storeu_si256((__m256i *)maxs, vmax);
+    scalar_stats_block(v + i, n - i, b);
+    b->sum += sums[0] + sums[1] + sums[2] + sums[3];
+    for (int k = 0; k < 8; k++) {
+        b->min = mins[k] < b->min ? mins[k] : b->min;
+        b->max = maxs[k] > b->max ? maxs[k] : b->max;
+    }
+}
+
+__attribute__((target("avx2")))
+static double avx2_stats_m2(const int *v, size_t n, double mean) {
+    __m256d vmean = _mm256_set1_pd(mean);
+    __m256d acc = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d d = _mm256_sub_pd(_mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i *)(v + i))), vmean);
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(d, d));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + scalar_stats_m2(v + i, n - i, mean);
+}
+
+#endif /* CALC_X86 */
+
+static double stats_mean_d(const multi_calc_stats_t *st) {
+    return (double)avg_sum(&st->avg) / (double)st->avg.count;
+}
+
+void multi_calc_stats_init(multi_calc_stats_t *st) {
+    multi_calc_avg_init(&st->avg);
+    st->min = INT_MAX;
+    st->max = INT_MIN;
+    st->m2 = 0;
+}
+
+void multi_calc_stats_merge(multi_calc_stats_t *dst, const multi_calc_stats_t *src) {
+    if (src->avg.count == 0) {
+        return;
+    }
+    if (dst->avg.count == 0) {
+        *dst = *src;
+        return;
+    }
+    double na = (double)dst->avg.count;
+    double nb = (double)src->avg.count;
+    double delta = stats_mean_d(src) - stats_mean_d(dst);
+    dst->m2 += src->m2 + delta * delta * (na * nb / (na + nb));
+    dst->min = src->min < dst->min ? src->min : dst->min;
+    dst->max = src->max > dst->max ? src->max : dst->max;
+    multi_calc_avg_merge(&dst->avg, &src->avg);
+}
+
+void multi_calc_stats_push(multi_calc_stats_t *st, int value) {
+    multi_calc_stats_t one;
+    multi_calc_avg_init(&one.avg);
+    avg_add(&one.avg, value, 1);
+    one.min = value;
+    one.max = value;
+    one.m2 = 0;
+    multi_calc_stats_merge(st, &one);
+}
+
+void multi_calc_stats_push_n(multi_calc_stats_t *st, const int *values, size_t n) {
+#ifdef CALC_X86
+    int avx2 = calc_batch_use_avx2();
+#endif
+    for (size_t base = 0; base < n; base += STATS_BLOCK) {
+        size_t len = n - base < STATS_BLOCK ? n - base : STATS_BLOCK;
+        const int *v = values + base;
+        stats_block_t b;
+        double m2;
+#ifdef CALC_X86
+        if (avx2) {
+            avx2_stats_block(v, len, &b);
+            m2 = avx2_stats_m2(v, len, (double)b.sum / (double)len);
+        } else
+#endif
+        {
+            scalar_stats_block(v, len, &b);
+            m2 = scalar_stats_m2(v, len, (double)b.sum / (double)len);
+        }
+
+        multi_calc_stats_t block;
+        multi_calc_avg_init(&block.avg);
+        avg_add(&block.avg, b.sum, len);
+        block.min = b.min;
+        block.max = b.max;
+        block.m2 = m2;
+        multi_calc_stats_merge(st, &block);
+    }
+}
+
+struct stats_job {
+    const int *values;
+    size_t n;
+    multi_calc_stats_t *partial;
+};
+
+static void stats_task(void *ctx, size_t task) {
+    struct stats_job *job = ctx;
+    size_t begin = task * STATS_CHUNK;
+    size_t len = job->n - begin < STATS_CHUNK ? job->n - begin : STATS_CHUNK;
+    multi_calc_stats_init(&job->partial[task]);
+    multi_calc_stats_push_n(&job->partial[task], job->values + begin, len);
+}
+
+void multi_calc_stats_n(multi_calc_stats_t *st, const int *values, size_t n, unsigned max_threads) {
+    multi_calc_stats_init(st);
+    size_t nchunks = (n + STATS_CHUNK - 1) / STATS_CHUNK;
+    if (nchunks <= 1 || max_threads == 1) {
+        multi_calc_stats_push_n(st, values, n);
+        return;
+    }
+
+    multi_calc_stats_t stack_partial[STATS_STACK_CHUNKS];
+    multi_calc_stats_t *partial = stack_partial;
+    if (nchunks > STATS_STACK_CHUNKS) {
+        partial = malloc(nchunks * sizeof(*partial));
+        if (partial == NULL) {
+            multi_calc_stats_push_n(st, values, n);
+            return;
+        }
+    }
+
+    struct stats_job job = { values, n, partial };
+    sdk_pool_parallel_for(nchunks, max_threads, stats_task, &job);
+
+    // Merge in chunk order so the result doesn't depend on scheduling
+    for (size_t i = 0; i < nchunks; i++) {
+        multi_calc_stats_merge(st, &partial[i]);
+    }
+    if (partial != stack_partial) {
+        free(partial);
+    }
+}
+
+int multi_calc_stats_mean(const multi_calc_stats_t *st) {
+    return multi_calc_avg_finalize(&st->avg);
+}
+
+int64_t multi_calc_stats_sum(const multi_calc_stats_t *st) {
+    return (int64_t)avg_sum(&st->avg);
+}
+
+double multi_calc_stats_variance(const multi_calc_stats_t *st, int sample) {
+    uint64_t ddof = sample ? 1 : 0;
+    if (st->avg.count <= ddof) {
+        return 0;
+    }
+    return st->m2 / (double)(st->avg.count - ddof);
+}
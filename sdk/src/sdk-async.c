@@ -0,0 +1,255 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include "calc.h"
+#include "multi-calc.h"
+#include "sdk-async.h"
+
+#define SDK_ASYNC_MAX_WORKERS 64
+
+struct sdk_async {
+    pthread_mutex_t lock;           /* protects everything below */
+    pthread_cond_t sq_cv;           /* submission queue not empty / stop */
+    pthread_cond_t cq_cv;           /* completion posted / request finished */
+    unsigned entries;
+    sdk_async_sqe_t *sq;            /* ring buffer of entries requests */
+    unsigned sq_head;
+    unsigned sq_count;
+    sdk_async_cqe_t *cq;            /* ring buffer of entries completions */
+    unsigned cq_head;
+    unsigned cq_count;
+    unsigned inflight;              /* submitted, not yet reaped */
+    unsigned callbacks;             /* completion callbacks running */
+    int stop;
+    int efd;
+    unsigned nworkers;
+    pthread_t workers[SDK_ASYNC_MAX_WORKERS];
+};
+
+static int sdk_async_valid(const sdk_async_sqe_t *sqe) {
+    if ((unsigned)sqe->op >= SDK_ASYNC_OP_COUNT) {
+        return 0;
+    }
+    if (sqe->n == 0) {
+        return 1;
+    }
+    if (sqe->a == NULL) {
+        return 0;
+    }
+    switch (sqe->op) {
+    case SDK_ASYNC_MULTI_CALC_AVERAGE:
+        return 1;
+    case SDK_ASYNC_MULTI_CALC_EXPRESSION:
+        return sqe->b != NULL && sqe->c != NULL && sqe->d != NULL && sqe->out != NULL;
+    default:
+        return sqe->b != NULL && sqe->out != NULL;
+    }
+}
+
+static int sdk_async_execute(const sdk_async_sqe_t *sqe) {
+    switch (sqe->op) {
+    case SDK_ASYNC_CALC_ADD:
+        calc_add_n(sqe->a, sqe->b, sqe->out, sqe->n);
+        break;
+    case SDK_ASYNC_CALC_SUBTRACT:
+        calc_subtract_n(sqe->a, sqe->b, sqe->out, sqe->n);
+        break;
+    case SDK_ASYNC_CALC_MULTIPLY:
+        calc_multiply_n(sqe->a, sqe->b, sqe->out, sqe->n);
+        break;
+    case SDK_ASYNC_CALC_DIVIDE:
+        calc_divide_n(sqe->a, sqe->b, sqe->out, sqe->n);
+        break;
+    case SDK_ASYNC_MULTI_CALC_EXPRESSION:
+        multi_calc_expression_n(sqe->a, sqe->b, sqe->c, sqe->d, sqe->out, sqe->n);
+        break;
+    case SDK_ASYNC_MULTI_CALC_AVERAGE:
+        // Single-threaded: ring workers already run requests in parallel
+        return multi_calc_average_n(sqe->a, sqe->n, 1);
+    default:
+        break;
+    }
+    return 0;
+}
+
+static void sdk_async_signal_eventfd(sdk_async_t *ring) {
+    if (ring->efd >= 0) {
+        uint64_t one = 1;
+        ssize_t ret = write(ring->efd, &one, sizeof(one));
+        (void)ret;  // EAGAIN only if the counter is saturated: still readable
+    }
+}
+
+static void sdk_async_clear_eventfd(sdk_async_t *ring) {
+    if (ring->efd >= 0) {
+        uint64_t count;
+        ssize_t ret = read(ring->efd, &count, sizeof(count));
+        (void)ret;  // EAGAIN if already clear
+    }
+}
+
+static void *sdk_async_worker(void *arg) {
+    sdk_async_t *ring = arg;
+
+    pthread_mutex_lock(&ring->lock);
+    for (;;) {
+        while (ring->sq_count == 0 && !ring->stop) {
+            pthread_cond_wait(&ring->sq_cv, &ring->lock);
+        }
+        if (ring->sq_count == 0) {
+            break;  // stopping and drained
+        }
+        sdk_async_sqe_t sqe = ring->sq[ring->sq_head];
+        ring->sq_head = (ring->sq_head + 1) % ring->entries;
+        ring->sq_count--;
+        pthread_mutex_unlock(&ring->lock);
+
+        sdk_async_cqe_t cqe = { sqe.user_data, 0, sdk_async_execute(&sqe) };
+        pthread_mutex_lock(&ring->lock);
+        if (sqe.callback != NULL) {
+            // Free the slot first: the callback may submit again (a resumed
+            // coroutine awaiting its next request does)
+            ring->inflight--;
+            ring->callbacks++;
+            pthread_mutex_unlock(&ring->lock);
+            sqe.callback(sqe.callback_ctx, &cqe);
+            pthread_mutex_lock(&ring->lock);
+            ring->callbacks--;
+        } else {
+            ring->cq[(ring->cq_head + ring->cq_count) % ring->entries] = cqe;
+            ring->cq_count++;
+            sdk_async_signal_eventfd(ring);
+        }
+        pthread_cond_broadcast(&ring->cq_cv);
+    }
+    pthread_mutex_unlock(&ring->lock);
+    return NULL;
+}
+
+sdk_async_t *sdk_async_create(unsigned entries, unsigned nworkers) {
+    if (entries == 0) {
+        return NULL;
+    }
+    if (nworkers == 0) {
+        nworkers = 1;
+    }
+    if (nworkers > SDK_ASYNC_MAX_WORKERS) {
+        nworkers = SDK_ASYNC_MAX_WORKERS;
+    }
+
+    sdk_async_t *ring = calloc(1, sizeof(*ring));
+    if (ring == NULL) {
+        return NULL;
+    }
+    ring->entries = entries;
+    ring->sq = malloc(entries * sizeof(*ring->sq));
+    ring->cq = malloc(entries * sizeof(*ring->cq));
+    ring->efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    pthread_mutex_init(&ring->lock, NULL);
+    pthread_cond_init(&ring->sq_cv, NULL);
+    pthread_cond_init(&ring->cq_cv, NULL);
+    if (ring->sq == NULL || ring->cq == NULL) {
+        sdk_async_destroy(ring);
+        return NULL;
+    }
+
+    for (unsigned i = 0; i < nworkers; i++) {
+        if (pthread_create(&ring->workers[i], NULL, sdk_async_worker, ring) != 0) {
+            break;
+        }
+        ring->nworkers++;
+    }
+    if (ring->nworkers == 0) {
+        sdk_async_destroy(ring);
+        return NULL;
+    }
+    return ring;
+}
+
+void sdk_async_destroy(sdk_async_t *ring) {
+    if (ring == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&ring->lock);
+    ring->stop = 1;
+    pthread_cond_broadcast(&ring->sq_cv);
+    pthread_mutex_unlock(&ring->lock);
+
+    // Workers drain the submission queue before they exit
+    for (unsigned i = 0; i < ring->nworkers; i++) {
+        pthread_join(ring->workers[i], NULL);
+    }
+
+    if (ring->efd >= 0) {
+        close(ring->efd);
+    }
+    pthread_cond_destroy(&ring->cq_cv);
+    pthread_cond_destroy(&ring->sq_cv);
+    pthread_mutex_destroy(&ring->lock);
+    free(ring->sq);
+    free(ring->cq);
+    free(ring);
+}
+
+int sdk_async_submit(sdk_async_t *ring, const sdk_async_sqe_t *sqe) {
+    if (!sdk_async_valid(sqe)) {
+        return -1;
+    }
+    pthread_mutex_lock(&ring->lock);
+    if (ring->inflight >= ring->entries || ring->stop) {
+        pthread_mutex_unlock(&ring->lock);
+        return -1;
+    }
+    ring->sq[(ring->sq_head + ring->sq_count) % ring->entries] = *sqe;
+    ring->sq_count++;
+    ring->inflight++;
+    pthread_cond_signal(&ring->sq_cv);
+    pthread_mutex_unlock(&ring->lock);
+    return 0;
+}
+
+// Pop up to max completions (lock held)
+static unsigned sdk_async_reap_locked(sdk_async_t *ring, sdk_async_cqe_t *cqes, unsigned max) {
+    unsigned n = 0;
+    while (n < max && ring->cq_count > 0) {
+        cqes[n++] = ring->cq[ring->cq_head];
+        ring->cq_head = (ring->cq_head + 1) % ring->entries;
+        ring->cq_count--;
+        ring->inflight--;
+    }
+    if (ring->cq_count == 0) {
+        sdk_async_clear_eventfd(ring);
+    }
+    return n;
+}
+
+unsigned sdk_async_poll(sdk_async_t *ring, sdk_async_cqe_t *cqes, unsigned max) {
+    pthread_mutex_lock(&ring->lock);
+    unsigned n = sdk_async_reap_locked(ring, cqes, max);
+    pthread_mutex_unlock(&ring->lock);
+    return n;
+}
+
+unsigned sdk_async_wait(sdk_async_t *ring, sdk_async_cqe_t *cqes, unsigned max) {
+    pthread_mutex_lock(&ring->lock);
+    // Callback requests post nothing: if only those are in flight, return 0
+    // once their callbacks have returned
+    while (ring->cq_count == 0 && (ring->inflight > 0 || ring->callbacks > 0) && max > 0) {
+        pthread_cond_wait(&ring->cq_cv, &ring->lock);
+    }
+    unsigned n = sdk_async_reap_locked(ring, cqes, max);
+    pthread_mutex_unlock(&ring->lock);
+    return n;
+}
+
+int sdk_async_eventfd(const sdk_async_t *ring) {
+    return ring->efd;
+}
+
+unsigned sdk_async_inflight(sdk_async_t *ring) {
+    pthread_mutex_lock(&ring->lock);
+    unsigned n = ring->inflight;
+    pthread_mutex_unlock(&ring->lock);
+    return n;
+}
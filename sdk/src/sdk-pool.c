@@ -0,0 +1,203 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "sdk-pool.h"
+
+#define SDK_POOL_MAX_THREADS 256
+
+struct sdk_pool_job {
+    sdk_pool_task_fn fn;
+    void *ctx;
+    size_t ntasks;
+    size_t next;              /* next task index, claimed atomically */
+};
+
+static struct {
+    pthread_mutex_t submit_lock;  /* one parallel_for (or resize) at a time */
+    pthread_mutex_t lock;         /* protects everything below */
+    pthread_cond_t work_cv;
+    pthread_cond_t done_cv;
+    pthread_t threads[SDK_POOL_MAX_THREADS];
+    unsigned size;                /* configured size incl. caller, 0 = default */
+    unsigned nworkers;            /* started worker threads */
+    unsigned long generation;     /* bumped for every job */
+    unsigned long start_generation;
+    unsigned job_workers;         /* workers taking part in the current job */
+    unsigned active;              /* of those, how many are still running */
+    int shutdown;
+    struct sdk_pool_job job;
+} pool = {
+    .submit_lock = PTHREAD_MUTEX_INITIALIZER,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .work_cv = PTHREAD_COND_INITIALIZER,
+    .done_cv = PTHREAD_COND_INITIALIZER,
+};
+
+// Set while a thread runs pool tasks: nested calls then run serially
+static __thread int in_pool_task;
+
+static unsigned sdk_pool_default_size(void) {
+    const char *env = getenv("SDK_THREADS");
+    long n = env != NULL ? strtol(env, NULL, 10) : 0;
+    if (n <= 0) {
+        n = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (n <= 0) {
+        n = 1;
+    }
+    return n > SDK_POOL_MAX_THREADS ? SDK_POOL_MAX_THREADS : (unsigned)n;
+}
+
+static void sdk_pool_run_tasks(struct sdk_pool_job *job) {
+    size_t i;
+    while ((i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) < job->ntasks) {
+        job->fn(job->ctx, i);
+    }
+}
+
+static void *sdk_pool_worker(void *arg) {
+    unsigned id = (unsigned)(uintptr_t)arg;
+    in_pool_task = 1;
+
+    pthread_mutex_lock(&pool.lock);
+    unsigned long seen = pool.start_generation;
+    for (;;) {
+        while (pool.generation == seen && !pool.shutdown) {
+            pthread_cond_wait(&pool.work_cv, &pool.lock);
+        }
+        if (pool.shutdown) {
+            break;
+        }
+        seen = pool.generation;
+        if (id >= pool.job_workers) {
+            continue;  // capped out of this job
+        }
+
+        pthread_mutex_unlock(&pool.lock);
+        sdk_pool_run_tasks(&pool.job);
+        pthread_mutex_lock(&pool.lock);
+
+        if (--pool.active == 0) {
+            pthread_cond_signal(&pool.done_cv);
+        }
+    }
+    pthread_mutex_unlock(&pool.lock);
+    return NULL;
+}
+
+// Start the workers if needed (submit_lock held)
+static void sdk_pool_start_locked(void) {
+    if (pool.nworkers > 0) {
+        return;
+    }
+    if (pool.size == 0) {
+        __atomic_store_n(&pool.size, sdk_pool_default_size(), __ATOMIC_RELEASE);
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.start_generation = pool.generation;
+    pthread_mutex_unlock(&pool.lock);
+
+    for (unsigned i = 0; i + 1 < pool.size; i++) {
+        if (pthread_create(&pool.threads[i], NULL, sdk_pool_worker, (void *)(uintptr_t)i) != 0) {
+            break;  // run with the workers we got
+        }
+        __atomic_store_n(&pool.nworkers, pool.nworkers + 1, __ATOMIC_RELEASE);
+    }
+}
+
+// Stop and join the workers (submit_lock held)
+static void sdk_pool_stop_locked(void) {
+    pthread_mutex_lock(&pool.lock);
+    pool.shutdown = 1;
+    pthread_cond_broadcast(&pool.work_cv);
+    pthread_mutex_unlock(&pool.lock);
+
+    for (unsigned i = 0; i < pool.nworkers; i++) {
+        pthread_join(pool.threads[i], NULL);
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    __atomic_store_n(&pool.nworkers, 0, __ATOMIC_RELEASE);
+    pool.shutdown = 0;
+    pthread_mutex_unlock(&pool.lock);
+}
+
+void sdk_pool_parallel_for(size_t ntasks, unsigned max_threads, sdk_pool_task_fn fn, void *ctx) {
+    if (ntasks == 0) {
+        return;
+    }
+    if (ntasks == 1 || max_threads == 1 || in_pool_task ||
+        pthread_mutex_trylock(&pool.submit_lock) != 0) {
+        for (size_t i = 0; i < ntasks; i++) {
+            fn(ctx, i);
+        }
+        return;
+    }
+
+    sdk_pool_start_locked();
+
+    unsigned workers = pool.nworkers;
+    if (max_threads != 0 && max_threads - 1 < workers) {
+        workers = max_threads - 1;
+    }
+    if (workers > ntasks - 1) {
+        workers = (unsigned)(ntasks - 1);
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.job.fn = fn;
+    pool.job.ctx = ctx;
+    pool.job.ntasks = ntasks;
+    pool.job.next = 0;
+    pool.job_workers = workers;
+    pool.active = workers;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.work_cv);
+    pthread_mutex_unlock(&pool.lock);
+
+    // The caller works too
+    in_pool_task = 1;
+    sdk_pool_run_tasks(&pool.job);
+    in_pool_task = 0;
+
+    pthread_mutex_lock(&pool.lock);
+    while (pool.active > 0) {
+        pthread_cond_wait(&pool.done_cv, &pool.lock);
+    }
+    pthread_mutex_unlock(&pool.lock);
+
+    pthread_mutex_unlock(&pool.submit_lock);
+}
+
+unsigned sdk_pool_size(void) {
+    // Lock-free so it can be called from inside a pool task
+    unsigned nworkers = __atomic_load_n(&pool.nworkers, __ATOMIC_ACQUIRE);
+    unsigned size = __atomic_load_n(&pool.size, __ATOMIC_ACQUIRE);
+    if (nworkers > 0) {
+        return nworkers + 1;
+    }
+    return size != 0 ? size : sdk_pool_default_size();
+}
+
+int sdk_pool_set_size(unsigned nthreads) {
+    if (in_pool_task || pthread_mutex_trylock(&pool.submit_lock) != 0) {
+        return -1;
+    }
+    sdk_pool_stop_locked();
+    if (nthreads > SDK_POOL_MAX_THREADS) {
+        nthreads = SDK_POOL_MAX_THREADS;
+    }
+    __atomic_store_n(&pool.size, nthreads, __ATOMIC_RELEASE);  // 0 picks the default again on next start
+    sdk_pool_start_locked();
+    int ret = (pool.nworkers + 1 == pool.size) ? 0 : -1;
+    pthread_mutex_unlock(&pool.submit_lock);
+    return ret;
+}
+
+void sdk_pool_shutdown(void) {
+    pthread_mutex_lock(&pool.submit_lock);
+    sdk_pool_stop_locked();
+    pthread_mutex_unlock(&pool.submit_lock);
+}
@@ -0,0 +1,350 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sdk-pool.h"
+#include "sdk-sched.h"
+
+#define SDK_SCHED_MAX_WORKERS 256
+#define SDK_SCHED_DEQUE_SIZE 128    /* depth-first splitting needs ~log2(n) slots */
+#define SDK_SCHED_SPINS 64          /* failed steal rounds before yielding */
+
+typedef struct {
+    size_t begin;
+    size_t end;
+} sched_range_t;
+
+/*
+ * Chase-Lev deque (Le, Pop, Cohen, Zappa Nardelli, PPoPP 2013 memory
+ * orders). The owner pushes and takes at the bottom, thieves steal at the
+ * top. Indices only grow, so deques never need resetting between runs.
+ * The buffer is fixed: when it's full the owner just stops splitting.
+ */
+typedef struct {
+    int64_t top __attribute__((aligned(64)));
+    int64_t bottom __attribute__((aligned(64)));
+    uint64_t ranges;        /* owner-only counters, folded in after a run */
+    uint64_t steals;
+    sched_range_t buf[SDK_SCHED_DEQUE_SIZE];
+} __attribute__((aligned(64))) sched_deque_t;
+
+static struct {
+    pthread_mutex_t submit_lock;  /* one run (or resize) at a time */
+    pthread_mutex_t lock;         /* protects generation / active / shutdown */
+    pthread_cond_t work_cv;
+    pthread_cond_t done_cv;
+    pthread_t threads[SDK_SCHED_MAX_WORKERS];
+    sched_deque_t *deques;        /* one per worker, caller = deque 0 */
+    unsigned size;                /* configured size incl. caller, 0 = default */
+    unsigned nworkers;            /* started worker threads */
+    unsigned long generation;     /* bumped for every run */
+    unsigned long start_generation;
+    unsigned active;              /* workers still in the current run */
+    int shutdown;
+    /* current run */
+    sdk_sched_range_fn fn;
+    void *ctx;
+    size_t grain;
+    size_t remaining;             /* indexes not yet processed */
+} sched = {
+    .submit_lock = PTHREAD_MUTEX_INITIALIZER,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .work_cv = PTHREAD_COND_INITIALIZER,
+    .done_cv = PTHREAD_COND_INITIALIZER,
+};
+
+static sdk_sched_stats_t sched_stats;
+
+// Set while a thread runs scheduler callbacks: nested runs are serial
+static __thread int in_sched_task;
+static __thread uint32_t sched_rng;
+
+/*============================================================================
+ * Deque
+ *===========================================================================*/
+
+static void range_store(sched_range_t *slot, sched_range_t r) {
+    __atomic_store_n(&slot->begin, r.begin, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->end, r.end, __ATOMIC_RELAXED);
+}
+
+static sched_range_t range_load(sched_range_t *slot) {
+    sched_range_t r;
+    r.begin = __atomic_load_n(&slot->begin, __ATOMIC_RELAXED);
+    r.end = __atomic_load_n(&slot->end, __ATOMIC_RELAXED);
+    return r;
+}
+
+// Owner only; returns 0 when the deque is full
+static int deque_push(sched_deque_t *dq, sched_range_t r) {
+    int64_t b = __atomic_load_n(&dq->bottom, __ATOMIC_RELAXED);
+    int64_t t = __atomic_load_n(&dq->top, __ATOMIC_ACQUIRE);
+    if (b - t >= SDK_SCHED_DEQUE_SIZE) {
+        return 0;
+    }
+    range_store(&dq->buf[b % SDK_SCHED_DEQUE_SIZE], r);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELAXED);
+    return 1;
+}
+
+// Owner only: newest range first
+static int deque_take(sched_deque_t *dq, sched_range_t *r) {
+    int64_t b = __atomic_load_n(&dq->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&dq->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t t = __atomic_load_n(&dq->top, __ATOMIC_RELAXED);
+    if (t > b) {
+        __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELAXED);  // empty
+        return 0;
+    }
+    *r = range_load(&dq->buf[b % SDK_SCHED_DEQUE_SIZE]);
+    if (t < b) {
+        return 1;
+    }
+    // Last range: race the thieves for it
+    int won = __atomic_compare_exchange_n(&dq->top, &t, t + 1, 0,
+                                          __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+    __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELAXED);
+    return won;
+}
+
+// Any thread: oldest (largest) range first
+static int deque_steal(sched_deque_t *dq, sched_range_t *r) {
+    int64_t t = __atomic_load_n(&dq->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t b = __atomic_load_n(&dq->bottom, __ATOMIC_ACQUIRE);
+    if (t >= b) {
+        return 0;
+    }
+    *r = range_load(&dq->buf[t % SDK_SCHED_DEQUE_SIZE]);
+    return __atomic_compare_exchange_n(&dq->top, &t, t + 1, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+/*============================================================================
+ * Workers
+ *===========================================================================*/
+
+// Split down to the grain, keeping the lower half, then run it
+static void sched_execute(sched_deque_t *dq, sched_range_t r) {
+    while (r.end - r.begin > sched.grain) {
+        size_t mid = r.begin + (r.end - r.begin) / 2;
+        if (!deque_push(dq, (sched_range_t){ mid, r.end })) {
+            break;
+        }
+        r.end = mid;
+    }
+    sched.fn(sched.ctx, r.begin, r.end);
+    dq->ranges++;
+    __atomic_sub_fetch(&sched.remaining, r.end - r.begin, __ATOMIC_RELEASE);
+}
+
+static int sched_try_steal(unsigned id, unsigned n, sched_range_t *r) {
+    sched_rng ^= sched_rng << 13;
+    sched_rng ^= sched_rng >> 17;
+    sched_rng ^= sched_rng << 5;
+    unsigned start = sched_rng % n;
+    for (unsigned k = 0; k < n; k++) {
+        unsigned victim = (start + k) % n;
+        if (victim != id && deque_steal(&sched.deques[victim], r)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void sched_work(unsigned id) {
+    sched_deque_t *dq = &sched.deques[id];
+    unsigned n = sched.nworkers + 1;
+    unsigned idle = 0;
+    sched_range_t r;
+
+    while (__atomic_load_n(&sched.remaining, __ATOMIC_ACQUIRE) != 0) {
+        if (deque_take(dq, &r)) {
+            sched_execute(dq, r);
+            idle = 0;
+        } else if (sched_try_steal(id, n, &r)) {
+            dq->steals++;
+            sched_execute(dq, r);
+            idle = 0;
+        } else if (++idle >= SDK_SCHED_SPINS) {
+            sched_yield();
+        }
+    }
+}
+
+static void *sched_worker(void *arg) {
+    unsigned id = (unsigned)(uintptr_t)arg;
+    in_sched_task = 1;
+    sched_rng = 0x9E3779B9u * (id + 1);
+
+    pthread_mutex_lock(&sched.lock);
+    unsigned long seen = sched.start_generation;
+    for (;;) {
+        while (sched.generation == seen && !sched.shutdown) {
+            pthread_cond_wait(&sched.work_cv, &sched.lock);
+        }
+        if (sched.shutdown) {
+            break;
+        }
+        seen = sched.generation;
+
+        pthread_mutex_unlock(&sched.lock);
+        sched_work(id);
+        pthread_mutex_lock(&sched.lock);
+
+        if (--sched.active == 0) {
+            pthread_cond_signal(&sched.done_cv);
+        }
+    }
+    pthread_mutex_unlock(&sched.lock);
+    return NULL;
+}
+
+// Start the workers if needed (submit_lock held)
+static void sched_start_locked(void) {
+    if (sched.deques != NULL) {
+        return;
+    }
+    unsigned size = sched.size != 0 ? sched.size : sdk_pool_size();
+    if (size > SDK_SCHED_MAX_WORKERS) {
+        size = SDK_SCHED_MAX_WORKERS;
+    }
+    if (posix_memalign((void **)&sched.deques, 64, size * sizeof(sched_deque_t)) != 0) {
+        sched.deques = NULL;
+        return;
+    }
+    memset(sched.deques, 0, size * sizeof(sched_deque_t));
+
+    pthread_mutex_lock(&sched.lock);
+    sched.start_generation = sched.generation;
+    pthread_mutex_unlock(&sched.lock);
+
+    for (unsigned i = 1; i < size; i++) {
+        if (pthread_create(&sched.threads[i - 1], NULL, sched_worker, (void *)(uintptr_t)i) != 0) {
+            break;  // run with the workers we got
+        }
+        __atomic_store_n(&sched.nworkers, sched.nworkers + 1, __ATOMIC_RELEASE);
+    }
+}
+
+// Stop and join the workers (submit_lock held)
+static void sched_stop_locked(void) {
+    pthread_mutex_lock(&sched.lock);
+    sched.shutdown = 1;
+    pthread_cond_broadcast(&sched.work_cv);
+    pthread_mutex_unlock(&sched.lock);
+
+    for (unsigned i = 0; i < sched.nworkers; i++) {
+        pthread_join(sched.threads[i], NULL);
+    }
+
+    pthread_mutex_lock(&sched.lock);
+    __atomic_store_n(&sched.nworkers, 0, __ATOMIC_RELEASE);
+    sched.shutdown = 0;
+    pthread_mutex_unlock(&sched.lock);
+    free(sched.deques);
+    sched.deques = NULL;
+}
+
+/*============================================================================
+ * Public API
+ *===========================================================================*/
+
+void sdk_sched_run(size_t begin, size_t end, size_t grain, sdk_sched_range_fn fn, void *ctx) {
+    if (begin >= end) {
+        return;
+    }
+    __atomic_add_fetch(&sched_stats.runs, 1, __ATOMIC_RELAXED);
+    if (in_sched_task || pthread_mutex_trylock(&sched.submit_lock) != 0) {
+        fn(ctx, begin, end);
+        __atomic_add_fetch(&sched_stats.ranges, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    sched_start_locked();
+    if (sched.deques == NULL || sched.nworkers == 0) {
+        pthread_mutex_unlock(&sched.submit_lock);
+        fn(ctx, begin, end);
+        __atomic_add_fetch(&sched_stats.ranges, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    sched.fn = fn;
+    sched.ctx = ctx;
+    sched.grain = grain != 0 ? grain : 1;
+    __atomic_store_n(&sched.remaining, end - begin, __ATOMIC_RELAXED);
+    deque_push(&sched.deques[0], (sched_range_t){ begin, end });
+
+    pthread_mutex_lock(&sched.lock);
+    sched.active = sched.nworkers;
+    sched.generation++;
+    pthread_cond_broadcast(&sched.work_cv);
+    pthread_mutex_unlock(&sched.lock);
+
+    // The caller works too, as worker 0
+    in_sched_task = 1;
+    if (sched_rng == 0) {
+        sched_rng = 0x9E3779B9u;
+    }
+    sched_work(0);
+    in_sched_task = 0;
+
+    pthread_mutex_lock(&sched.lock);
+    while (sched.active > 0) {
+        pthread_cond_wait(&sched.done_cv, &sched.lock);
+    }
+    pthread_mutex_unlock(&sched.lock);
+
+    for (unsigned i = 0; i <= sched.nworkers; i++) {
+        __atomic_add_fetch(&sched_stats.ranges, sched.deques[i].ranges, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&sched_stats.steals, sched.deques[i].steals, __ATOMIC_RELAXED);
+        sched.deques[i].ranges = 0;
+        sched.deques[i].steals = 0;
+    }
+    pthread_mutex_unlock(&sched.submit_lock);
+}
+
+unsigned sdk_sched_workers(void) {
+    unsigned nworkers = __atomic_load_n(&sched.nworkers, __ATOMIC_ACQUIRE);
+    unsigned size = __atomic_load_n(&sched.size, __ATOMIC_ACQUIRE);
+    if (nworkers > 0) {
+        return nworkers + 1;
+    }
+    return size != 0 ? size : sdk_pool_size();
+}
+
+int sdk_sched_set_workers(unsigned nworkers) {
+    if (in_sched_task || pthread_mutex_trylock(&sched.submit_lock) != 0) {
+        return -1;
+    }
+    sched_stop_locked();
+    if (nworkers > SDK_SCHED_MAX_WORKERS) {
+        nworkers = SDK_SCHED_MAX_WORKERS;
+    }
+    __atomic_store_n(&sched.size, nworkers, __ATOMIC_RELEASE);
+    sched_start_locked();
+    unsigned want = nworkers != 0 ? nworkers : sdk_sched_workers();
+    int ret = (sched.deques != NULL && sched.nworkers + 1 == want) ? 0 : -1;
+    pthread_mutex_unlock(&sched.submit_lock);
+    return ret;
+}
+
+void sdk_sched_shutdown(void) {
+    pthread_mutex_lock(&sched.submit_lock);
+    sched_stop_locked();
+    pthread_mutex_unlock(&sched.submit_lock);
+}
+
+void sdk_sched_get_stats(sdk_sched_stats_t *stats) {
+    stats->runs = __atomic_load_n(&sched_stats.runs, __ATOMIC_RELAXED);
+    stats->ranges = __atomic_load_n(&sched_stats.ranges, __ATOMIC_RELAXED);
+    stats->steals = __atomic_load_n(&sched_stats.steals, __ATOMIC_RELAXED);
+}
+
+void sdk_sched_reset_stats(void) {
+    __atomic_store_n(&sched_stats.runs, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&sched_stats.ranges, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&sched_stats.steals, 0, __ATOMIC_RELAXED);
+}
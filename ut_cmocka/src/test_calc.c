@@ -13,9 +13,19 @@
 #include <stdint.h>
 #include <setjmp.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include <cmocka.h>
 
 #include "calc.h"
+#include "calc-inline.h"
+#include "calc-bigint.h"
+#include "calc-column.h"
+#include "calc-fixed.h"
+#include "calc-matrix.h"
+#include "sdk-pool.h"
+#include "sdk-sched.h"
 
 /*============================================================================
  * Basic Assert Tests - calc_add
@@ -122,6 +132,1227 @@ static void test_calc_divide_negative_numbers(void **state) {
     assert_int_equal(calc_divide(-10, -2), 5);
 }
 
+/*============================================================================
+ * Batch API Tests - every supported ISA against the scalar reference
+ *===========================================================================*/
+
+#define BATCH_LEN 37  /* not a multiple of any vector width, exercises tails */
+#define ARRAY_LEN(x) (sizeof(x) / sizeof((x)[0]))
+
+static const calc_isa_t all_isas[] = {
+    CALC_ISA_SCALAR, CALC_ISA_SSE2, CALC_ISA_AVX2, CALC_ISA_AVX512,
+};
+
+typedef void (*batch_fn)(const int *, const int *, int *, size_t);
+
+static void fill_batch_inputs(int *a, int *b) {
+    for (int i = 0; i < BATCH_LEN; i++) {
+        a[i] = (i * 7919) % 20001 - 10000;
+        b[i] = (i * 104729) % 201 - 100;  /* includes 0 at i == 0 and others */
+    }
+}
+
+static void check_batch_against_ref(batch_fn fn, batch_fn ref) {
+    int a[BATCH_LEN], b[BATCH_LEN], out[BATCH_LEN], expected[BATCH_LEN];
+    fill_batch_inputs(a, b);
+    ref(a, b, expected, BATCH_LEN);
+
+    calc_isa_t saved = calc_batch_get_isa();
+    for (size_t k = 0; k < ARRAY_LEN(all_isas); k++) {
+        if (calc_batch_set_isa(all_isas[k]) != 0) {
+            continue;  /* not supported on this CPU */
+        }
+        fn(a, b, out, BATCH_LEN);
+        assert_memory_equal(out, expected, sizeof(expected));
+    }
+    calc_batch_set_isa(saved);
+}
+
+static void test_calc_add_n(void **state) {
+    (void)state;
+    check_batch_against_ref(calc_add_n, calc_add_n_ref);
+}
+
+static void test_calc_subtract_n(void **state) {
+    (void)state;
+    check_batch_against_ref(calc_subtract_n, calc_subtract_n_ref);
+}
+
+static void test_calc_multiply_n(void **state) {
+    (void)state;
+    check_batch_against_ref(calc_multiply_n, calc_multiply_n_ref);
+}
+
+static void test_calc_divide_n(void **state) {
+    (void)state;
+    check_batch_against_ref(calc_divide_n, calc_divide_n_ref);
+}
+
+static void test_calc_divide_n_by_zero_lanes(void **state) {
+    (void)state;
+    int a[16], b[16], out[16];
+    for (int i = 0; i < 16; i++) {
+        a[i] = 100 + i;
+        b[i] = (i % 2 == 0) ? 0 : 2;  /* every other lane divides by zero */
+    }
+
+    calc_divide_n(a, b, out, 16);
+
+    for (int i = 0; i < 16; i++) {
+        assert_int_equal(out[i], (i % 2 == 0) ? 0 : (100 + i) / 2);
+    }
+}
+
+static void test_calc_batch_isa_selection(void **state) {
+    (void)state;
+    // Scalar is always available, and the default is a supported ISA
+    assert_true(calc_batch_isa_supported(CALC_ISA_SCALAR));
+    assert_true(calc_batch_isa_supported(calc_batch_get_isa()));
+    assert_int_equal(calc_batch_set_isa((calc_isa_t)99), -1);
+}
+
+/*============================================================================
+ * Precomputed Divider Tests - must agree with calc_divide
+ *===========================================================================*/
+
+static const int divider_divisors[] = {
+    1, -1, 2, -2, 3, -3, 7, 10, -10, 641, 1 << 16, 1000000007,
+    INT32_MAX, INT32_MIN, INT32_MIN + 1,
+};
+
+static const int divider_dividends[] = {
+    0, 1, -1, 2, 5, -5, 99, -100, 65535, 65536, -65537,
+    123456789, -987654321, INT32_MAX, INT32_MAX - 1, INT32_MIN + 1,
+};
+
+static void test_calc_divider_matches_divide(void **state) {
+    (void)state;
+    for (size_t i = 0; i < ARRAY_LEN(divider_divisors); i++) {
+        calc_divider_t div;
+        calc_divider_init(&div, divider_divisors[i]);
+        for (size_t j = 0; j < ARRAY_LEN(divider_dividends); j++) {
+            int a = divider_dividends[j];
+            assert_int_equal(calc_divider_divide(&div, a), calc_divide(a, divider_divisors[i]));
+        }
+    }
+}
+
+static void test_calc_divider_int_min_dividend(void **state) {
+    (void)state;
+    calc_divider_t div;
+
+    calc_divider_init(&div, 2);
+    assert_int_equal(calc_divider_divide(&div, INT32_MIN), INT32_MIN / 2);
+    calc_divider_init(&div, INT32_MIN);
+    assert_int_equal(calc_divider_divide(&div, INT32_MIN), 1);
+    calc_divider_init(&div, 3);
+    assert_int_equal(calc_divider_divide(&div, INT32_MIN), INT32_MIN / 3);
+}
+
+static void test_calc_divider_by_zero(void **state) {
+    (void)state;
+    calc_divider_t div;
+    calc_divider_init(&div, 0);
+
+    assert_int_equal(calc_divider_divide(&div, 10), 0);
+    assert_int_equal(calc_divider_divide(&div, -5), 0);
+    assert_int_equal(calc_divider_divide(&div, INT32_MIN), 0);
+}
+
+static void test_calc_divider_divide_n(void **state) {
+    (void)state;
+    int a[BATCH_LEN], b[BATCH_LEN], out[BATCH_LEN];
+    fill_batch_inputs(a, b);
+
+    calc_isa_t saved = calc_batch_get_isa();
+    for (size_t i = 0; i < ARRAY_LEN(divider_divisors); i++) {
+        calc_divider_t div;
+        calc_divider_init(&div, divider_divisors[i]);
+        for (size_t k = 0; k < ARRAY_LEN(all_isas); k++) {
+            if (calc_batch_set_isa(all_isas[k]) != 0) {
+                continue;
+            }
+            calc_divider_divide_n(&div, a, out, BATCH_LEN);
+            for (int j = 0; j < BATCH_LEN; j++) {
+                assert_int_equal(out[j], calc_divide(a[j], divider_divisors[i]));
+            }
+        }
+    }
+    calc_batch_set_isa(saved);
+}
+
+/*============================================================================
+ * Overflow-Checked and Saturating Tests
+ *===========================================================================*/
+
+static void test_calc_checked_no_overflow(void **state) {
+    (void)state;
+    int r = 0;
+
+    assert_int_equal(calc_add_checked(2, 3, &r), 0);
+    assert_int_equal(r, 5);
+    assert_int_equal(calc_subtract_checked(3, 5, &r), 0);
+    assert_int_equal(r, -2);
+    assert_int_equal(calc_multiply_checked(-3, 4, &r), 0);
+    assert_int_equal(r, -12);
+    assert_int_equal(calc_divide_checked(10, 3, &r), 0);
+    assert_int_equal(r, 3);
+}
+
+static void test_calc_checked_overflow(void **state) {
+    (void)state;
+    int r = 0;
+
+    assert_int_equal(calc_add_checked(INT32_MAX, 1, &r), -1);
+    assert_int_equal(r, INT32_MIN);  // wrapped result is still stored
+    assert_int_equal(calc_subtract_checked(INT32_MIN, 1, &r), -1);
+    assert_int_equal(calc_multiply_checked(65536, 65536, &r), -1);
+    assert_int_equal(calc_divide_checked(INT32_MIN, -1, &r), -1);
+}
+
+static void test_calc_checked_divide_by_zero(void **state) {
+    (void)state;
+    int r = 42;
+
+    // Division by zero is not an overflow: the result is 0, like calc_divide
+    assert_int_equal(calc_divide_checked(10, 0, &r), 0);
+    assert_int_equal(r, 0);
+}
+
+static void test_calc_saturating(void **state) {
+    (void)state;
+
+    assert_int_equal(calc_add_sat(INT32_MAX, 1), INT32_MAX);
+    assert_int_equal(calc_add_sat(INT32_MIN, -1), INT32_MIN);
+    assert_int_equal(calc_add_sat(2, 3), 5);
+    assert_int_equal(calc_subtract_sat(INT32_MIN, 1), INT32_MIN);
+    assert_int_equal(calc_subtract_sat(INT32_MAX, -1), INT32_MAX);
+    assert_int_equal(calc_multiply_sat(65536, 65536), INT32_MAX);
+    assert_int_equal(calc_multiply_sat(-65536, 65536), INT32_MIN);
+    assert_int_equal(calc_multiply_sat(-4, -5), 20);
+    assert_int_equal(calc_divide_sat(INT32_MIN, -1), INT32_MAX);
+    assert_int_equal(calc_divide_sat(10, 0), 0);
+    assert_int_equal(calc_divide_sat(-10, 3), -3);
+}
+
+typedef size_t (*sat_batch_fn)(const int *, const int *, int *, uint8_t *, size_t);
+typedef int (*sat_scalar_fn)(int, int);
+typedef int (*checked_fn)(int, int, int *);
+
+static void check_sat_batch(sat_batch_fn batch, sat_scalar_fn scalar, checked_fn checked) {
+    const int edges[] = { 0, 1, -1, 2, -2, 46341, -46341, 65536, INT32_MAX, INT32_MIN, INT32_MAX - 1 };
+    int a[BATCH_LEN], b[BATCH_LEN], out[BATCH_LEN];
+    uint8_t mask[(BATCH_LEN + 7) / 8];
+
+    for (int i = 0; i < BATCH_LEN; i++) {
+        a[i] = edges[i % ARRAY_LEN(edges)];
+        b[i] = edges[(i * 5 + 3) % ARRAY_LEN(edges)];
+    }
+
+    calc_isa_t saved = calc_batch_get_isa();
+    for (size_t k = 0; k < ARRAY_LEN(all_isas); k++) {
+        if (calc_batch_set_isa(all_isas[k]) != 0) {
+            continue;
+        }
+        size_t expected_count = 0;
+        size_t count = batch(a, b, out, mask, BATCH_LEN);
+        for (int i = 0; i < BATCH_LEN; i++) {
+            int wrapped;
+            int overflowed = checked(a[i], b[i], &wrapped) != 0;
+            expected_count += (size_t)overflowed;
+            assert_int_equal(out[i], scalar(a[i], b[i]));
+            assert_int_equal((mask[i / 8] >> (i % 8)) & 1, overflowed);
+        }
+        assert_int_equal(count, expected_count);
+        // Unused bits of the last mask byte are cleared
+        assert_int_equal(mask[BATCH_LEN / 8] >> (BATCH_LEN % 8), 0);
+        // The mask is optional
+        assert_int_equal(batch(a, b, out, NULL, BATCH_LEN), expected_count);
+    }
+    calc_batch_set_isa(saved);
+}
+
+static void test_calc_sat_n(void **state) {
+    (void)state;
+    check_sat_batch(calc_add_sat_n, calc_add_sat, calc_add_checked);
+    check_sat_batch(calc_subtract_sat_n, calc_subtract_sat, calc_subtract_checked);
+    check_sat_batch(calc_multiply_sat_n, calc_multiply_sat, calc_multiply_checked);
+    check_sat_batch(calc_divide_sat_n, calc_divide_sat, calc_divide_checked);
+}
+
+/*============================================================================
+ * Inline Variants - must match the out-of-line primitives
+ *===========================================================================*/
+
+static void test_calc_inline_matches_out_of_line(void **state) {
+    (void)state;
+    const int values[] = { 0, 1, -1, 3, -7, 100, -1000, 46340, INT32_MAX, INT32_MIN + 1 };
+
+    for (size_t i = 0; i < ARRAY_LEN(values); i++) {
+        for (size_t j = 0; j < ARRAY_LEN(values); j++) {
+            int a = values[i] / 2, b = values[j] / 2;  /* keep add/subtract in range */
+            assert_int_equal(calc_add_inline(a, b), calc_add(a, b));
+            assert_int_equal(calc_subtract_inline(a, b), calc_subtract(a, b));
+            assert_int_equal(calc_divide_inline(values[i], values[j]), calc_divide(values[i], values[j]));
+        }
+    }
+    assert_int_equal(calc_multiply_inline(-3, 4), calc_multiply(-3, 4));
+    assert_int_equal(calc_divide_inline(10, 0), 0);
+}
+
+/*============================================================================
+ * Reductions - thread pool, scheduler, calc_sum_reduce and prefix scans
+ *===========================================================================*/
+
+#define POOL_TASKS 1000
+
+static void count_task(void *ctx, size_t task) {
+    int *hits = ctx;
+    __atomic_fetch_add(&hits[task], 1, __ATOMIC_RELAXED);
+}
+
+static void nested_task(void *ctx, size_t task) {
+    int (*hits)[POOL_TASKS] = ctx;
+    // Runs serially on this thread instead of deadlocking
+    sdk_pool_parallel_for(POOL_TASKS, 0, count_task, hits[task]);
+}
+
+static void test_sdk_pool_runs_every_task_once(void **state) {
+    (void)state;
+    static int hits[4][POOL_TASKS];
+
+    assert_int_equal(sdk_pool_set_size(4), 0);
+    assert_int_equal(sdk_pool_size(), 4);
+
+    const unsigned caps[] = { 0, 1, 2, 3, 8 };
+    for (size_t k = 0; k < ARRAY_LEN(caps); k++) {
+        memset(hits, 0, sizeof(hits));
+        sdk_pool_parallel_for(POOL_TASKS, caps[k], count_task, hits[0]);
+        for (int i = 0; i < POOL_TASKS; i++) {
+            assert_int_equal(hits[0][i], 1);
+        }
+    }
+
+    memset(hits, 0, sizeof(hits));
+    sdk_pool_parallel_for(4, 0, nested_task, hits);
+    for (int t = 0; t < 4; t++) {
+        for (int i = 0; i < POOL_TASKS; i++) {
+            assert_int_equal(hits[t][i], 1);
+        }
+    }
+
+    sdk_pool_parallel_for(0, 0, count_task, NULL);  // no tasks, no calls
+    sdk_pool_shutdown();
+    assert_int_equal(sdk_pool_set_size(0), 0);
+}
+
+static void count_range(void *ctx, size_t begin, size_t end) {
+    int *hits = ctx;
+    for (size_t i = begin; i < end; i++) {
+        __atomic_fetch_add(&hits[i], 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void nested_range(void *ctx, size_t begin, size_t end) {
+    int (*hits)[POOL_TASKS] = ctx;
+    for (size_t t = begin; t < end; t++) {
+        // Runs serially on this thread instead of deadlocking
+        sdk_sched_run(0, POOL_TASKS, 1, count_range, hits[t]);
+    }
+}
+
+static void test_sdk_sched_runs_every_index_once(void **state) {
+    (void)state;
+    static int hits[4][POOL_TASKS];
+
+    const unsigned workers[] = { 1, 4 };
+    for (size_t w = 0; w < ARRAY_LEN(workers); w++) {
+        assert_int_equal(sdk_sched_set_workers(workers[w]), 0);
+        assert_int_equal(sdk_sched_workers(), workers[w]);
+
+        const size_t grains[] = { 0, 1, 7, 64, POOL_TASKS * 2 };
+        for (size_t g = 0; g < ARRAY_LEN(grains); g++) {
+            memset(hits, 0, sizeof(hits));
+            sdk_sched_run(3, POOL_TASKS, grains[g], count_range, hits[0]);
+            for (int i = 0; i < POOL_TASKS; i++) {
+                assert_int_equal(hits[0][i], i >= 3 ? 1 : 0);
+            }
+        }
+
+        memset(hits, 0, sizeof(hits));
+        sdk_sched_run(0, 4, 1, nested_range, hits);
+        for (int t = 0; t < 4; t++) {
+            for (int i = 0; i < POOL_TASKS; i++) {
+                assert_int_equal(hits[t][i], 1);
+            }
+        }
+    }
+
+    // Grain 1 splits all the way down: one callback per index
+    assert_int_equal(sdk_sched_set_workers(4), 0);
+    sdk_sched_stats_t stats;
+    sdk_sched_reset_stats();
+    memset(hits, 0, sizeof(hits));
+    sdk_sched_run(0, POOL_TASKS, 1, count_range, hits[0]);
+    sdk_sched_run(5, 5, 1, count_range, NULL);  // empty range, no calls
+    sdk_sched_get_stats(&stats);
+    assert_int_equal(stats.runs, 1);
+    assert_int_equal(stats.ranges, POOL_TASKS);
+    assert_true(stats.steals <= stats.ranges);
+
+    sdk_sched_shutdown();
+    assert_int_equal(sdk_sched_set_workers(0), 0);
+}
+
+struct sched_add_ctx {
+    const int *a;
+    const int *b;
+    int *out;
+};
+
+// Skewed: range cost grows with the index
+static void sched_add_range(void *ctx, size_t begin, size_t end) {
+    struct sched_add_ctx *c = ctx;
+    for (size_t i = begin; i < end; i++) {
+        int v = 0;
+        for (size_t k = 0; k <= i / 64; k++) {
+            v = calc_add(v, c->a[i]);
+        }
+        c->out[i] = calc_add(v, c->b[i]);
+    }
+}
+
+static void test_sdk_sched_deterministic_output(void **state) {
+    (void)state;
+    enum { N = 4096 };
+    static int a[N], b[N], expected[N], out[N];
+    for (int i = 0; i < N; i++) {
+        a[i] = i * 31 - 7;
+        b[i] = N - i;
+    }
+    struct sched_add_ctx serial = { a, b, expected };
+    sched_add_range(&serial, 0, N);
+
+    assert_int_equal(sdk_sched_set_workers(4), 0);
+    struct sched_add_ctx ctx = { a, b, out };
+    for (int run = 0; run < 5; run++) {
+        memset(out, 0, sizeof(out));
+        sdk_sched_run(0, N, 16, sched_add_range, &ctx);
+        assert_memory_equal(out, expected, sizeof(out));
+    }
+    sdk_sched_set_workers(0);
+}
+
+static void test_calc_sum_reduce_small(void **state) {
+    (void)state;
+    const int values[] = { 1, -2, 3, INT32_MAX, INT32_MAX, INT32_MIN };
+
+    assert_int_equal(calc_sum_reduce(values, 0, 0), 0);
+    assert_int_equal(calc_sum_reduce(values, 3, 0), 2);
+    // 64-bit accumulator: no wrap-around past INT_MAX
+    assert_true(calc_sum_reduce(values + 3, 2, 0) == 2 * (int64_t)INT32_MAX);
+    assert_true(calc_sum_reduce(values, ARRAY_LEN(values), 0) == 2 + (int64_t)INT32_MAX - 1);
+}
+
+static void test_calc_sum_reduce_large(void **state) {
+    (void)state;
+    // More chunks than fit in the on-stack partial array, ragged tail
+    const size_t n = 70 * 64 * 1024 + 123;
+    int *a = malloc(n * sizeof(int));
+    assert_non_null(a);
+
+    int64_t expected = 0;
+    for (size_t i = 0; i < n; i++) {
+        a[i] = (i % 7 == 0) ? INT32_MAX : (int)(i % 1001) - 600;
+        expected += a[i];
+    }
+
+    assert_int_equal(sdk_pool_set_size(4), 0);
+    calc_isa_t saved = calc_batch_get_isa();
+    const unsigned caps[] = { 1, 2, 4, 0 };
+    for (size_t k = 0; k < ARRAY_LEN(all_isas); k++) {
+        if (calc_batch_set_isa(all_isas[k]) != 0) {
+            continue;
+        }
+        for (size_t c = 0; c < ARRAY_LEN(caps); c++) {
+            assert_true(calc_sum_reduce(a, n, caps[c]) == expected);
+        }
+        // Unaligned start and a single partial chunk
+        assert_true(calc_sum_reduce(a + 1, 1000, 0) == calc_sum_reduce(a + 1, 1000, 1));
+    }
+    calc_batch_set_isa(saved);
+    sdk_pool_set_size(0);
+
+    free(a);
+}
+
+static void check_scans(const int *a, size_t n, unsigned max_threads) {
+    int *out32 = malloc((n + 1) * sizeof(int));
+    int64_t *out64 = malloc((n + 1) * sizeof(int64_t));
+    assert_non_null(out32);
+    assert_non_null(out64);
+
+    calc_inclusive_scan(a, out32, n, max_threads);
+    calc_inclusive_scan64(a, out64, n, max_threads);
+    uint32_t sum32 = 0;
+    int64_t sum64 = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum32 += (uint32_t)a[i];
+        sum64 += a[i];
+        assert_int_equal(out32[i], (int)sum32);
+        assert_true(out64[i] == sum64);
+    }
+
+    calc_exclusive_scan(a, out32, n, max_threads);
+    calc_exclusive_scan64(a, out64, n, max_threads);
+    sum32 = 0;
+    sum64 = 0;
+    for (size_t i = 0; i < n; i++) {
+        assert_int_equal(out32[i], (int)sum32);
+        assert_true(out64[i] == sum64);
+        sum32 += (uint32_t)a[i];
+        sum64 += a[i];
+    }
+
+    free(out32);
+    free(out64);
+}
+
+static void test_calc_scan_small(void **state) {
+    (void)state;
+    int a[BATCH_LEN], b[BATCH_LEN];
+    fill_batch_inputs(a, b);
+
+    calc_isa_t saved = calc_batch_get_isa();
+    for (size_t k = 0; k < ARRAY_LEN(all_isas); k++) {
+        if (calc_batch_set_isa(all_isas[k]) != 0) {
+            continue;
+        }
+        for (size_t n = 0; n <= BATCH_LEN; n++) {
+            check_scans(a, n, 0);
+        }
+    }
+    calc_batch_set_isa(saved);
+
+    // Exclusive scan starts at 0
+    const int ones[] = { 1, 1, 1 };
+    int out[3];
+    calc_exclusive_scan(ones, out, 3, 0);
+    assert_int_equal(out[0], 0);
+    assert_int_equal(out[2], 2);
+}
+
+static void test_calc_scan_overflow(void **state) {
+    (void)state;
+    const int big[] = { INT32_MAX, 1, INT32_MAX, INT32_MAX, INT32_MIN, -1, 5, 6, 7, 8 };
+    int out32[ARRAY_LEN(big)];
+    int64_t out64[ARRAY_LEN(big)];
+
+    // int scans wrap, 64-bit scans stay exact
+    calc_inclusive_scan(big, out32, ARRAY_LEN(big), 1);
+    calc_inclusive_scan64(big, out64, ARRAY_LEN(big), 1);
+    assert_int_equal(out32[1], INT32_MIN);
+    assert_true(out64[1] == (int64_t)INT32_MAX + 1);
+    check_scans(big, ARRAY_LEN(big), 1);
+}
+
+static void test_calc_scan_large(void **state) {
+    (void)state;
+    // Several chunks with a ragged tail, run with real worker threads
+    const size_t n = 5 * 64 * 1024 + 77;
+    int *a = malloc(n * sizeof(int));
+    assert_non_null(a);
+    for (size_t i = 0; i < n; i++) {
+        a[i] = (i % 5 == 0) ? INT32_MAX : (int)(i % 333) - 200;
+    }
+
+    assert_int_equal(sdk_pool_set_size(4), 0);
+    const unsigned caps[] = { 1, 3, 0 };
+    for (size_t c = 0; c < ARRAY_LEN(caps); c++) {
+        check_scans(a, n, caps[c]);
+    }
+
+    // In place gives the same result as out of place
+    int *copy = malloc(n * sizeof(int));
+    assert_non_null(copy);
+    calc_inclusive_scan(a, copy, n, 0);
+    calc_inclusive_scan(a, a, n, 0);
+    assert_memory_equal(a, copy, n * sizeof(int));
+    sdk_pool_set_size(0);
+
+    free(copy);
+    free(a);
+}
+
+/*============================================================================
+ * Fixed point - Q16.16 / Q1.31 rounding, saturation and batch kernels
+ *===========================================================================*/
+
+static const calc_round_t all_modes[] = {
+    CALC_ROUND_TRUNC, CALC_ROUND_FLOOR, CALC_ROUND_NEAREST, CALC_ROUND_EVEN,
+};
+
+static void test_calc_fixed_rounding(void **state) {
+    (void)state;
+    // Products of k / 2^16 and 0.5: exact values k / 2 ulp, indexed by mode
+    const struct {
+        calc_q16_t a;
+        calc_q16_t expected[4];     /* TRUNC, FLOOR, NEAREST, EVEN */
+    } halves[] = {
+        { 1, { 0, 0, 1, 0 } },      /* 0.5 */
+        { -1, { 0, -1, -1, 0 } },   /* -0.5 */
+        { 3, { 1, 1, 2, 2 } },      /* 1.5 */
+        { -3, { -1, -2, -2, -2 } }, /* -1.5 */
+        { 4, { 2, 2, 2, 2 } },      /* exact */
+    };
+    for (size_t i = 0; i < ARRAY_LEN(halves); i++) {
+        for (size_t m = 0; m < ARRAY_LEN(all_modes); m++) {
+            assert_int_equal(calc_q16_multiply(halves[i].a, CALC_Q16_ONE / 2, all_modes[m]),
+                             halves[i].expected[m]);
+        }
+    }
+
+    // 2/3 and -2/3 = -43690.67 ulp
+    const calc_q16_t two = calc_q16_from_int(2), three = calc_q16_from_int(3);
+    const calc_q16_t pos[4] = { 43690, 43690, 43691, 43691 };
+    const calc_q16_t neg[4] = { -43690, -43691, -43691, -43691 };
+    for (size_t m = 0; m < ARRAY_LEN(all_modes); m++) {
+        assert_int_equal(calc_q16_divide(two, three, all_modes[m]), pos[m]);
+        assert_int_equal(calc_q16_divide(-two, three, all_modes[m]), neg[m]);
+        assert_int_equal(calc_q16_divide(two, -three, all_modes[m]), neg[m]);
+    }
+    // 1 / 2^17 = 0.5 ulp
+    const calc_q16_t tie[4] = { 0, 0, 1, 0 };
+    for (size_t m = 0; m < ARRAY_LEN(all_modes); m++) {
+        assert_int_equal(calc_q16_divide(1, calc_q16_from_int(2), all_modes[m]), tie[m]);
+    }
+
+    assert_int_equal(calc_q16_to_int(calc_q16_from_double(-2.5), CALC_ROUND_TRUNC), -2);
+    assert_int_equal(calc_q16_to_int(calc_q16_from_double(-2.5), CALC_ROUND_FLOOR), -3);
+    assert_int_equal(calc_q16_to_int(calc_q16_from_double(-2.5), CALC_ROUND_NEAREST), -3);
+    assert_int_equal(calc_q16_to_int(calc_q16_from_double(-2.5), CALC_ROUND_EVEN), -2);
+}
+
+static void test_calc_fixed_values(void **state) {
+    (void)state;
+    const calc_q16_t a = calc_q16_from_double(1.5), b = calc_q16_from_double(-2.25);
+    assert_true(calc_q16_to_double(calc_q16_multiply(a, b, CALC_ROUND_NEAREST)) == -3.375);
+    assert_true(calc_q16_to_double(calc_q16_divide(b, a, CALC_ROUND_NEAREST)) == -1.5);
+    assert_true(calc_q16_to_double(calc_fixed_add(a, b)) == -0.75);
+
+    const calc_q31_t half = calc_q31_from_double(0.5), quarter = calc_q31_from_double(-0.25);
+    assert_int_equal(half, 1 << 30);
+    assert_true(calc_q31_to_double(calc_q31_multiply(half, quarter, CALC_ROUND_NEAREST)) == -0.125);
+    assert_true(calc_q31_to_double(calc_q31_divide(quarter, half, CALC_ROUND_NEAREST)) == -0.5);
+
+    // Divide by zero returns 0, like calc_divide
+    assert_int_equal(calc_q16_divide(a, 0, CALC_ROUND_NEAREST), 0);
+    assert_int_equal(calc_q31_divide(half, 0, CALC_ROUND_FLOOR), 0);
+
+    // Saturation instead of wrapping
+    assert_int_equal(calc_q16_from_int(40000), CALC_Q16_MAX);
+    assert_int_equal(calc_q16_from_int(-40000), CALC_Q16_MIN);
+    assert_int_equal(calc_q16_multiply(calc_q16_from_int(300), calc_q16_from_int(300), CALC_ROUND_TRUNC),
+                     CALC_Q16_MAX);
+    assert_int_equal(calc_q16_multiply(calc_q16_from_int(-300), calc_q16_from_int(300), CALC_ROUND_TRUNC),
+                     CALC_Q16_MIN);
+    assert_int_equal(calc_q16_divide(calc_q16_from_int(30000), 1, CALC_ROUND_TRUNC), CALC_Q16_MAX);
+    assert_int_equal(calc_q31_multiply(CALC_Q31_MIN, CALC_Q31_MIN, CALC_ROUND_FLOOR), CALC_Q31_MAX);
+    assert_int_equal(calc_q31_divide(half, quarter, CALC_ROUND_FLOOR), CALC_Q31_MIN);
+    assert_int_equal(calc_q31_divide(CALC_Q31_MIN, CALC_Q31_MIN, CALC_ROUND_FLOOR), CALC_Q31_MAX);
+    assert_int_equal(calc_q31_divide(CALC_Q31_MIN, CALC_Q31_MAX, CALC_ROUND_TRUNC), CALC_Q31_MIN);
+    assert_int_equal(calc_q31_divide(half, half, CALC_ROUND_TRUNC), CALC_Q31_MAX);    // 1 saturates
+    assert_int_equal(calc_q31_divide(half, -half, CALC_ROUND_EVEN), CALC_Q31_MIN);    // -1 is exact
+    assert_int_equal(calc_fixed_add(INT32_MAX, 1), INT32_MAX);
+    assert_int_equal(calc_fixed_add(INT32_MIN, -1), INT32_MIN);
+    assert_int_equal(calc_fixed_subtract(INT32_MIN, 1), INT32_MIN);
+    assert_int_equal(calc_fixed_subtract(0, INT32_MIN), INT32_MAX);
+    assert_int_equal(calc_q31_from_double(1.0), CALC_Q31_MAX);
+    assert_int_equal(calc_q31_from_double(-1.0), CALC_Q31_MIN);
+    assert_int_equal(calc_q16_from_double(0.0 / 0.0), 0);
+}
+
+static void test_calc_fixed_batch(void **state) {
+    (void)state;
+    enum { LEN = 101 };
+    int32_t a[LEN], b[LEN], out[LEN], expected[LEN];
+    uint32_t seed = 7;
+    for (int i = 0; i < LEN; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        a[i] = (int32_t)seed >> (i % 17);           /* every magnitude */
+        seed = seed * 1664525u + 1013904223u;
+        b[i] = (int32_t)seed >> (i % 13);
+    }
+    // Extremes, ties and zero divisors
+    const int32_t edges[][2] = {
+        { INT32_MIN, INT32_MIN }, { INT32_MAX, INT32_MAX }, { INT32_MIN, INT32_MAX },
+        { INT32_MAX, -1 }, { 1, 1 << 15 }, { -1, 1 << 15 }, { 3, 1 << 30 }, { -3, 1 << 30 },
+        { 12345, 0 }, { 0, 0 },
+    };
+    for (size_t i = 0; i < ARRAY_LEN(edges); i++) {
+        a[i * 3] = edges[i][0];
+        b[i * 3] = edges[i][1];
+    }
+
+    calc_isa_t saved = calc_batch_get_isa();
+    for (size_t k = 0; k < ARRAY_LEN(all_isas); k++) {
+        if (calc_batch_set_isa(all_isas[k]) != 0) {
+            continue;
+        }
+        for (int i = 0; i < LEN; i++) {
+            expected[i] = calc_fixed_add(a[i], b[i]);
+        }
+        calc_fixed_add_n(a, b, out, LEN);
+        assert_memory_equal(out, expected, sizeof(out));
+        for (int i = 0; i < LEN; i++) {
+            expected[i] = calc_fixed_subtract(a[i], b[i]);
+        }
+        calc_fixed_subtract_n(a, b, out, LEN);
+        assert_memory_equal(out, expected, sizeof(out));
+
+        for (size_t m = 0; m < ARRAY_LEN(all_modes); m++) {
+            calc_round_t mode = all_modes[m];
+            for (int i = 0; i < LEN; i++) {
+                expected[i] = calc_q16_multiply(a[i], b[i], mode);
+            }
+            calc_q16_multiply_n(a, b, out, LEN, mode);
+            assert_memory_equal(out, expected, sizeof(out));
+            for (int i = 0; i < LEN; i++) {
+                expected[i] = calc_q31_multiply(a[i], b[i], mode);
+            }
+            calc_q31_multiply_n(a, b, out, LEN, mode);
+            assert_memory_equal(out, expected, sizeof(out));
+            for (int i = 0; i < LEN; i++) {
+                expected[i] = calc_q16_divide(a[i], b[i], mode);
+            }
+            calc_q16_divide_n(a, b, out, LEN, mode);
+            assert_memory_equal(out, expected, sizeof(out));
+            for (int i = 0; i < LEN; i++) {
+                expected[i] = calc_q31_divide(a[i], b[i], mode);
+            }
+            calc_q31_divide_n(a, b, out, LEN, mode);
+            assert_memory_equal(out, expected, sizeof(out));
+        }
+
+        // In place
+        for (int i = 0; i < LEN; i++) {
+            expected[i] = calc_q16_multiply(a[i], b[i], CALC_ROUND_EVEN);
+            out[i] = a[i];
+        }
+        calc_q16_multiply_n(out, b, out, LEN, CALC_ROUND_EVEN);
+        assert_memory_equal(out, expected, sizeof(out));
+    }
+    calc_batch_set_isa(saved);
+}
+
+/*============================================================================
+ * Bigint - 64-bit limbs, Karatsuba, long division
+ *===========================================================================*/
+
+static void int128_to_string(__int128 v, char *buf) {
+    char tmp[48];
+    int n = 0;
+    unsigned __int128 mag = v < 0 ? -(unsigned __int128)v : (unsigned __int128)v;
+    do {
+        tmp[n++] = (char)('0' + (int)(mag % 10));
+        mag /= 10;
+    } while (mag != 0);
+    if (v < 0) {
+        tmp[n++] = '-';
+    }
+    for (int i = 0; i < n; i++) {
+        buf[i] = tmp[n - 1 - i];
+    }
+    buf[n] = '\0';
+}
+
+static void assert_bigint_equals_int128(const calc_bigint_t *x, __int128 v) {
+    char got[64], expected[64];
+    assert_true(calc_bigint_to_string(x, got, sizeof(got)) < (int)sizeof(got));
+    int128_to_string(v, expected);
+    assert_string_equal(got, expected);
+}
+
+// Random value of about nlimbs 64-bit limbs, built with the public API only
+static void random_bigint(calc_bigint_t *x, size_t nlimbs, uint64_t *seed) {
+    calc_bigint_t shift, part;
+    calc_bigint_init(&shift);
+    calc_bigint_init(&part);
+    calc_bigint_from_int64(&shift, (int64_t)1 << 32);
+    calc_bigint_from_int(x, 0);
+    for (size_t i = 0; i < 2 * nlimbs; i++) {
+        *seed = *seed * 6364136223846793005ull + 1442695040888963407ull;
+        calc_bigint_from_int64(&part, (int64_t)(*seed >> 32));
+        assert_int_equal(calc_bigint_multiply(x, x, &shift), 0);
+        assert_int_equal(calc_bigint_add(x, x, &part), 0);
+    }
+    if (*seed & 1) {
+        calc_bigint_t zero;
+        calc_bigint_init(&zero);
+        assert_int_equal(calc_bigint_subtract(x, &zero, x), 0);
+    }
+    calc_bigint_free(&shift);
+    calc_bigint_free(&part);
+}
+
+static void test_calc_bigint_small(void **state) {
+    (void)state;
+    calc_bigint_t a, b, r;
+    calc_bigint_init(&a);
+    calc_bigint_init(&b);
+    calc_bigint_init(&r);
+
+    // int round trip and overflow detection
+    int out;
+    calc_bigint_from_int(&a, INT32_MIN);
+    assert_int_equal(calc_bigint_to_int(&a, &out), 0);
+    assert_int_equal(out, INT32_MIN);
+    calc_bigint_from_int(&b, -1);
+    assert_int_equal(calc_bigint_multiply(&r, &a, &b), 0);
+    assert_int_equal(calc_bigint_to_int(&r, &out), -1);
+    assert_int_equal(out, INT32_MIN);   /* wrapped, like the batch API */
+    int64_t out64;
+    assert_int_equal(calc_bigint_to_int64(&r, &out64), 0);
+    assert_true(out64 == 2147483648LL);
+
+    // Exact results where int arithmetic overflows; small values stay inline
+    uint64_t seed = 42;
+    for (int i = 0; i < 2000; i++) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        int64_t x = (int64_t)seed >> (i % 40);
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        int64_t y = (int64_t)seed >> (i % 23);
+        if (i < 4) {
+            x = i & 1 ? INT64_MIN : INT64_MAX;
+            y = i & 2 ? INT64_MIN : -1;
+        }
+        calc_bigint_from_int64(&a, x);
+        calc_bigint_from_int64(&b, y);
+        assert_int_equal(calc_bigint_add(&r, &a, &b), 0);
+        assert_bigint_equals_int128(&r, (__int128)x + y);
+        assert_int_equal(calc_bigint_subtract(&r, &a, &b), 0);
+        assert_bigint_equals_int128(&r, (__int128)x - y);
+        assert_int_equal(calc_bigint_multiply(&r, &a, &b), 0);
+        assert_bigint_equals_int128(&r, (__int128)x * y);
+        assert_int_equal(r.cap, CALC_BIGINT_INLINE_LIMBS);
+
+        calc_bigint_t q, rem;
+        calc_bigint_init(&q);
+        calc_bigint_init(&rem);
+        if (y != 0) {
+            assert_int_equal(calc_bigint_divide(&q, &rem, &r, &b), 0);
+            assert_int_equal(calc_bigint_cmp(&q, &a), 0);
+            assert_int_equal(calc_bigint_sign(&rem), 0);
+        }
+        assert_int_equal(calc_bigint_divide(&q, &rem, &a, &b), 0);
+        if (y != 0 && !(x == INT64_MIN && y == -1)) {
+            assert_bigint_equals_int128(&q, x / y);
+            assert_bigint_equals_int128(&rem, x % y);
+        }
+        assert_int_equal(calc_bigint_cmp(&a, &b), x < y ? -1 : x > y);
+    }
+
+    // Divide by zero gives 0
+    calc_bigint_from_int(&b, 0);
+    assert_int_equal(calc_bigint_divide(&a, &r, &a, &b), 0);
+    assert_int_equal(calc_bigint_sign(&a), 0);
+    assert_int_equal(calc_bigint_sign(&r), 0);
+
+    // snprintf-style formatting
+    char buf[8];
+    calc_bigint_from_int64(&a, -1234567890123LL);
+    assert_int_equal(calc_bigint_to_string(&a, buf, sizeof(buf)), 14);
+    assert_string_equal(buf, "-123456");
+    assert_int_equal(calc_bigint_to_string(&a, NULL, 0), 14);
+    calc_bigint_from_int(&a, 0);
+    assert_int_equal(calc_bigint_to_string(&a, buf, sizeof(buf)), 1);
+    assert_string_equal(buf, "0");
+
+    calc_bigint_free(&a);
+    calc_bigint_free(&b);
+    calc_bigint_free(&r);
+}
+
+static void test_calc_bigint_large(void **state) {
+    (void)state;
+    calc_bigint_t a, b, school, kara, q, rem, check;
+    calc_bigint_init(&a);
+    calc_bigint_init(&b);
+    calc_bigint_init(&school);
+    calc_bigint_init(&kara);
+    calc_bigint_init(&q);
+    calc_bigint_init(&rem);
+    calc_bigint_init(&check);
+
+    // 2^64 and 2^192 - 1 have known decimal forms
+    char buf[80];
+    calc_bigint_from_int64(&a, (int64_t)1 << 32);
+    assert_int_equal(calc_bigint_multiply(&a, &a, &a), 0);
+    calc_bigint_to_string(&a, buf, sizeof(buf));
+    assert_string_equal(buf, "18446744073709551616");
+    assert_int_equal(calc_bigint_multiply(&b, &a, &a), 0);
+    assert_int_equal(calc_bigint_multiply(&b, &b, &a), 0);
+    calc_bigint_from_int(&check, 1);
+    assert_int_equal(calc_bigint_subtract(&b, &b, &check), 0);
+    calc_bigint_to_string(&b, buf, sizeof(buf));
+    assert_string_equal(buf, "6277101735386680763835789423207666416102355444464034512895");
+
+    const size_t sizes[][2] = {
+        { 1, 1 }, { 3, 2 }, { 5, 5 }, { 17, 9 }, { 40, 40 }, { 64, 33 }, { 100, 7 }, { 130, 61 },
+    };
+    uint64_t seed = 7;
+    for (size_t i = 0; i < ARRAY_LEN(sizes); i++) {
+        for (int rep = 0; rep < 3; rep++) {
+            random_bigint(&a, sizes[i][0], &seed);
+            random_bigint(&b, sizes[i][1], &seed);
+
+            // Karatsuba at a low and the default threshold matches schoolbook
+            calc_bigint_set_karatsuba_threshold(SIZE_MAX);
+            assert_int_equal(calc_bigint_multiply(&school, &a, &b), 0);
+            const size_t thresholds[] = { 4, 0 };
+            for (size_t t = 0; t < ARRAY_LEN(thresholds); t++) {
+                calc_bigint_set_karatsuba_threshold(thresholds[t]);
+                assert_int_equal(calc_bigint_multiply(&kara, &a, &b), 0);
+                assert_int_equal(calc_bigint_cmp(&kara, &school), 0);
+            }
+            assert_int_equal(calc_bigint_karatsuba_threshold(), CALC_BIGINT_KARATSUBA_THRESHOLD);
+
+            // q * b + rem == dividend, rem has the dividend's sign and |rem| < |b|
+            const calc_bigint_t *dividends[] = { &school, &a };
+            for (size_t d = 0; d < ARRAY_LEN(dividends); d++) {
+                assert_int_equal(calc_bigint_divide(&q, &rem, dividends[d], &b), 0);
+                assert_int_equal(calc_bigint_multiply(&check, &q, &b), 0);
+                assert_int_equal(calc_bigint_add(&check, &check, &rem), 0);
+                assert_int_equal(calc_bigint_cmp(&check, dividends[d]), 0);
+                assert_true(calc_bigint_sign(&rem) == 0 ||
+                            calc_bigint_sign(&rem) == calc_bigint_sign(dividends[d]));
+                calc_bigint_t abs_rem, abs_b, zero;
+                calc_bigint_init(&abs_rem);
+                calc_bigint_init(&abs_b);
+                calc_bigint_init(&zero);
+                assert_int_equal(calc_bigint_sign(&rem) < 0 ? calc_bigint_subtract(&abs_rem, &zero, &rem)
+                                                            : calc_bigint_copy(&abs_rem, &rem), 0);
+                assert_int_equal(calc_bigint_sign(&b) < 0 ? calc_bigint_subtract(&abs_b, &zero, &b)
+                                                          : calc_bigint_copy(&abs_b, &b), 0);
+                assert_int_equal(calc_bigint_cmp(&abs_rem, &abs_b), -1);
+                calc_bigint_free(&abs_rem);
+                calc_bigint_free(&abs_b);
+            }
+            // a * b / b == a exactly
+            assert_int_equal(calc_bigint_divide(&q, NULL, &school, &b), 0);
+            assert_int_equal(calc_bigint_cmp(&q, &a), 0);
+        }
+    }
+    calc_bigint_set_karatsuba_threshold(0);
+
+    // Results may alias the operands
+    random_bigint(&a, 20, &seed);
+    assert_int_equal(calc_bigint_copy(&check, &a), 0);
+    assert_int_equal(calc_bigint_multiply(&school, &a, &a), 0);
+    assert_int_equal(calc_bigint_multiply(&a, &a, &a), 0);
+    assert_int_equal(calc_bigint_cmp(&a, &school), 0);
+    assert_int_equal(calc_bigint_divide(&a, NULL, &a, &check), 0);
+    assert_int_equal(calc_bigint_cmp(&a, &check), 0);
+    assert_int_equal(calc_bigint_subtract(&a, &a, &a), 0);
+    assert_int_equal(calc_bigint_sign(&a), 0);
+
+    calc_bigint_free(&a);
+    calc_bigint_free(&b);
+    calc_bigint_free(&school);
+    calc_bigint_free(&kara);
+    calc_bigint_free(&q);
+    calc_bigint_free(&rem);
+    calc_bigint_free(&check);
+}
+
+/*============================================================================
+ * Matrix multiply - blocked kernels against the naive loop
+ *===========================================================================*/
+
+// Exact product in the test, independent of the SDK
+static void naive_matrix64(const int *a, const int *b, int64_t *c, size_t m, size_t n, size_t k) {
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            uint64_t sum = 0;
+            for (size_t p = 0; p < k; p++) {
+                sum += (uint64_t)((int64_t)a[i * k + p] * b[p * n + j]);
+            }
+            c[i * n + j] = (int64_t)sum;
+        }
+    }
+}
+
+static void fill_matrix(int *x, size_t len, uint32_t seed, uint32_t range) {
+    for (size_t i = 0; i < len; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        x[i] = range == 0 ? (int)seed : (int)(seed % (2 * range + 1)) - (int)range;
+    }
+}
+
+static void test_calc_matrix_small(void **state) {
+    (void)state;
+    // Around the 6 x 16 / 6 x 8 register tiles
+    const size_t dims[] = { 1, 5, 6, 7, 16, 17, 33 };
+    const size_t max = 33;
+    int a[33 * 33], b[33 * 33], c[33 * 33], expected[33 * 33];
+    int64_t c64[33 * 33];
+    fill_matrix(a, max * max, 1, 100);
+    fill_matrix(b, max * max, 2, 100);
+
+    calc_isa_t saved = calc_batch_get_isa();
+    for (size_t im = 0; im < ARRAY_LEN(dims); im++) {
+        for (size_t in = 0; in < ARRAY_LEN(dims); in++) {
+            for (size_t ik = 0; ik < ARRAY_LEN(dims); ik++) {
+                size_t m = dims[im], n = dims[in], k = dims[ik];
+                calc_matrix_multiply_ref(a, b, expected, m, n, k);
+                for (size_t s = 0; s < ARRAY_LEN(all_isas); s++) {
+                    if (calc_batch_set_isa(all_isas[s]) != 0) {
+                        continue;
+                    }
+                    calc_matrix_multiply(a, b, c, m, n, k, 1);
+                    assert_memory_equal(c, expected, m * n * sizeof(int));
+                    calc_matrix_multiply64(a, b, c64, m, n, k, 1);
+                    for (size_t i = 0; i < m * n; i++) {
+                        assert_int_equal(c64[i], expected[i]);
+                    }
+                }
+            }
+        }
+    }
+    calc_batch_set_isa(saved);
+
+    // k == 0 is the zero matrix, empty outputs are left alone
+    c[0] = 42;
+    calc_matrix_multiply(a, b, c, 1, 1, 0, 0);
+    assert_int_equal(c[0], 0);
+    c64[0] = 42;
+    calc_matrix_multiply64(a, b, c64, 1, 1, 0, 0);
+    assert_int_equal(c64[0], 0);
+    c[0] = 42;
+    calc_matrix_multiply(a, b, c, 0, 5, 5, 0);
+    calc_matrix_multiply(a, b, c, 5, 0, 5, 0);
+    assert_int_equal(c[0], 42);
+}
+
+static void test_calc_matrix_blocked(void **state) {
+    (void)state;
+    // Crosses the 96-row, 256-column and 256-deep blocks with ragged edges
+    const size_t m = 100, n = 270, k = 300;
+    int *a = malloc(m * k * sizeof(int));
+    int *b = malloc(k * n * sizeof(int));
+    int *c = malloc(m * n * sizeof(int));
+    int64_t *c64 = malloc(m * n * sizeof(int64_t));
+    int64_t *expected = malloc(m * n * sizeof(int64_t));
+    assert_true(a && b && c && c64 && expected);
+
+    calc_isa_t saved = calc_batch_get_isa();
+    for (int pass = 0; pass < 2; pass++) {
+        // Pass 0: int64 stays exact. Pass 1: full-range values, int32 wraps.
+        fill_matrix(a, m * k, 3, pass == 0 ? 1u << 20 : 0);
+        fill_matrix(b, k * n, 4, pass == 0 ? 1u << 20 : 0);
+        naive_matrix64(a, b, expected, m, n, k);
+        for (size_t s = 0; s < ARRAY_LEN(all_isas); s++) {
+            if (calc_batch_set_isa(all_isas[s]) != 0) {
+                continue;
+            }
+            calc_matrix_multiply(a, b, c, m, n, k, 1);
+            calc_matrix_multiply64(a, b, c64, m, n, k, 1);
+            for (size_t i = 0; i < m * n; i++) {
+                assert_int_equal(c[i], (int)(uint32_t)expected[i]);
+            }
+            assert_memory_equal(c64, expected, m * n * sizeof(int64_t));
+        }
+    }
+
+    // INT32_MIN * INT32_MIN is 2^62: exact for k == 1, two of them wrap to INT64_MIN
+    const int mins[] = { INT32_MIN, INT32_MIN };
+    for (size_t s = 0; s < ARRAY_LEN(all_isas); s++) {
+        if (calc_batch_set_isa(all_isas[s]) != 0) {
+            continue;
+        }
+        calc_matrix_multiply64(mins, mins, c64, 1, 1, 1, 1);
+        assert_true(c64[0] == (int64_t)1 << 62);
+        calc_matrix_multiply64(mins, mins, c64, 1, 1, 2, 1);
+        assert_true(c64[0] == INT64_MIN);
+    }
+    calc_batch_set_isa(saved);
+
+    free(a);
+    free(b);
+    free(c);
+    free(c64);
+    free(expected);
+}
+
+static void test_calc_matrix_threads(void **state) {
+    (void)state;
+    const size_t m = 200, n = 520, k = 64;  // 3 x 3 output tiles
+    int *a = malloc(m * k * sizeof(int));
+    int *b = malloc(k * n * sizeof(int));
+    int *c = malloc(m * n * sizeof(int));
+    int *serial = malloc(m * n * sizeof(int));
+    int64_t *c64 = malloc(m * n * sizeof(int64_t));
+    int64_t *serial64 = malloc(m * n * sizeof(int64_t));
+    assert_true(a && b && c && serial && c64 && serial64);
+    fill_matrix(a, m * k, 5, 0);
+    fill_matrix(b, k * n, 6, 0);
+
+    assert_int_equal(sdk_pool_set_size(4), 0);
+    calc_matrix_multiply(a, b, serial, m, n, k, 1);
+    calc_matrix_multiply64(a, b, serial64, m, n, k, 1);
+    const unsigned caps[] = { 2, 4, 0 };
+    for (size_t t = 0; t < ARRAY_LEN(caps); t++) {
+        memset(c, 0, m * n * sizeof(int));
+        calc_matrix_multiply(a, b, c, m, n, k, caps[t]);
+        assert_memory_equal(c, serial, m * n * sizeof(int));
+        memset(c64, 0, m * n * sizeof(int64_t));
+        calc_matrix_multiply64(a, b, c64, m, n, k, caps[t]);
+        assert_memory_equal(c64, serial64, m * n * sizeof(int64_t));
+    }
+    sdk_pool_set_size(0);
+
+    free(a);
+    free(b);
+    free(c);
+    free(serial);
+    free(c64);
+    free(serial64);
+}
+
+/*============================================================================
+ * Columns - owned, view and mapped storage with validity
+ *===========================================================================*/
+
+static void test_calc_column_storage(void **state) {
+    (void)state;
+    const unsigned flags[] = { 0, CALC_COLUMN_HUGEPAGES };
+
+    for (size_t k = 0; k < ARRAY_LEN(flags); k++) {
+        calc_column_t col;
+        assert_int_equal(calc_column_init(&col, 1000, flags[k]), 0);
+        assert_int_equal((uintptr_t)col.data % CALC_COLUMN_ALIGN, 0);
+        assert_int_equal(col.len, 1000);
+        assert_true(col.capacity >= 1000);
+        assert_null(col.validity);
+        for (size_t i = 0; i < col.len; i++) {
+            col.data[i] = (int)i;
+        }
+        assert_true(calc_column_sum(&col, 0, NULL) == 999 * 1000 / 2);
+        calc_column_free(&col);
+        assert_null(col.data);
+    }
+}
+
+static void test_calc_column_arithmetic(void **state) {
+    (void)state;
+    int a[BATCH_LEN], b[BATCH_LEN], expected[BATCH_LEN];
+    uint8_t valid_b[(BATCH_LEN + 7) / 8];
+    fill_batch_inputs(a, b);
+    memset(valid_b, 0xFF, sizeof(valid_b));
+    valid_b[1] = 0x0F;  // rows 12..15 null
+
+    calc_column_t ca, cb, out;
+    calc_column_view(&ca, a, BATCH_LEN, NULL);
+    calc_column_view(&cb, b, BATCH_LEN, valid_b);
+    assert_int_equal(calc_column_init(&out, BATCH_LEN, 0), 0);
+
+    assert_int_equal(calc_column_multiply(&ca, &cb, &out), 0);
+    calc_multiply_n(a, b, expected, BATCH_LEN);
+    assert_memory_equal(out.data, expected, sizeof(expected));
+    assert_int_equal(calc_column_null_count(&out), 4);
+    assert_false(calc_column_is_valid(&out, 12));
+    assert_true(calc_column_is_valid(&out, 16));
+
+    // In place: the view keeps pointing at the caller's array
+    int doubled[BATCH_LEN];
+    calc_add_n(a, a, doubled, BATCH_LEN);
+    assert_int_equal(calc_column_add(&ca, &ca, &ca), 0);
+    assert_memory_equal(a, doubled, sizeof(doubled));
+    calc_column_free(&out);
+}
+
+static void test_calc_column_errors(void **state) {
+    (void)state;
+    int a[8] = { 0 }, b[7] = { 0 };
+    uint8_t valid[1] = { 0xFE };
+    calc_column_t ca, cb, out, nullable;
+    calc_column_view(&ca, a, 8, NULL);
+    calc_column_view(&cb, b, 7, NULL);
+    calc_column_view(&out, b, 7, NULL);
+    calc_column_view(&nullable, a, 8, valid);
+
+    assert_int_equal(calc_column_add(&ca, &cb, &out), -1);        // length mismatch
+    assert_int_equal(calc_column_add(&ca, &ca, &out), -1);        // out too small
+    assert_int_equal(calc_column_add(&nullable, &ca, &ca), -1);   // view can't get a bitmap
+    assert_int_equal(calc_column_set_valid(&ca, 0, 0), -1);
+    assert_int_equal(calc_column_set_valid(&nullable, 0, 1), 0);
+    assert_int_equal(calc_column_null_count(&nullable), 0);
+}
+
+static void test_calc_column_map_file(void **state) {
+    (void)state;
+    char path[] = "/tmp/calc_column_XXXXXX";
+    int fd = mkstemp(path);
+    assert_true(fd >= 0);
+    FILE *f = fdopen(fd, "wb");
+    assert_non_null(f);
+    for (int i = 0; i < 5000; i++) {
+        assert_int_equal(fwrite(&i, sizeof(i), 1, f), 1);
+    }
+    fclose(f);
+
+    calc_column_t col, out;
+    // Unaligned offset into the file: rows 1000..4999
+    assert_int_equal(calc_column_map_file(&col, path, 1000 * sizeof(int), 0), 0);
+    assert_int_equal(col.len, 4000);
+    assert_int_equal(col.data[0], 1000);
+    assert_true(calc_column_sum(&col, 0, NULL) == (int64_t)(1000 + 4999) * 4000 / 2);
+    assert_true(col.flags & CALC_COLUMN_READONLY);
+    assert_int_equal(calc_column_add(&col, &col, &col), -1);
+
+    assert_int_equal(calc_column_init(&out, col.len, 0), 0);
+    assert_int_equal(calc_column_add(&col, &col, &out), 0);
+    assert_int_equal(out.data[3999], 2 * 4999);
+    calc_column_free(&out);
+    calc_column_free(&col);
+
+    assert_int_equal(calc_column_map_file(&col, path, 0, 5001), -1);  // too short
+    assert_int_equal(calc_column_map_file(&col, path, 2, 0), -1);     // misaligned
+    unlink(path);
+    assert_int_equal(calc_column_map_file(&col, path, 0, 0), -1);
+}
+
+static void test_calc_column_sum_with_nulls(void **state) {
+    (void)state;
+    // Several pool chunks, nulls spread over full and partial bitmap bytes
+    const size_t n = 3 * 64 * 1024 + 13;
+    calc_column_t col;
+    assert_int_equal(calc_column_init(&col, n, 0), 0);
+
+    int64_t expected = 0;
+    size_t expected_rows = 0;
+    for (size_t i = 0; i < n; i++) {
+        col.data[i] = (int)(i % 1000) - 300;
+        int valid = (i % 97 != 0) && (i < 1000 || i > 1100);
+        assert_int_equal(calc_column_set_valid(&col, i, valid), 0);
+        if (valid) {
+            expected += col.data[i];
+            expected_rows++;
+        }
+    }
+    assert_int_equal(calc_column_null_count(&col), n - expected_rows);
+
+    assert_int_equal(sdk_pool_set_size(4), 0);
+    const unsigned caps[] = { 1, 0 };
+    for (size_t c = 0; c < ARRAY_LEN(caps); c++) {
+        size_t rows = 0;
+        assert_true(calc_column_sum(&col, caps[c], &rows) == expected);
+        assert_int_equal(rows, expected_rows);
+    }
+    sdk_pool_set_size(0);
+    calc_column_free(&col);
+}
+
 /*============================================================================
  * Parameterized Test - Using prestate
  *===========================================================================*/
@@ -177,6 +1408,70 @@ int main(void) {
         cmocka_unit_test(test_calc_divide_negative_numbers),
     };
 
+    const struct CMUnitTest calc_batch_tests[] = {
+        cmocka_unit_test(test_calc_add_n),
+        cmocka_unit_test(test_calc_subtract_n),
+        cmocka_unit_test(test_calc_multiply_n),
+        cmocka_unit_test(test_calc_divide_n),
+        cmocka_unit_test(test_calc_divide_n_by_zero_lanes),
+        cmocka_unit_test(test_calc_batch_isa_selection),
+    };
+
+    const struct CMUnitTest calc_divider_tests[] = {
+        cmocka_unit_test(test_calc_divider_matches_divide),
+        cmocka_unit_test(test_calc_divider_int_min_dividend),
+        cmocka_unit_test(test_calc_divider_by_zero),
+        cmocka_unit_test(test_calc_divider_divide_n),
+    };
+
+    const struct CMUnitTest calc_overflow_tests[] = {
+        cmocka_unit_test(test_calc_checked_no_overflow),
+        cmocka_unit_test(test_calc_checked_overflow),
+        cmocka_unit_test(test_calc_checked_divide_by_zero),
+        cmocka_unit_test(test_calc_saturating),
+        cmocka_unit_test(test_calc_sat_n),
+    };
+
+    const struct CMUnitTest calc_inline_tests[] = {
+        cmocka_unit_test(test_calc_inline_matches_out_of_line),
+    };
+
+    const struct CMUnitTest calc_reduce_tests[] = {
+        cmocka_unit_test(test_sdk_pool_runs_every_task_once),
+        cmocka_unit_test(test_sdk_sched_runs_every_index_once),
+        cmocka_unit_test(test_sdk_sched_deterministic_output),
+        cmocka_unit_test(test_calc_sum_reduce_small),
+        cmocka_unit_test(test_calc_sum_reduce_large),
+        cmocka_unit_test(test_calc_scan_small),
+        cmocka_unit_test(test_calc_scan_overflow),
+        cmocka_unit_test(test_calc_scan_large),
+    };
+
+    const struct CMUnitTest calc_column_tests[] = {
+        cmocka_unit_test(test_calc_column_storage),
+        cmocka_unit_test(test_calc_column_arithmetic),
+        cmocka_unit_test(test_calc_column_errors),
+        cmocka_unit_test(test_calc_column_map_file),
+        cmocka_unit_test(test_calc_column_sum_with_nulls),
+    };
+
+    const struct CMUnitTest calc_fixed_tests[] = {
+        cmocka_unit_test(test_calc_fixed_rounding),
+        cmocka_unit_test(test_calc_fixed_values),
+        cmocka_unit_test(test_calc_fixed_batch),
+    };
+
+    const struct CMUnitTest calc_bigint_tests[] = {
+        cmocka_unit_test(test_calc_bigint_small),
+        cmocka_unit_test(test_calc_bigint_large),
+    };
+
+    const struct CMUnitTest calc_matrix_tests[] = {
+        cmocka_unit_test(test_calc_matrix_small),
+        cmocka_unit_test(test_calc_matrix_blocked),
+        cmocka_unit_test(test_calc_matrix_threads),
+    };
+
     // Parameterized tests using prestate
     const struct CMUnitTest calc_parameterized_tests[] = {
         cmocka_unit_test_prestate(test_calc_add_parameterized, &add_test_data[0]),
@@ -195,6 +1490,15 @@ int main(void) {
     result += cmocka_run_group_tests_name("calc_subtract tests", calc_subtract_tests, NULL, NULL);
     result += cmocka_run_group_tests_name("calc_multiply tests", calc_multiply_tests, NULL, NULL);
     result += cmocka_run_group_tests_name("calc_divide tests", calc_divide_tests, NULL, NULL);
+    result += cmocka_run_group_tests_name("calc batch tests", calc_batch_tests, NULL, NULL);
+    result += cmocka_run_group_tests_name("calc divider tests", calc_divider_tests, NULL, NULL);
+    result += cmocka_run_group_tests_name("calc overflow tests", calc_overflow_tests, NULL, NULL);
+    result += cmocka_run_group_tests_name("calc inline tests", calc_inline_tests, NULL, NULL);
+    result += cmocka_run_group_tests_name("calc reduction tests", calc_reduce_tests, NULL, NULL);
+    result += cmocka_run_group_tests_name("calc column tests", calc_column_tests, NULL, NULL);
+    result += cmocka_run_group_tests_name("calc fixed-point tests", calc_fixed_tests, NULL, NULL);
+    result += cmocka_run_group_tests_name("calc bigint tests", calc_bigint_tests, NULL, NULL);
+    result += cmocka_run_group_tests_name("calc matrix tests", calc_matrix_tests, NULL, NULL);
     result += cmocka_run_group_tests_name("calc_add parameterized tests", calc_parameterized_tests, NULL, NULL);
 
     return result;
@@ -8,15 +8,21 @@
  * - String assertions (assert_string_equal)
  * - Pointer assertions (assert_non_null, assert_null)
  * - Memory allocation in tests
+ * - Wrapping a libc call (--wrap=writev) to inject short writes and EINTR
  */
 
 #include <stdarg.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <setjmp.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/uio.h>
 #include <cmocka.h>
 
 #include "greeting.h"
@@ -209,6 +215,380 @@ static void test_greeting_return_not_null(void **state) {
     assert_non_null(say_goodbye(NULL));
 }
 
+/*============================================================================
+ * Reentrant API - caller buffer, length return
+ *===========================================================================*/
+
+static void test_say_hello_r_writes_message(void **state) {
+    (void)state;
+    char buf[64];
+
+    assert_int_equal(say_hello_r("Alice", GREETING_NAME_STRLEN, buf, sizeof(buf)), 13);
+    assert_string_equal(buf, "Hello, Alice!");
+    assert_int_equal(say_goodbye_r("Alice", GREETING_NAME_STRLEN, buf, sizeof(buf)), 15);
+    assert_string_equal(buf, "Goodbye, Alice!");
+
+    // Same text as the legacy functions, including the stranger default
+    const char *names[] = { "Bob", "O'Brien", "", NULL };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        say_hello_r(names[i], GREETING_NAME_STRLEN, buf, sizeof(buf));
+        assert_string_equal(buf, say_hello(names[i]));
+        say_goodbye_r(names[i], GREETING_NAME_STRLEN, buf, sizeof(buf));
+        assert_string_equal(buf, say_goodbye(names[i]));
+    }
+}
+
+static void test_say_hello_r_name_length(void **state) {
+    (void)state;
+    char buf[64];
+
+    // Only name_len bytes are read: no NUL needed
+    const char record[] = { 'C', 'a', 'r', 'o', 'l', 'X', 'Y', 'Z' };
+    assert_int_equal(say_hello_r(record, 5, buf, sizeof(buf)), 13);
+    assert_string_equal(buf, "Hello, Carol!");
+
+    // A zero length means no name
+    assert_int_equal(say_goodbye_r("Dave", 0, buf, sizeof(buf)), 18);
+    assert_string_equal(buf, "Goodbye, stranger!");
+}
+
+static void test_say_hello_r_small_buffer(void **state) {
+    (void)state;
+    char buf[8];
+
+    // Size query: nothing is written
+    assert_int_equal(say_hello_r("Alice", GREETING_NAME_STRLEN, NULL, 0), 13);
+
+    // Truncated like snprintf, always NUL-terminated
+    memset(buf, 'x', sizeof(buf));
+    assert_int_equal(say_hello_r("Alice", GREETING_NAME_STRLEN, buf, sizeof(buf)), 13);
+    assert_string_equal(buf, "Hello, ");
+
+    assert_int_equal(say_hello_r("Al", GREETING_NAME_STRLEN, buf, 1), 10);
+    assert_string_equal(buf, "");
+
+    // Exactly enough room
+    char exact[11];
+    assert_int_equal(say_hello_r("Al", GREETING_NAME_STRLEN, exact, sizeof(exact)), 10);
+    assert_string_equal(exact, "Hello, Al!");
+}
+
+static void test_say_hello_r_long_name(void **state) {
+    (void)state;
+    // Longer than the legacy 256-byte buffer: the caller buffer decides
+    char name[400], buf[512];
+    memset(name, 'n', sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+
+    assert_int_equal(say_hello_r(name, GREETING_NAME_STRLEN, buf, sizeof(buf)), 7 + 399 + 1);
+    assert_int_equal(strlen(buf), 407);
+    assert_int_equal(buf[406], '!');
+
+    // The legacy call still truncates to its static buffer
+    assert_int_equal(strlen(say_hello(name)), 255);
+}
+
+/*============================================================================
+ * Batch API - one arena, offsets array
+ *===========================================================================*/
+
+static void test_say_hello_n_arena(void **state) {
+    (void)state;
+    const char *names[] = { "Alice", NULL, "Bob", "" };
+    char arena[128];
+    size_t offsets[5];
+
+    size_t used = say_hello_n(names, 4, '\n', arena, sizeof(arena), offsets);
+    const char expected[] = "Hello, Alice!\nHello, stranger!\nHello, Bob!\nHello, stranger!\n";
+    assert_int_equal(used, sizeof(expected) - 1);
+    assert_memory_equal(arena, expected, used);
+
+    assert_int_equal(offsets[0], 0);
+    assert_int_equal(offsets[1], 14);
+    assert_int_equal(offsets[2], 31);
+    assert_int_equal(offsets[3], 43);
+    assert_int_equal(offsets[4], used);
+}
+
+static void test_say_hello_n_c_strings(void **state) {
+    (void)state;
+    const char *names[] = { "Carol", "Dave", NULL };
+    char arena[64];
+    size_t offsets[4];
+    char buf[32];
+
+    // '\0' separators: every message is a C string, same text as say_*_r
+    say_goodbye_n(names, 3, '\0', arena, sizeof(arena), offsets);
+    for (size_t i = 0; i < 3; i++) {
+        size_t len = say_goodbye_r(names[i], GREETING_NAME_STRLEN, buf, sizeof(buf));
+        assert_string_equal(arena + offsets[i], buf);
+        assert_int_equal(offsets[i + 1] - offsets[i], len + 1);
+    }
+}
+
+static void test_say_hello_n_small_arena(void **state) {
+    (void)state;
+    const char *names[] = { "Al", "Bo", "Cy" };   // 11 bytes each
+    char arena[32];
+    size_t offsets[4];
+
+    // Size query: offsets are still filled
+    assert_int_equal(say_hello_n(names, 3, '\n', NULL, 0, offsets), 33);
+    assert_int_equal(offsets[2], 22);
+
+    // Only whole messages are written: the third one doesn't fit
+    memset(arena, 'x', sizeof(arena));
+    assert_int_equal(say_hello_n(names, 3, '\n', arena, sizeof(arena), offsets), 33);
+    assert_memory_equal(arena, "Hello, Al!\nHello, Bo!\n", 22);
+    assert_int_equal(arena[22], 'x');
+
+    // Resume from the first unwritten message
+    assert_int_equal(say_hello_n(names + 2, 1, '\n', arena, sizeof(arena), NULL), 11);
+    assert_memory_equal(arena, "Hello, Cy!\n", 11);
+
+    // Nothing to do
+    assert_int_equal(say_hello_n(NULL, 0, '\n', NULL, 0, offsets), 0);
+    assert_int_equal(offsets[0], 0);
+}
+
+/*============================================================================
+ * Vectored I/O API - writev() wrapped to misbehave on demand
+ *===========================================================================*/
+
+extern ssize_t __real_writev(int fd, const struct iovec *iov, int iovcnt);
+
+static struct {
+    size_t max_bytes;   /* 0 = no limit, else accept at most this many per call */
+    int eintr;          /* fail this many calls with EINTR first */
+    int fail_errno;     /* non-zero: fail every call with this errno */
+    int calls;
+    int max_iovcnt;
+} writev_mock;
+
+ssize_t __wrap_writev(int fd, const struct iovec *iov, int iovcnt) {
+    writev_mock.calls++;
+    if (iovcnt > writev_mock.max_iovcnt) {
+        writev_mock.max_iovcnt = iovcnt;
+    }
+    if (writev_mock.fail_errno != 0) {
+        errno = writev_mock.fail_errno;
+        return -1;
+    }
+    if (writev_mock.eintr > 0) {
+        writev_mock.eintr--;
+        errno = EINTR;
+        return -1;
+    }
+    if (writev_mock.max_bytes == 0) {
+        return __real_writev(fd, iov, iovcnt);
+    }
+
+    // Short write: only the first max_bytes bytes of the iovecs
+    struct iovec part[1024];
+    assert_true(iovcnt <= 1024);
+    size_t left = writev_mock.max_bytes;
+    int n = 0;
+    for (; n < iovcnt && left > 0; n++) {
+        part[n] = iov[n];
+        if (part[n].iov_len > left) {
+            part[n].iov_len = left;
+        }
+        left -= part[n].iov_len;
+    }
+    return __real_writev(fd, part, n);
+}
+
+static int writev_mock_reset(void **state) {
+    (void)state;
+    memset(&writev_mock, 0, sizeof(writev_mock));
+    return 0;
+}
+
+// Everything written to fd so far, from offset 0
+static size_t read_back(int fd, char *buf, size_t size) {
+    assert_int_equal(lseek(fd, 0, SEEK_SET), 0);
+    ssize_t n = read(fd, buf, size);
+    assert_true(n >= 0);
+    return (size_t)n;
+}
+
+static void test_say_hello_write_single(void **state) {
+    (void)state;
+    FILE *f = tmpfile();
+    assert_non_null(f);
+    int fd = fileno(f);
+    size_t written = 0;
+    char buf[64];
+
+    assert_int_equal(say_hello_write(fd, "Alice;Bob", 5, &written), 0);
+    assert_int_equal(written, 13);
+    assert_int_equal(say_goodbye_write(fd, NULL, GREETING_NAME_STRLEN, NULL), 0);
+    assert_int_equal(writev_mock.calls, 2);   // one writev() per greeting
+
+    size_t n = read_back(fd, buf, sizeof(buf));
+    assert_int_equal(n, 13 + 18);
+    assert_memory_equal(buf, "Hello, Alice!Goodbye, stranger!", n);
+    fclose(f);
+}
+
+// Names and the say_hello_n arena they should produce
+static char **make_names(size_t count, char **expected, size_t *expected_len) {
+    char **names = malloc(count * sizeof(*names));
+    assert_non_null(names);
+    for (size_t i = 0; i < count; i++) {
+        names[i] = malloc(16);
+        assert_non_null(names[i]);
+        snprintf(names[i], 16, i % 7 == 0 ? "" : "user%zu", i);
+    }
+    *expected_len = say_hello_n((const char *const *)names, count, '\n', NULL, 0, NULL);
+    *expected = malloc(*expected_len);
+    assert_non_null(*expected);
+    say_hello_n((const char *const *)names, count, '\n', *expected, *expected_len, NULL);
+    return names;
+}
+
+static void free_names(char **names, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        free(names[i]);
+    }
+    free(names);
+}
+
+static void check_batch_write(size_t count) {
+    char *expected;
+    size_t expected_len, written = 0;
+    char **names = make_names(count, &expected, &expected_len);
+    FILE *f = tmpfile();
+    assert_non_null(f);
+
+    assert_int_equal(say_hello_write_n(fileno(f), (const char *const *)names, count, '\n',
+                                       &written), 0);
+    assert_int_equal(written, expected_len);
+
+    char *buf = malloc(expected_len + 1);
+    assert_non_null(buf);
+    assert_int_equal(read_back(fileno(f), buf, expected_len + 1), expected_len);
+    assert_memory_equal(buf, expected, expected_len);
+
+    free(buf);
+    free(expected);
+    free_names(names, count);
+    fclose(f);
+}
+
+static void test_say_hello_write_n_batches(void **state) {
+    (void)state;
+    // Enough greetings for several writev() calls, none over IOV_MAX iovecs
+    long iov_max = sysconf(_SC_IOV_MAX);
+    check_batch_write(1000);
+    assert_true(writev_mock.calls > 1);
+    assert_true(iov_max < 0 || writev_mock.max_iovcnt <= iov_max);
+    assert_int_equal(writev_mock.max_iovcnt % 3, 0);
+
+    // Nothing to write: no call at all
+    writev_mock.calls = 0;
+    size_t written = 1;
+    assert_int_equal(say_hello_write_n(-1, NULL, 0, '\n', &written), 0);
+    assert_int_equal(written, 0);
+    assert_int_equal(writev_mock.calls, 0);
+}
+
+static void test_say_hello_write_n_short_writes(void **state) {
+    (void)state;
+    // 5 bytes per call: every greeting ends mid-prefix, mid-name or mid-suffix
+    writev_mock.max_bytes = 5;
+    writev_mock.eintr = 3;
+    check_batch_write(50);
+
+    writev_mock.max_bytes = 1;
+    check_batch_write(3);
+
+    writev_mock.max_bytes = 7;   // exactly "Hello, " each time
+    check_batch_write(10);
+}
+
+static void test_say_hello_write_errors(void **state) {
+    (void)state;
+    const char *names[] = { "Alice", "Bob" };
+    size_t written = 1;
+
+    // Real writev() on a bad descriptor
+    errno = 0;
+    assert_int_equal(say_hello_write_n(-1, names, 2, '\n', &written), -1);
+    assert_int_equal(errno, EBADF);
+    assert_int_equal(written, 0);
+
+    // EAGAIN is not retried
+    writev_mock.fail_errno = EAGAIN;
+    written = 1;
+    assert_int_equal(say_goodbye_write(1, "Alice", GREETING_NAME_STRLEN, &written), -1);
+    assert_int_equal(errno, EAGAIN);
+    assert_int_equal(written, 0);
+    assert_int_equal(writev_mock.calls, 2);
+}
+
+/*============================================================================
+ * Thread-local mode - concurrent legacy callers
+ *===========================================================================*/
+
+#define STRESS_THREADS 8
+#define STRESS_ITERATIONS 20000
+
+struct stress_worker {
+    pthread_t thread;
+    char name[32];
+    const char *hello_buffer;   /* buffer say_hello returned on this thread */
+    int mismatches;
+};
+
+static void *stress_greetings(void *arg) {
+    struct stress_worker *w = arg;
+    char hello[64], goodbye[64];
+    say_hello_r(w->name, GREETING_NAME_STRLEN, hello, sizeof(hello));
+    say_goodbye_r(w->name, GREETING_NAME_STRLEN, goodbye, sizeof(goodbye));
+
+    for (int i = 0; i < STRESS_ITERATIONS; i++) {
+        const char *h = say_hello(w->name);
+        if (i % 16 == 0) {
+            sched_yield();  // let another thread write between call and check
+        }
+        w->mismatches += strcmp(h, hello) != 0;
+        w->mismatches += strcmp(say_goodbye(w->name), goodbye) != 0;
+        w->hello_buffer = h;
+    }
+    return NULL;
+}
+
+static void test_greeting_thread_local_stress(void **state) {
+    (void)state;
+    struct stress_worker workers[STRESS_THREADS];
+    int saved = greeting_thread_local_enabled();
+    greeting_set_thread_local(1);
+    assert_int_equal(greeting_thread_local_enabled(), 1);
+
+    for (int t = 0; t < STRESS_THREADS; t++) {
+        snprintf(workers[t].name, sizeof(workers[t].name), "worker-%d", t);
+        workers[t].hello_buffer = NULL;
+        workers[t].mismatches = 0;
+        assert_int_equal(pthread_create(&workers[t].thread, NULL, stress_greetings, &workers[t]), 0);
+    }
+    for (int t = 0; t < STRESS_THREADS; t++) {
+        pthread_join(workers[t].thread, NULL);
+    }
+    for (int t = 0; t < STRESS_THREADS; t++) {
+        assert_int_equal(workers[t].mismatches, 0);
+        for (int u = 0; u < t; u++) {
+            assert_ptr_not_equal(workers[t].hello_buffer, workers[u].hello_buffer);
+        }
+    }
+
+    // Same signature and return behavior on the calling thread
+    assert_string_equal(say_hello("Alice"), "Hello, Alice!");
+    assert_ptr_equal(say_hello("Bob"), say_hello("Carol"));
+
+    greeting_set_thread_local(saved);
+}
+
 /*============================================================================
  * Main - Run all tests
  *===========================================================================*/
@@ -241,6 +621,34 @@ int main(void) {
         cmocka_unit_test(test_greeting_return_not_null),
     };
 
+    // Reentrant API tests
+    const struct CMUnitTest reentrant_tests[] = {
+        cmocka_unit_test(test_say_hello_r_writes_message),
+        cmocka_unit_test(test_say_hello_r_name_length),
+        cmocka_unit_test(test_say_hello_r_small_buffer),
+        cmocka_unit_test(test_say_hello_r_long_name),
+    };
+
+    // Batch API tests
+    const struct CMUnitTest batch_tests[] = {
+        cmocka_unit_test(test_say_hello_n_arena),
+        cmocka_unit_test(test_say_hello_n_c_strings),
+        cmocka_unit_test(test_say_hello_n_small_arena),
+    };
+
+    // Vectored I/O API tests
+    const struct CMUnitTest writev_tests[] = {
+        cmocka_unit_test_setup(test_say_hello_write_single, writev_mock_reset),
+        cmocka_unit_test_setup(test_say_hello_write_n_batches, writev_mock_reset),
+        cmocka_unit_test_setup(test_say_hello_write_n_short_writes, writev_mock_reset),
+        cmocka_unit_test_setup(test_say_hello_write_errors, writev_mock_reset),
+    };
+
+    // Thread-local mode tests
+    const struct CMUnitTest thread_local_tests[] = {
+        cmocka_unit_test(test_greeting_thread_local_stress),
+    };
+
     int result = 0;
 
     printf("\n========== GREETING MODULE UNIT TESTS ==========\n\n");
@@ -255,5 +663,17 @@ int main(void) {
     // Run edge case tests
     result += cmocka_run_group_tests_name("edge case tests", edge_case_tests, NULL, NULL);
 
+    // Run reentrant API tests
+    result += cmocka_run_group_tests_name("reentrant tests", reentrant_tests, NULL, NULL);
+
+    // Run batch API tests
+    result += cmocka_run_group_tests_name("batch tests", batch_tests, NULL, NULL);
+
+    // Run vectored I/O API tests
+    result += cmocka_run_group_tests_name("writev tests", writev_tests, NULL, NULL);
+
+    // Run thread-local mode tests
+    result += cmocka_run_group_tests_name("thread-local tests", thread_local_tests, NULL, NULL);
+
     return result;
 }
\ No newline at end of file
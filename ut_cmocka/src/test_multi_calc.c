@@ -16,9 +16,19 @@
 #include <setjmp.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <poll.h>
+#include <pthread.h>
 #include <cmocka.h>
 
 #include "multi-calc.h"
+#include "multi-calc-expr.h"
+#include "multi-calc-jit.h"
+#include "sdk-async.h"
+#include "sdk-pool.h"
+#include "calc.h"
 
 /*============================================================================
  * Real Function Declarations
@@ -191,15 +201,14 @@ static void test_expression_all_zeros(void **state) {
 
 /**
  * Test normal average: (10 + 20 + 30) / 3 = 60 / 3 = 20
- * Mock sequence: calc_add -> calc_add -> calc_divide
+ * Mock sequence: calc_add -> calc_add (the divide by 3 is precomputed)
  */
 static void test_average_normal(void **state) {
     (void)state;
     enable_all_mocks();
 
     will_return(__wrap_calc_add, 30);    // 10 + 20 = 30
-    will_return(__wrap_calc_add, 60);    // 30 + 30 = 60
-    will_return(__wrap_calc_divide, 20); // 60 / 3 = 20
+    will_return(__wrap_calc_add, 60);    // 30 + 30 = 60, then 60 / 3 = 20
 
     int result = multi_calc_average(10, 20, 30);
 
@@ -214,8 +223,7 @@ static void test_average_truncation(void **state) {
     enable_all_mocks();
 
     will_return(__wrap_calc_add, 2);     // 1 + 1 = 2
-    will_return(__wrap_calc_add, 3);     // 2 + 1 = 3
-    will_return(__wrap_calc_divide, 1);  // 3 / 3 = 1
+    will_return(__wrap_calc_add, 3);     // 2 + 1 = 3, then 3 / 3 = 1
 
     int result = multi_calc_average(1, 1, 1);
 
@@ -230,8 +238,7 @@ static void test_average_all_zeros(void **state) {
     enable_all_mocks();
 
     will_return(__wrap_calc_add, 0);     // 0 + 0 = 0
-    will_return(__wrap_calc_add, 0);     // 0 + 0 = 0
-    will_return(__wrap_calc_divide, 0);  // 0 / 3 = 0
+    will_return(__wrap_calc_add, 0);     // 0 + 0 = 0, then 0 / 3 = 0
 
     int result = multi_calc_average(0, 0, 0);
 
@@ -249,12 +256,11 @@ static void test_average_mock_abnormal(void **state) {
     // Mock calc_add to return unexpected values
     will_return(__wrap_calc_add, 999);   // Unexpected!
     will_return(__wrap_calc_add, 1000);  // Unexpected!
-    will_return(__wrap_calc_divide, 333);
 
     // The result is based on mock values, not real calculation
     int result = multi_calc_average(1, 2, 3);
 
-    // Verify the function uses the values from calc_* correctly
+    // Verify the function uses the values from calc_add correctly: 1000 / 3
     assert_int_equal(result, 333);
 }
 
@@ -266,8 +272,7 @@ static void test_average_negative(void **state) {
     enable_all_mocks();
 
     will_return(__wrap_calc_add, -10);    // -5 + (-5) = -10
-    will_return(__wrap_calc_add, -15);    // -10 + (-5) = -15
-    will_return(__wrap_calc_divide, -5);  // -15 / 3 = -5
+    will_return(__wrap_calc_add, -15);    // -10 + (-5) = -15, then -15 / 3 = -5
 
     int result = multi_calc_average(-5, -5, -5);
 
@@ -346,27 +351,27 @@ static void test_expression_partial_mock_multiply(void **state) {
 }
 
 /**
- * Test with PARTIAL mock: mock only calc_divide
- * calc_add uses real implementation
+ * multi_calc_average divides with a precomputed divider, not calc_divide:
+ * with calc_divide mocked and nothing queued for it, the result is still
+ * the real average (an unexpected calc_divide call would fail the test)
  */
-static void test_average_partial_mock_divide(void **state) {
+static void test_average_does_not_call_divide(void **state) {
     (void)state;
 
-    // Enable only calc_divide mock
+    // Only calc_divide is mocked, and no value is queued for it
     mock_calc_add = false;     // Use real
     mock_calc_subtract = false;
     mock_calc_multiply = false;
-    mock_calc_divide = true;   // Use mock
+    mock_calc_divide = true;   // Must not be called
 
     // calc_add(10, 20) = 30 (real)
     // calc_add(30, 30) = 60 (real)
-    // calc_divide(60, 3) = mock returns 100 instead of 20
-    will_return(__wrap_calc_divide, 100);
-
+    // The divide by 3 uses a precomputed divider, so the calc_divide mock
+    // must not be consumed: no will_return() is queued for it
     int result = multi_calc_average(10, 20, 30);
 
-    // Real additions, but mock divide returns 100
-    assert_int_equal(result, 100);
+    // Real additions, real precomputed division: 60 / 3 = 20
+    assert_int_equal(result, 20);
 }
 
 /**
@@ -381,9 +386,8 @@ static void test_compare_mock_vs_real(void **state) {
     enable_all_mocks();
     will_return(__wrap_calc_add, 100);  // Mock: return 100
     will_return(__wrap_calc_add, 200);  // Mock: return 200
-    will_return(__wrap_calc_divide, 66);
     mock_result = multi_calc_average(1, 2, 3);
-    assert_int_equal(mock_result, 66);  // Mock result
+    assert_int_equal(mock_result, 66);  // Mock result: 200 / 3
 
     // Second: test with real
     disable_all_mocks();
@@ -395,6 +399,893 @@ static void test_compare_mock_vs_real(void **state) {
     printf("    Mock result: %d, Real result: %d\n", mock_result, real_result);
 }
 
+/**
+ * Batch reference goes through the wrapped calc_add, so with the mock
+ * disabled it checks the vector path against the real scalar primitive
+ */
+static void test_batch_reference_through_wrap(void **state) {
+    (void)state;
+    disable_all_mocks();
+
+    int a[19], b[19], vec[19], ref[19];
+    for (int i = 0; i < 19; i++) {
+        a[i] = i * 3 - 20;
+        b[i] = 7 - i;
+    }
+    calc_add_n(a, b, vec, 19);
+    calc_add_n_ref(a, b, ref, 19);
+    assert_memory_equal(vec, ref, sizeof(ref));
+
+    // With the mock enabled the reference picks up the mocked values
+    enable_all_mocks();
+    will_return_int_count(__wrap_calc_add, 42, 19);
+    calc_add_n_ref(a, b, ref, 19);
+    for (int i = 0; i < 19; i++) {
+        assert_int_equal(ref[i], 42);
+    }
+}
+
+/**
+ * multi_calc_average_n sums with calc_sum_reduce, so it needs no mocks and
+ * must agree with multi_calc_average on 3 values
+ */
+static void test_average_n_matches_average(void **state) {
+    (void)state;
+    disable_all_mocks();
+
+    const int values[] = { 10, 20, 31, -7, -8, 0 };
+    assert_int_equal(multi_calc_average_n(values, 3, 0), multi_calc_average(10, 20, 31));
+    assert_int_equal(multi_calc_average_n(values + 3, 3, 0), multi_calc_average(-7, -8, 0));
+    assert_int_equal(multi_calc_average_n(values, 0, 0), 0);
+
+    // The 64-bit sum doesn't overflow like (a + b + c) does
+    const int big[] = { INT32_MAX, INT32_MAX, INT32_MAX };
+    assert_int_equal(multi_calc_average_n(big, 3, 2), INT32_MAX);
+}
+
+/**
+ * Column average skips null rows
+ */
+static void test_average_column_skips_nulls(void **state) {
+    (void)state;
+    disable_all_mocks();
+
+    int values[] = { 10, 20, 1000, 31 };
+    uint8_t valid[] = { 0x0B };  // row 2 is null
+    calc_column_t col;
+    calc_column_view(&col, values, 4, valid);
+    assert_int_equal(multi_calc_average_column(&col, 0), multi_calc_average(10, 20, 31));
+
+    calc_column_view(&col, values, 4, NULL);
+    assert_int_equal(multi_calc_average_column(&col, 0), multi_calc_average_n(values, 4, 0));
+
+    valid[0] = 0;
+    calc_column_view(&col, values, 4, valid);
+    assert_int_equal(multi_calc_average_column(&col, 0), 0);
+}
+
+/**
+ * Streaming average: push / push_n / merge / finalize
+ */
+static void test_average_stream_matches_average(void **state) {
+    (void)state;
+    disable_all_mocks();
+
+    const int triples[][3] = { { 10, 20, 30 }, { 10, 20, 31 }, { -7, -8, 0 }, { 0, 0, 0 } };
+    for (size_t i = 0; i < sizeof(triples) / sizeof(triples[0]); i++) {
+        multi_calc_avg_t acc;
+        multi_calc_avg_init(&acc);
+        multi_calc_avg_push(&acc, triples[i][0]);
+        multi_calc_avg_push(&acc, triples[i][1]);
+        multi_calc_avg_push(&acc, triples[i][2]);
+        assert_int_equal(multi_calc_avg_finalize(&acc),
+                         multi_calc_average(triples[i][0], triples[i][1], triples[i][2]));
+    }
+
+    multi_calc_avg_t empty;
+    multi_calc_avg_init(&empty);
+    assert_int_equal(multi_calc_avg_finalize(&empty), 0);
+}
+
+#define STREAM_THREADS 4
+#define STREAM_VALUES 100000
+
+struct stream_worker {
+    pthread_t thread;
+    multi_calc_avg_t acc;
+    int *values;
+};
+
+static void *stream_worker_main(void *arg) {
+    struct stream_worker *w = arg;
+    // Half value by value, half batched
+    for (int i = 0; i < STREAM_VALUES / 2; i++) {
+        multi_calc_avg_push(&w->acc, w->values[i]);
+    }
+    multi_calc_avg_push_n(&w->acc, w->values + STREAM_VALUES / 2, STREAM_VALUES / 2);
+    return NULL;
+}
+
+static void test_average_stream_merge_threads(void **state) {
+    (void)state;
+    static int values[STREAM_THREADS][STREAM_VALUES];
+    struct stream_worker workers[STREAM_THREADS];
+    int64_t sum = 0;
+
+    for (int t = 0; t < STREAM_THREADS; t++) {
+        for (int i = 0; i < STREAM_VALUES; i++) {
+            // Large values: an int running sum would overflow right away
+            values[t][i] = (i % 3 == 0) ? INT32_MAX : -(i % 1000) - t;
+            sum += values[t][i];
+        }
+        multi_calc_avg_init(&workers[t].acc);
+        workers[t].values = values[t];
+        assert_int_equal(pthread_create(&workers[t].thread, NULL, stream_worker_main, &workers[t]), 0);
+    }
+
+    multi_calc_avg_t total;
+    multi_calc_avg_init(&total);
+    for (int t = 0; t < STREAM_THREADS; t++) {
+        pthread_join(workers[t].thread, NULL);
+        multi_calc_avg_merge(&total, &workers[t].acc);
+    }
+
+    assert_int_equal(total.count, STREAM_THREADS * STREAM_VALUES);
+    assert_int_equal(multi_calc_avg_finalize(&total),
+                     (int)(sum / (STREAM_THREADS * STREAM_VALUES)));
+}
+
+static void test_average_stream_negative_truncation(void **state) {
+    (void)state;
+    multi_calc_avg_t a, b;
+    multi_calc_avg_init(&a);
+    multi_calc_avg_init(&b);
+    multi_calc_avg_push(&a, INT32_MIN);
+    multi_calc_avg_push(&b, INT32_MIN);
+    multi_calc_avg_push(&b, -1);
+    multi_calc_avg_merge(&a, &b);
+    // (2 * INT32_MIN - 1) / 3 truncates toward zero
+    assert_int_equal(multi_calc_avg_finalize(&a), (int)((2 * (int64_t)INT32_MIN - 1) / 3));
+    multi_calc_avg_push(&a, 3);
+    assert_int_equal(multi_calc_avg_finalize(&a), (int)((2 * (int64_t)INT32_MIN + 2) / 4));
+}
+
+/*============================================================================
+ * Fused expression kernel - no calc_xxx calls, same result as the scalar path
+ *===========================================================================*/
+
+#define EXPR_LEN 53
+
+static const calc_isa_t expr_isas[] = {
+    CALC_ISA_SCALAR, CALC_ISA_SSE2, CALC_ISA_AVX2, CALC_ISA_AVX512,
+};
+
+static void fill_expression_inputs(int *a, int *b, int *c, int *d) {
+    for (int i = 0; i < EXPR_LEN; i++) {
+        a[i] = i * 7 - 100;
+        b[i] = 50 - i * 3;
+        c[i] = (i % 5) * 1000 - 2000;
+        d[i] = i - 26;
+    }
+}
+
+static void test_expression_n_matches_expression(void **state) {
+    (void)state;
+    int a[EXPR_LEN], b[EXPR_LEN], c[EXPR_LEN], d[EXPR_LEN], out[EXPR_LEN];
+    fill_expression_inputs(a, b, c, d);
+
+    calc_isa_t saved = calc_batch_get_isa();
+    for (size_t k = 0; k < sizeof(expr_isas) / sizeof(expr_isas[0]); k++) {
+        if (calc_batch_set_isa(expr_isas[k]) != 0) {
+            continue;
+        }
+        // Mocks on with nothing queued: any calc_xxx call would fail the test
+        enable_all_mocks();
+        multi_calc_expression_n(a, b, c, d, out, EXPR_LEN);
+
+        disable_all_mocks();
+        for (int i = 0; i < EXPR_LEN; i++) {
+            assert_int_equal(out[i], multi_calc_expression(a[i], b[i], c[i], d[i]));
+        }
+    }
+    calc_batch_set_isa(saved);
+}
+
+static void test_expression_stride_aos(void **state) {
+    (void)state;
+    struct row { int id; int result; int pad[2]; } rows[EXPR_LEN];
+    int a[EXPR_LEN], b[EXPR_LEN], c[EXPR_LEN], d[EXPR_LEN];
+    fill_expression_inputs(a, b, c, d);
+    disable_all_mocks();
+
+    calc_isa_t saved = calc_batch_get_isa();
+    for (size_t k = 0; k < sizeof(expr_isas) / sizeof(expr_isas[0]); k++) {
+        if (calc_batch_set_isa(expr_isas[k]) != 0) {
+            continue;
+        }
+        memset(rows, 0, sizeof(rows));
+        multi_calc_expression_stride(a, b, c, d, &rows[0].result, sizeof(rows[0]) / sizeof(int), EXPR_LEN);
+        for (int i = 0; i < EXPR_LEN; i++) {
+            assert_int_equal(rows[i].id, 0);  // neighbouring fields untouched
+            assert_int_equal(rows[i].result, multi_calc_expression(a[i], b[i], c[i], d[i]));
+            assert_int_equal(rows[i].pad[0] | rows[i].pad[1], 0);
+        }
+    }
+    calc_batch_set_isa(saved);
+}
+
+static void test_expression_column(void **state) {
+    (void)state;
+    int a[EXPR_LEN], b[EXPR_LEN], c[EXPR_LEN], d[EXPR_LEN], expected[EXPR_LEN];
+    uint8_t valid_d[(EXPR_LEN + 7) / 8];
+    fill_expression_inputs(a, b, c, d);
+    memset(valid_d, 0xFF, sizeof(valid_d));
+    valid_d[0] = 0xFE;  // row 0 null
+    multi_calc_expression_n(a, b, c, d, expected, EXPR_LEN);
+
+    calc_column_t ca, cb, cc, cd, out;
+    calc_column_view(&ca, a, EXPR_LEN, NULL);
+    calc_column_view(&cb, b, EXPR_LEN, NULL);
+    calc_column_view(&cc, c, EXPR_LEN, NULL);
+    calc_column_view(&cd, d, EXPR_LEN, valid_d);
+    assert_int_equal(calc_column_init(&out, EXPR_LEN, 0), 0);
+
+    assert_int_equal(multi_calc_expression_column(&ca, &cb, &cc, &cd, &out), 0);
+    assert_memory_equal(out.data, expected, sizeof(expected));
+    assert_int_equal(calc_column_null_count(&out), 1);
+    assert_false(calc_column_is_valid(&out, 0));
+
+    cd.len = EXPR_LEN - 1;
+    assert_int_equal(multi_calc_expression_column(&ca, &cb, &cc, &cd, &out), -1);
+    calc_column_free(&out);
+}
+
+/*============================================================================
+ * Formula engine - bytecode interpreter over blocks
+ *===========================================================================*/
+
+static const char *const expr_names[] = { "a", "b", "c", "d" };
+
+static void test_formula_matches_expression_n(void **state) {
+    (void)state;
+    disable_all_mocks();
+    const size_t lens[] = { 0, 1, 1023, 1024, 1025, 3000 };
+    const size_t max_len = 3000;
+    int *in[4], *out = malloc(max_len * sizeof(int)), *expected = malloc(max_len * sizeof(int));
+    assert_non_null(out);
+    assert_non_null(expected);
+    for (int k = 0; k < 4; k++) {
+        in[k] = malloc(max_len * sizeof(int));
+        assert_non_null(in[k]);
+        for (size_t i = 0; i < max_len; i++) {
+            in[k][i] = (int)((i * (k + 3)) % 2001) - 1000;
+        }
+    }
+
+    multi_calc_expr_t *expr = multi_calc_expr_compile("(a + b) * (c - d)", expr_names, 4, NULL);
+    assert_non_null(expr);
+    for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+        assert_int_equal(multi_calc_expr_eval_n(expr, (const int *const *)in, out, lens[l]), 0);
+        multi_calc_expression_n(in[0], in[1], in[2], in[3], expected, lens[l]);
+        assert_memory_equal(out, expected, lens[l] * sizeof(int));
+    }
+    int row[4] = { 2, 3, 10, 4 };
+    assert_int_equal(multi_calc_expr_eval(expr, row), multi_calc_expression(2, 3, 10, 4));
+    multi_calc_expr_free(expr);
+
+    for (int k = 0; k < 4; k++) {
+        free(in[k]);
+    }
+    free(out);
+    free(expected);
+}
+
+static void test_formula_semantics(void **state) {
+    (void)state;
+    disable_all_mocks();
+    const struct {
+        const char *formula;
+        int a, b, c, d;
+        int expected;
+    } cases[] = {
+        { "a - b * -c / 2 + 7", 1, 4, 3, 0, 1 - 4 * -3 / 2 + 7 },
+        { "((a))", 5, 0, 0, 0, 5 },
+        { "2 * 3 + a", 1, 0, 0, 0, 7 },
+        { "a / (b - b)", 9, 4, 0, 0, 0 },                      // divide by 0 returns 0
+        { "a / 0", 9, 0, 0, 0, 0 },                            // also when folded
+        { "calc_add(a, b) * subtract(c, d)", 2, 3, 10, 4, 30 },
+        { "divide(a, b) + a / b", 7, 2, 0, 0, 6 },
+        { "(a + b) * (a + b) - (b + a)", 1, 2, 0, 0, 6 },
+        { "a + b", INT32_MAX, 1, 0, 0, INT32_MIN },            // wraps like the batch API
+        { "a / -1", INT32_MIN, 0, 0, 0, INT32_MIN },
+        { "-2147483648 + d", 0, 0, 0, 0, INT32_MIN },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        multi_calc_expr_t *expr = multi_calc_expr_compile(cases[i].formula, expr_names, 4, NULL);
+        assert_non_null(expr);
+        int a[] = { cases[i].a }, b[] = { cases[i].b }, c[] = { cases[i].c }, d[] = { cases[i].d };
+        const int *in[] = { a, b, c, d };
+        int out = -12345;
+        assert_int_equal(multi_calc_expr_eval_n(expr, in, &out, 1), 0);
+        assert_int_equal(out, cases[i].expected);
+        int row[] = { cases[i].a, cases[i].b, cases[i].c, cases[i].d };
+        assert_int_equal(multi_calc_expr_eval(expr, row), cases[i].expected);
+        multi_calc_expr_free(expr);
+    }
+}
+
+static void test_formula_syntax_errors(void **state) {
+    (void)state;
+    const struct {
+        const char *formula;
+        size_t pos;
+    } cases[] = {
+        { "a +", 3 },
+        { "(a + b", 6 },
+        { "a + x", 4 },
+        { "a $ b", 2 },
+        { "power(a, b)", 0 },
+        { "add(a b)", 6 },
+        { "4294967296", 0 },
+        { "", 0 },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        size_t pos = 999;
+        assert_null(multi_calc_expr_compile(cases[i].formula, expr_names, 4, &pos));
+        assert_int_equal(pos, cases[i].pos);
+    }
+    multi_calc_expr_free(NULL);
+}
+
+static void test_formula_nesting_limit(void **state) {
+    (void)state;
+    disable_all_mocks();
+    enum { DEPTH = MULTI_CALC_EXPR_MAX_DEPTH };
+    char text[2 * DEPTH + 8];
+    int row[] = { 5, 0, 0, 0 };
+
+    // DEPTH - 1 parentheses around a: the innermost a is at the limit
+    memset(text, '(', DEPTH - 1);
+    text[DEPTH - 1] = 'a';
+    memset(text + DEPTH, ')', DEPTH - 1);
+    text[2 * DEPTH - 1] = '\0';
+    multi_calc_expr_t *expr = multi_calc_expr_compile(text, expr_names, 4, NULL);
+    assert_non_null(expr);
+    assert_int_equal(multi_calc_expr_eval(expr, row), 5);
+    multi_calc_expr_free(expr);
+
+    // One more level fails at the character past the limit
+    size_t pos = 0;
+    memset(text, '(', DEPTH);
+    strcpy(text + DEPTH, "a)");
+    assert_null(multi_calc_expr_compile(text, expr_names, 4, &pos));
+    assert_int_equal(pos, DEPTH);
+
+    // Signs count as levels too
+    memset(text, '-', DEPTH);
+    strcpy(text + DEPTH, "a");
+    assert_null(multi_calc_expr_compile(text, expr_names, 4, &pos));
+    assert_int_equal(pos, DEPTH);
+    memset(text, '-', DEPTH - 2);
+    strcpy(text + DEPTH - 2, "a");  // even count of signs: -(-(...a))
+    expr = multi_calc_expr_compile(text, expr_names, 4, NULL);
+    assert_non_null(expr);
+    assert_int_equal(multi_calc_expr_eval(expr, row), 5);
+    multi_calc_expr_free(expr);
+}
+
+static void test_formula_many_nodes(void **state) {
+    (void)state;
+    disable_all_mocks();
+    // a*0 + a*1 + ... + a*(N-1): N distinct constants and 2N ops
+    enum { N = 10000 };
+    char *text = malloc((size_t)N * 16);
+    assert_non_null(text);
+    char *p = text;
+    for (int i = 0; i < N; i++) {
+        p += sprintf(p, i ? " + a*%d" : "a*%d", i);
+    }
+
+    multi_calc_expr_t *expr = multi_calc_expr_compile(text, expr_names, 4, NULL);
+    assert_non_null(expr);
+    int row[] = { 2, 0, 0, 0 };
+    assert_int_equal(multi_calc_expr_eval(expr, row), 2 * (N * (N - 1) / 2));
+    multi_calc_expr_stats_t stats;
+    multi_calc_expr_get_stats(expr, &stats);
+    assert_int_equal(stats.source_ops, 2 * N - 1);
+    multi_calc_expr_free(expr);
+    free(text);
+}
+
+static void test_formula_set_shares_subterms(void **state) {
+    (void)state;
+    disable_all_mocks();
+    const char *const formulas[] = {
+        "(a + b) * (c - d)",
+        "(a + b + c) / 3",
+        "(b + a) - (c - d)",
+        "a + b",
+        "7 * (c - d)",
+    };
+    const size_t nformulas = sizeof(formulas) / sizeof(formulas[0]);
+    int a[EXPR_LEN], b[EXPR_LEN], c[EXPR_LEN], d[EXPR_LEN];
+    int results[5][EXPR_LEN], expected[EXPR_LEN];
+    fill_expression_inputs(a, b, c, d);
+    const int *in[] = { a, b, c, d };
+    int *outs[] = { results[0], results[1], results[2], results[3], results[4] };
+
+    multi_calc_expr_t *set = multi_calc_expr_compile_set(formulas, nformulas, expr_names, 4, NULL, NULL);
+    assert_non_null(set);
+    assert_int_equal(multi_calc_expr_eval_set_n(set, in, outs, EXPR_LEN), 0);
+    for (size_t k = 0; k < nformulas; k++) {
+        multi_calc_expr_t *one = multi_calc_expr_compile(formulas[k], expr_names, 4, NULL);
+        assert_non_null(one);
+        assert_int_equal(multi_calc_expr_eval_n(one, in, expected, EXPR_LEN), 0);
+        assert_memory_equal(results[k], expected, sizeof(expected));
+        multi_calc_expr_free(one);
+    }
+
+    // 12 ops as written; a + b, c - d and the rest are computed once: 7 ops
+    multi_calc_expr_stats_t stats;
+    multi_calc_expr_get_stats(set, &stats);
+    assert_int_equal(stats.formulas, nformulas);
+    assert_int_equal(stats.source_ops, 12);
+    assert_int_equal(stats.ops, 7);
+    assert_int_equal(stats.ops_eliminated, 5);
+    assert_int_equal(stats.tile_rows, MULTI_CALC_EXPR_BLOCK);
+
+    int row[] = { 2, 3, 10, 4 };
+    assert_int_equal(multi_calc_expr_eval(set, row), 30);  // first formula
+    assert_int_equal(multi_calc_expr_eval_n(set, in, expected, EXPR_LEN), -1);
+    multi_calc_expr_free(set);
+}
+
+static void test_formula_set_small_tiles(void **state) {
+    (void)state;
+    disable_all_mocks();
+    enum { NFORMULAS = 300, ROWS = 1000 };
+    char *texts[NFORMULAS];
+    int *outs[NFORMULAS];
+    int a[ROWS], b[ROWS], c[ROWS], d[ROWS];
+    for (int i = 0; i < ROWS; i++) {
+        a[i] = i - 500;
+        b[i] = i * 3;
+        c[i] = 0;
+        d[i] = 0;
+    }
+    const int *in[] = { a, b, c, d };
+    for (int k = 0; k < NFORMULAS; k++) {
+        texts[k] = malloc(32);
+        outs[k] = malloc(ROWS * sizeof(int));
+        assert_non_null(texts[k]);
+        assert_non_null(outs[k]);
+        snprintf(texts[k], 32, "(a + b) * %d - b", k);
+    }
+
+    multi_calc_expr_t *set = multi_calc_expr_compile_set((const char *const *)texts, NFORMULAS,
+                                                         expr_names, 4, NULL, NULL);
+    assert_non_null(set);
+    multi_calc_expr_stats_t stats;
+    multi_calc_expr_get_stats(set, &stats);
+    assert_true(stats.tile_rows < MULTI_CALC_EXPR_BLOCK);  // 600+ registers per row
+    assert_int_equal(stats.ops_eliminated, NFORMULAS - 1);  // a + b computed once
+
+    assert_int_equal(multi_calc_expr_eval_set_n(set, in, outs, ROWS), 0);
+    for (int k = 0; k < NFORMULAS; k++) {
+        for (int i = 0; i < ROWS; i++) {
+            assert_int_equal(outs[k][i], (a[i] + b[i]) * k - b[i]);
+        }
+        free(texts[k]);
+        free(outs[k]);
+    }
+    multi_calc_expr_free(set);
+}
+
+static void test_formula_set_errors(void **state) {
+    (void)state;
+    const char *const formulas[] = { "a + b", "c * (d", "a" };
+    size_t index = 99, pos = 99;
+    assert_null(multi_calc_expr_compile_set(formulas, 3, expr_names, 4, &index, &pos));
+    assert_int_equal(index, 1);
+    assert_int_equal(pos, 6);
+    assert_null(multi_calc_expr_compile_set(formulas, 0, expr_names, 4, NULL, NULL));
+}
+
+/*============================================================================
+ * Formula JIT - native code must match the interpreter bit for bit
+ *===========================================================================*/
+
+#define JIT_LEN 203  // not a multiple of 8: exercises the tail rows
+
+static const char *const jit_formulas[] = {
+    "(a + b) * (c - d)",
+    "a / b + c / d",
+    "a / (b - b) + 5",
+    "-a * 3 + divide(b, c) - 1000000",
+    "(a + b) * (a + b) / (c + 1) - (b + a)",
+    "a",
+    "7",
+    "a * b * c * d / 13",
+};
+
+static void fill_jit_inputs(int *in[4]) {
+    for (int k = 0; k < 4; k++) {
+        for (int i = 0; i < JIT_LEN; i++) {
+            in[k][i] = (int)(((unsigned)i * 2654435761u * (k + 1)) >> (k + 8)) - (1 << (22 - k));
+        }
+    }
+    // Corner rows: zero divisors and INT_MIN / -1
+    in[0][5] = INT32_MIN;
+    in[1][5] = -1;
+    in[3][5] = 0;
+    in[1][9] = 0;
+    in[2][9] = 0;
+    in[0][JIT_LEN - 1] = INT32_MIN;
+    in[1][JIT_LEN - 1] = -1;
+}
+
+static void check_jit_formulas(int expect_native) {
+    int a[JIT_LEN], b[JIT_LEN], c[JIT_LEN], d[JIT_LEN], out[JIT_LEN], expected[JIT_LEN];
+    int *in[4] = { a, b, c, d };
+    fill_jit_inputs(in);
+
+    for (size_t f = 0; f < sizeof(jit_formulas) / sizeof(jit_formulas[0]); f++) {
+        multi_calc_expr_t *expr = multi_calc_expr_compile(jit_formulas[f], expr_names, 4, NULL);
+        multi_calc_jit_t *jit = multi_calc_jit_get(jit_formulas[f], expr_names, 4, NULL);
+        assert_non_null(expr);
+        assert_non_null(jit);
+        if (expect_native >= 0) {
+            assert_int_equal(multi_calc_jit_is_native(jit), expect_native);
+        }
+        assert_int_equal(multi_calc_expr_eval_n(expr, (const int *const *)in, expected, JIT_LEN), 0);
+        const size_t lens[] = { JIT_LEN, 8, 7, 0 };
+        for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+            memset(out, 0x5A, sizeof(out));
+            assert_int_equal(multi_calc_jit_eval_n(jit, (const int *const *)in, out, lens[l]), 0);
+            assert_memory_equal(out, expected, lens[l] * sizeof(int));
+            if (lens[l] < JIT_LEN) {
+                assert_int_equal(out[lens[l]], 0x5A5A5A5A);  // nothing written past n
+            }
+        }
+        multi_calc_jit_release(jit);
+        multi_calc_expr_free(expr);
+    }
+}
+
+static void test_jit_matches_interpreter(void **state) {
+    (void)state;
+    disable_all_mocks();
+    multi_calc_jit_cache_clear();
+    check_jit_formulas(calc_batch_isa_supported(CALC_ISA_AVX2) ? -1 : 0);
+    multi_calc_jit_cache_clear();
+}
+
+static void test_jit_fallback_matches_interpreter(void **state) {
+    (void)state;
+    disable_all_mocks();
+    calc_isa_t saved = calc_batch_get_isa();
+    assert_int_equal(calc_batch_set_isa(CALC_ISA_SCALAR), 0);
+    multi_calc_jit_cache_clear();
+    check_jit_formulas(0);  // below AVX2: compiled for the interpreter
+    multi_calc_jit_cache_clear();
+    calc_batch_set_isa(saved);
+}
+
+static void test_jit_cache(void **state) {
+    (void)state;
+    multi_calc_jit_cache_clear();
+    assert_int_equal(multi_calc_jit_cache_size(), 0);
+
+    multi_calc_jit_t *j1 = multi_calc_jit_get("a * b", expr_names, 4, NULL);
+    multi_calc_jit_t *j2 = multi_calc_jit_get("a * b", expr_names, 4, NULL);
+    multi_calc_jit_t *j3 = multi_calc_jit_get("a * b", expr_names, 2, NULL);  // different names
+    assert_non_null(j1);
+    assert_ptr_equal(j1, j2);
+    assert_ptr_not_equal(j1, j3);
+    assert_int_equal(multi_calc_jit_cache_size(), 2);
+
+    size_t pos = 999;
+    assert_null(multi_calc_jit_get("a * ", expr_names, 4, &pos));
+    assert_int_equal(pos, 4);
+    assert_int_equal(multi_calc_jit_cache_size(), 2);
+
+    // Cleared entries stay usable while referenced
+    multi_calc_jit_cache_clear();
+    assert_int_equal(multi_calc_jit_cache_size(), 0);
+    int a[] = { 6 }, b[] = { 7 }, c[] = { 0 }, d[] = { 0 }, out = 0;
+    const int *in[] = { a, b, c, d };  // j2 was compiled over all 4 names
+    assert_int_equal(multi_calc_jit_eval_n(j2, in, &out, 1), 0);
+    assert_int_equal(out, 42);
+    multi_calc_jit_release(j1);
+    multi_calc_jit_release(j2);
+    multi_calc_jit_release(j3);
+    multi_calc_jit_release(NULL);
+}
+
+/*============================================================================
+ * Fused statistics - one pass, mergeable
+ *===========================================================================*/
+
+// Reference: exact sum, then a second pass for the variance
+static void reference_stats(const int *v, size_t n, int64_t *sum, int *lo, int *hi, double *var) {
+    *sum = 0;
+    *lo = INT32_MAX;
+    *hi = INT32_MIN;
+    for (size_t i = 0; i < n; i++) {
+        *sum += v[i];
+        *lo = v[i] < *lo ? v[i] : *lo;
+        *hi = v[i] > *hi ? v[i] : *hi;
+    }
+    long double mean = (long double)*sum / (long double)n, m2 = 0;
+    for (size_t i = 0; i < n; i++) {
+        m2 += ((long double)v[i] - mean) * ((long double)v[i] - mean);
+    }
+    *var = (double)(m2 / (long double)n);
+}
+
+static void assert_close(double got, double expected) {
+    assert_true(fabs(got - expected) <= 1e-9 * fabs(expected) + 1e-9);
+}
+
+static void test_stats_mean_matches_average(void **state) {
+    (void)state;
+    disable_all_mocks();
+    const int triples[][3] = {
+        { 1, 2, 3 }, { 10, 20, 31 }, { -1, -1, 0 }, { 1, 1, -5 }, { -7, 0, 0 },
+        { 0, 0, 0 }, { 1000000, -999999, 2 }, { INT32_MAX / 3, INT32_MAX / 3, INT32_MAX / 3 },
+    };
+    for (size_t i = 0; i < sizeof(triples) / sizeof(triples[0]); i++) {
+        multi_calc_stats_t st;
+        multi_calc_stats_init(&st);
+        multi_calc_stats_push_n(&st, triples[i], 3);
+        assert_int_equal(multi_calc_stats_mean(&st),
+                         multi_calc_average(triples[i][0], triples[i][1], triples[i][2]));
+
+        multi_calc_stats_init(&st);
+        for (int k = 0; k < 3; k++) {
+            multi_calc_stats_push(&st, triples[i][k]);
+        }
+        assert_int_equal(multi_calc_stats_mean(&st),
+                         multi_calc_average(triples[i][0], triples[i][1], triples[i][2]));
+    }
+
+    multi_calc_stats_t empty;
+    multi_calc_stats_init(&empty);
+    assert_int_equal(multi_calc_stats_mean(&empty), 0);
+    assert_true(multi_calc_stats_variance(&empty, 0) == 0);
+    multi_calc_stats_push(&empty, 5);
+    assert_true(multi_calc_stats_variance(&empty, 1) == 0);  // one value: no sample variance
+}
+
+static void test_stats_push_n_matches_reference(void **state) {
+    (void)state;
+    const size_t lens[] = { 1, 7, 512, 513, 100000 };
+    const size_t max_len = 100000;
+    int *v = malloc(max_len * sizeof(int));
+    assert_non_null(v);
+    calc_isa_t saved = calc_batch_get_isa();
+
+    for (int shape = 0; shape < 2; shape++) {
+        for (size_t i = 0; i < max_len; i++) {
+            // Shape 1: huge offset, tiny spread - naive sum of squares would lose it all
+            v[i] = shape == 0 ? (int)((i * 2654435761u) % 200001) - 100000
+                              : INT32_MAX - 10 + (int)(i % 7);
+        }
+        for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+            int64_t sum;
+            int lo, hi;
+            double var;
+            reference_stats(v, lens[l], &sum, &lo, &hi, &var);
+            for (size_t k = 0; k < sizeof(expr_isas) / sizeof(expr_isas[0]); k++) {
+                if (calc_batch_set_isa(expr_isas[k]) != 0) {
+                    continue;
+                }
+                multi_calc_stats_t st;
+                multi_calc_stats_init(&st);
+                multi_calc_stats_push_n(&st, v, lens[l]);
+                assert_int_equal(st.avg.count, lens[l]);
+                assert_true(multi_calc_stats_sum(&st) == sum);
+                assert_int_equal(st.min, lo);
+                assert_int_equal(st.max, hi);
+                assert_int_equal(multi_calc_stats_mean(&st), (int)(sum / (int64_t)lens[l]));
+                assert_close(multi_calc_stats_variance(&st, 0), var);
+                if (lens[l] > 1) {
+                    assert_close(multi_calc_stats_variance(&st, 1), var * lens[l] / (lens[l] - 1));
+                }
+            }
+        }
+    }
+    calc_batch_set_isa(saved);
+    free(v);
+}
+
+static void test_stats_merge_and_threads(void **state) {
+    (void)state;
+    const size_t n = 5 * 64 * 1024 + 321;  // several pool chunks, ragged tail
+    int *v = malloc(n * sizeof(int));
+    assert_non_null(v);
+    for (size_t i = 0; i < n; i++) {
+        v[i] = (int)((i * 40503u) % 65536) * ((i & 1) ? 1 : -1);
+    }
+    int64_t sum;
+    int lo, hi;
+    double var;
+    reference_stats(v, n, &sum, &lo, &hi, &var);
+
+    // Uneven slices merged in a different grouping
+    multi_calc_stats_t left, right, whole;
+    multi_calc_stats_init(&left);
+    multi_calc_stats_init(&right);
+    multi_calc_stats_push_n(&left, v, 1000);
+    multi_calc_stats_push_n(&right, v + 1000, 77);
+    multi_calc_stats_push_n(&right, v + 1077, n - 1077);
+    multi_calc_stats_merge(&left, &right);
+    assert_true(multi_calc_stats_sum(&left) == sum);
+    assert_int_equal(left.min, lo);
+    assert_int_equal(left.max, hi);
+    assert_close(multi_calc_stats_variance(&left, 0), var);
+
+    multi_calc_stats_t empty;
+    multi_calc_stats_init(&empty);
+    multi_calc_stats_merge(&left, &empty);
+    assert_true(multi_calc_stats_sum(&left) == sum);
+
+    // Same partials merged in the same order for any thread count
+    assert_int_equal(sdk_pool_set_size(4), 0);
+    multi_calc_stats_t by_threads[3];
+    const unsigned caps[] = { 0, 2, 4 };
+    for (int k = 0; k < 3; k++) {
+        multi_calc_stats_n(&by_threads[k], v, n, caps[k]);
+        assert_true(multi_calc_stats_sum(&by_threads[k]) == sum);
+        assert_close(multi_calc_stats_variance(&by_threads[k], 0), var);
+    }
+    assert_memory_equal(&by_threads[0], &by_threads[1], sizeof(multi_calc_stats_t));
+    assert_memory_equal(&by_threads[0], &by_threads[2], sizeof(multi_calc_stats_t));
+    multi_calc_stats_n(&whole, v, n, 1);
+    assert_int_equal(whole.min, lo);
+    assert_close(multi_calc_stats_variance(&whole, 0), var);
+    sdk_pool_set_size(0);
+    free(v);
+}
+
+/*============================================================================
+ * Async rings - submission / completion queues
+ *===========================================================================*/
+
+#define ASYNC_LEN 100
+
+static void fill_async_inputs(int *a, int *b, int *c, int *d) {
+    for (int i = 0; i < ASYNC_LEN; i++) {
+        a[i] = i * 13 - 600;
+        b[i] = i % 9 - 4;       // includes zero divisors
+        c[i] = 1000 - i;
+        d[i] = i / 2;
+    }
+}
+
+static void test_async_poll_and_wait(void **state) {
+    (void)state;
+    disable_all_mocks();
+    int a[ASYNC_LEN], b[ASYNC_LEN], c[ASYNC_LEN], d[ASYNC_LEN];
+    int sum[ASYNC_LEN], quot[ASYNC_LEN], expr[ASYNC_LEN], expected[ASYNC_LEN];
+    fill_async_inputs(a, b, c, d);
+
+    sdk_async_t *ring = sdk_async_create(4, 2);
+    assert_non_null(ring);
+    const sdk_async_sqe_t sqes[] = {
+        { .op = SDK_ASYNC_CALC_ADD, .a = a, .b = b, .out = sum, .n = ASYNC_LEN, .user_data = 1 },
+        { .op = SDK_ASYNC_CALC_DIVIDE, .a = a, .b = b, .out = quot, .n = ASYNC_LEN, .user_data = 2 },
+        { .op = SDK_ASYNC_MULTI_CALC_EXPRESSION, .a = a, .b = b, .c = c, .d = d, .out = expr,
+          .n = ASYNC_LEN, .user_data = 3 },
+        { .op = SDK_ASYNC_MULTI_CALC_AVERAGE, .a = c, .n = ASYNC_LEN, .user_data = 4 },
+    };
+    for (size_t i = 0; i < sizeof(sqes) / sizeof(sqes[0]); i++) {
+        assert_int_equal(sdk_async_submit(ring, &sqes[i]), 0);
+    }
+    assert_int_equal(sdk_async_submit(ring, &sqes[0]), -1);  // 4 in flight: full
+
+    int seen = 0;
+    sdk_async_cqe_t cqes[4];
+    while (seen != 0xF) {
+        unsigned n = sdk_async_wait(ring, cqes, 4);
+        assert_true(n > 0);
+        for (unsigned i = 0; i < n; i++) {
+            assert_int_equal(cqes[i].status, 0);
+            seen |= 1 << (cqes[i].user_data - 1);
+            if (cqes[i].user_data == 4) {
+                assert_int_equal(cqes[i].result, multi_calc_average_n(c, ASYNC_LEN, 1));
+            }
+        }
+    }
+    assert_int_equal(sdk_async_inflight(ring), 0);
+    assert_int_equal(sdk_async_wait(ring, cqes, 4), 0);  // nothing in flight: no blocking
+    assert_int_equal(sdk_async_poll(ring, cqes, 4), 0);
+
+    calc_add_n(a, b, expected, ASYNC_LEN);
+    assert_memory_equal(sum, expected, sizeof(expected));
+    calc_divide_n(a, b, expected, ASYNC_LEN);
+    assert_memory_equal(quot, expected, sizeof(expected));
+    multi_calc_expression_n(a, b, c, d, expected, ASYNC_LEN);
+    assert_memory_equal(expr, expected, sizeof(expected));
+    sdk_async_destroy(ring);
+}
+
+static void test_async_eventfd(void **state) {
+    (void)state;
+    int a[ASYNC_LEN], b[ASYNC_LEN], c[ASYNC_LEN], d[ASYNC_LEN], out[ASYNC_LEN];
+    fill_async_inputs(a, b, c, d);
+
+    sdk_async_t *ring = sdk_async_create(8, 1);
+    assert_non_null(ring);
+    int fd = sdk_async_eventfd(ring);
+    assert_true(fd >= 0);
+
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    assert_int_equal(poll(&pfd, 1, 0), 0);  // nothing queued yet
+
+    sdk_async_sqe_t sqe = { .op = SDK_ASYNC_CALC_MULTIPLY, .a = a, .b = b, .out = out,
+                            .n = ASYNC_LEN, .user_data = 42 };
+    assert_int_equal(sdk_async_submit(ring, &sqe), 0);
+    assert_int_equal(poll(&pfd, 1, 5000), 1);
+    assert_true(pfd.revents & POLLIN);
+
+    sdk_async_cqe_t cqe;
+    assert_int_equal(sdk_async_poll(ring, &cqe, 1), 1);
+    assert_int_equal(cqe.user_data, 42);
+    assert_int_equal(poll(&pfd, 1, 0), 0);  // reaping cleared it
+    sdk_async_destroy(ring);
+}
+
+struct async_callback_state {
+    int calls;
+    int average;
+};
+
+static void async_callback(void *ctx, const sdk_async_cqe_t *cqe) {
+    struct async_callback_state *st = ctx;
+    if (cqe->user_data == 7) {
+        st->average = cqe->result;
+    }
+    __atomic_add_fetch(&st->calls, 1, __ATOMIC_RELAXED);
+}
+
+static void test_async_callbacks(void **state) {
+    (void)state;
+    disable_all_mocks();
+    int a[ASYNC_LEN], b[ASYNC_LEN], c[ASYNC_LEN], d[ASYNC_LEN], out[ASYNC_LEN];
+    fill_async_inputs(a, b, c, d);
+    struct async_callback_state st = { 0, 0 };
+
+    sdk_async_t *ring = sdk_async_create(2, 1);
+    assert_non_null(ring);
+    sdk_async_sqe_t sqe = { .op = SDK_ASYNC_CALC_SUBTRACT, .a = a, .b = b, .out = out, .n = ASYNC_LEN,
+                            .callback = async_callback, .callback_ctx = &st };
+    assert_int_equal(sdk_async_submit(ring, &sqe), 0);
+    sqe = (sdk_async_sqe_t){ .op = SDK_ASYNC_MULTI_CALC_AVERAGE, .a = a, .n = ASYNC_LEN, .user_data = 7,
+                             .callback = async_callback, .callback_ctx = &st };
+    assert_int_equal(sdk_async_submit(ring, &sqe), 0);
+
+    // Callback requests never reach the completion queue
+    sdk_async_cqe_t cqe;
+    assert_int_equal(sdk_async_wait(ring, &cqe, 1), 0);
+    assert_int_equal(__atomic_load_n(&st.calls, __ATOMIC_RELAXED), 2);
+    assert_int_equal(st.average, multi_calc_average_n(a, ASYNC_LEN, 1));
+    assert_int_equal(out[5], a[5] - b[5]);
+
+    // Invalid requests are rejected at submit
+    sqe = (sdk_async_sqe_t){ .op = SDK_ASYNC_OP_COUNT };
+    assert_int_equal(sdk_async_submit(ring, &sqe), -1);
+    sqe = (sdk_async_sqe_t){ .op = SDK_ASYNC_CALC_ADD, .a = a, .n = 1 };
+    assert_int_equal(sdk_async_submit(ring, &sqe), -1);
+    sqe = (sdk_async_sqe_t){ .op = SDK_ASYNC_CALC_ADD };  // n = 0 needs no arrays
+    assert_int_equal(sdk_async_submit(ring, &sqe), 0);
+    sdk_async_destroy(ring);  // waits for the last request
+
+    assert_null(sdk_async_create(0, 1));
+}
+
 /*============================================================================
  * Main - Run all tests
  *===========================================================================*/
@@ -415,12 +1306,53 @@ int main(void) {
         cmocka_unit_test(test_average_negative),
     };
 
+    const struct CMUnitTest expression_batch_tests[] = {
+        cmocka_unit_test(test_expression_n_matches_expression),
+        cmocka_unit_test(test_expression_stride_aos),
+        cmocka_unit_test(test_expression_column),
+    };
+
+    const struct CMUnitTest formula_tests[] = {
+        cmocka_unit_test(test_formula_matches_expression_n),
+        cmocka_unit_test(test_formula_semantics),
+        cmocka_unit_test(test_formula_syntax_errors),
+        cmocka_unit_test(test_formula_nesting_limit),
+        cmocka_unit_test(test_formula_many_nodes),
+        cmocka_unit_test(test_formula_set_shares_subterms),
+        cmocka_unit_test(test_formula_set_small_tiles),
+        cmocka_unit_test(test_formula_set_errors),
+    };
+
+    const struct CMUnitTest jit_tests[] = {
+        cmocka_unit_test(test_jit_matches_interpreter),
+        cmocka_unit_test(test_jit_fallback_matches_interpreter),
+        cmocka_unit_test(test_jit_cache),
+    };
+
+    const struct CMUnitTest async_tests[] = {
+        cmocka_unit_test(test_async_poll_and_wait),
+        cmocka_unit_test(test_async_eventfd),
+        cmocka_unit_test(test_async_callbacks),
+    };
+
+    const struct CMUnitTest stats_tests[] = {
+        cmocka_unit_test(test_stats_mean_matches_average),
+        cmocka_unit_test(test_stats_push_n_matches_reference),
+        cmocka_unit_test(test_stats_merge_and_threads),
+    };
+
     const struct CMUnitTest hybrid_tests[] = {
         cmocka_unit_test(test_expression_real_all),
         cmocka_unit_test(test_average_real_all),
         cmocka_unit_test(test_expression_partial_mock_multiply),
-        cmocka_unit_test(test_average_partial_mock_divide),
+        cmocka_unit_test(test_average_does_not_call_divide),
         cmocka_unit_test(test_compare_mock_vs_real),
+        cmocka_unit_test(test_batch_reference_through_wrap),
+        cmocka_unit_test(test_average_n_matches_average),
+        cmocka_unit_test(test_average_column_skips_nulls),
+        cmocka_unit_test(test_average_stream_matches_average),
+        cmocka_unit_test(test_average_stream_merge_threads),
+        cmocka_unit_test(test_average_stream_negative_truncation),
     };
 
     int result = 0;
@@ -429,6 +1361,11 @@ int main(void) {
 
     result += cmocka_run_group_tests_name("expression mock tests", expression_tests, NULL, NULL);
     result += cmocka_run_group_tests_name("average mock tests", average_tests, NULL, NULL);
+    result += cmocka_run_group_tests_name("expression batch tests", expression_batch_tests, NULL, NULL);
+    result += cmocka_run_group_tests_name("formula engine tests", formula_tests, NULL, NULL);
+    result += cmocka_run_group_tests_name("formula jit tests", jit_tests, NULL, NULL);
+    result += cmocka_run_group_tests_name("async ring tests", async_tests, NULL, NULL);
+    result += cmocka_run_group_tests_name("statistics tests", stats_tests, NULL, NULL);
     result += cmocka_run_group_tests_name("hybrid tests (real + mock)", hybrid_tests, NULL, NULL);
 
     return result;
@@ -20,7 +20,7 @@ CMOCKA_REPORT_DIR := $(BUILD_DIR)/ut-cmocka-report
 
 # UT specific flags (use installed SDK from build directory)
 CMOCKA_CFLAGS := $(CFLAGS) -I$(SDK_INSTALL_INC_DIR) -I$(CMOCKA_INC_DIR)
-CMOCKA_LDFLAGS := -L$(SDK_INSTALL_LIB_DIR) -L$(CMOCKA_LIB_DIR) -lsdk -lcmocka -Wl,-rpath,$(CMOCKA_LIB_DIR)
+CMOCKA_LDFLAGS := -L$(SDK_INSTALL_LIB_DIR) -L$(CMOCKA_LIB_DIR) -lsdk -lcmocka -lpthread -Wl,-rpath,$(CMOCKA_LIB_DIR)
 
 # Mock test specific LDFLAGS (--wrap options for mocking calc functions)
 CMOCKA_MOCK_LDFLAGS := $(CMOCKA_LDFLAGS) \
@@ -29,6 +29,9 @@ CMOCKA_MOCK_LDFLAGS := $(CMOCKA_LDFLAGS) \
     -Wl,--wrap=calc_multiply \
     -Wl,--wrap=calc_divide
 
+# Greeting test LDFLAGS (--wrap=writev to inject short writes and EINTR)
+CMOCKA_GREETING_LDFLAGS := $(CMOCKA_LDFLAGS) -Wl,--wrap=writev
+
 # Build and run all unit tests
 .PHONY: ut_cmocka
 ut_cmocka: ut_cmocka_run ut_cmocka_report
@@ -96,11 +99,11 @@ $(CMOCKA_TEST_CALC): $(UT_OUTPUT_DIR)/test_calc.o
 	@$(MKDIR) $(dir $@)
 	$(CC) $< -o $@ $(CMOCKA_LDFLAGS)
 
-# Build cmocka_test_greeting executable
+# Build cmocka_test_greeting executable (with --wrap=writev)
 $(CMOCKA_TEST_GREETING): $(UT_OUTPUT_DIR)/test_greeting.o
 	@echo "Building test executable: $@"
 	@$(MKDIR) $(dir $@)
-	$(CC) $< -o $@ $(CMOCKA_LDFLAGS)
+	$(CC) $< -o $@ $(CMOCKA_GREETING_LDFLAGS)
 
 # Build cmocka_test_multi_calc executable (with --wrap for mocking)
 $(CMOCKA_TEST_MULTI_CALC): $(UT_OUTPUT_DIR)/test_multi_calc.o
@@ -29,7 +29,7 @@ CMOCKA_COV_SDK_LIB := $(CMOCKA_COV_OUTPUT_DIR)/libsdk_cov.a
 
 # UT specific flags for coverage build
 CMOCKA_COV_UT_CFLAGS := $(CMOCKA_COV_CFLAGS) -Isdk/include -I$(CMOCKA_INC_DIR)
-CMOCKA_COV_UT_LDFLAGS := $(CMOCKA_COV_LDFLAGS) -L$(CMOCKA_COV_OUTPUT_DIR) -L$(CMOCKA_LIB_DIR) -lsdk_cov -lcmocka -Wl,-rpath,$(CMOCKA_LIB_DIR)
+CMOCKA_COV_UT_LDFLAGS := $(CMOCKA_COV_LDFLAGS) -L$(CMOCKA_COV_OUTPUT_DIR) -L$(CMOCKA_LIB_DIR) -lsdk_cov -lcmocka -lpthread -Wl,-rpath,$(CMOCKA_LIB_DIR)
 
 # Mock test specific LDFLAGS for coverage
 CMOCKA_COV_MOCK_LDFLAGS := $(CMOCKA_COV_UT_LDFLAGS) \
@@ -38,6 +38,9 @@ CMOCKA_COV_MOCK_LDFLAGS := $(CMOCKA_COV_UT_LDFLAGS) \
     -Wl,--wrap=calc_multiply \
     -Wl,--wrap=calc_divide
 
+# Greeting test LDFLAGS for coverage
+CMOCKA_COV_GREETING_LDFLAGS := $(CMOCKA_COV_UT_LDFLAGS) -Wl,--wrap=writev
+
 # Build and run coverage tests, then generate report
 .PHONY: ut_cmocka_cov
 ut_cmocka_cov: ut_cmocka_cov_run ut_cmocka_cov_report
@@ -103,10 +106,10 @@ $(CMOCKA_COV_TEST_CALC): $(CMOCKA_COV_UT_OUTPUT_DIR)/test_calc.o $(CMOCKA_COV_SD
 	@echo "Building coverage test: $@"
 	$(CC) $< -o $@ $(CMOCKA_COV_UT_LDFLAGS)
 
-# Build coverage cmocka_test_greeting
+# Build coverage cmocka_test_greeting (with --wrap=writev)
 $(CMOCKA_COV_TEST_GREETING): $(CMOCKA_COV_UT_OUTPUT_DIR)/test_greeting.o $(CMOCKA_COV_SDK_LIB)
 	@echo "Building coverage test: $@"
-	$(CC) $< -o $@ $(CMOCKA_COV_UT_LDFLAGS)
+	$(CC) $< -o $@ $(CMOCKA_COV_GREETING_LDFLAGS)
 
 # Build coverage cmocka_test_multi_calc (with mock)
 $(CMOCKA_COV_TEST_MULTI_CALC): $(CMOCKA_COV_UT_OUTPUT_DIR)/test_multi_calc.o $(CMOCKA_COV_SDK_LIB)
@@ -10,12 +10,19 @@
  */
 
 #include <gtest/gtest.h>
+#include <limits>
+#include <climits>
+#include <cstdint>
+#include <cstring>
 
 // C header needs extern "C"
 extern "C" {
 #include "calc.h"
 }
 
+// C++ header (constexpr templates)
+#include "calc.hpp"
+
 /* ========== Basic Tests (TEST macro) ========== */
 
 // Test calc_add with positive numbers
@@ -158,6 +165,180 @@ INSTANTIATE_TEST_SUITE_P(
     )
 );
 
+/* ========== Batch API Tests (TEST_P over ISAs) ========== */
+
+// Every supported ISA must produce the same result as the scalar reference
+class CalcBatchIsaTest : public ::testing::TestWithParam<calc_isa_t> {
+protected:
+    static const size_t kLen = 53;  // not a multiple of any vector width
+    int a[kLen];
+    int b[kLen];
+    int out[kLen];
+    int expected[kLen];
+    calc_isa_t saved_isa;
+
+    void SetUp() override {
+        saved_isa = calc_batch_get_isa();
+        if (calc_batch_set_isa(GetParam()) != 0) {
+            GTEST_SKIP() << "ISA not supported on this CPU";
+        }
+        for (size_t i = 0; i < kLen; i++) {
+            a[i] = static_cast<int>((i * 7919) % 20001) - 10000;
+            b[i] = static_cast<int>((i * 104729) % 201) - 100;
+        }
+    }
+
+    void TearDown() override {
+        calc_batch_set_isa(saved_isa);
+    }
+};
+
+TEST_P(CalcBatchIsaTest, AddMatchesReference) {
+    calc_add_n_ref(a, b, expected, kLen);
+    calc_add_n(a, b, out, kLen);
+    EXPECT_EQ(0, memcmp(out, expected, sizeof(out)));
+}
+
+TEST_P(CalcBatchIsaTest, SubtractMatchesReference) {
+    calc_subtract_n_ref(a, b, expected, kLen);
+    calc_subtract_n(a, b, out, kLen);
+    EXPECT_EQ(0, memcmp(out, expected, sizeof(out)));
+}
+
+TEST_P(CalcBatchIsaTest, MultiplyMatchesReference) {
+    calc_multiply_n_ref(a, b, expected, kLen);
+    calc_multiply_n(a, b, out, kLen);
+    EXPECT_EQ(0, memcmp(out, expected, sizeof(out)));
+}
+
+TEST_P(CalcBatchIsaTest, DivideMatchesReference) {
+    calc_divide_n_ref(a, b, expected, kLen);
+    calc_divide_n(a, b, out, kLen);
+    EXPECT_EQ(0, memcmp(out, expected, sizeof(out)));
+}
+
+TEST_P(CalcBatchIsaTest, DivideByZeroLanesReturnZero) {
+    for (size_t i = 0; i < kLen; i++) {
+        b[i] = 0;
+    }
+    calc_divide_n(a, b, out, kLen);
+    for (size_t i = 0; i < kLen; i++) {
+        EXPECT_EQ(out[i], 0);
+    }
+}
+
+TEST_P(CalcBatchIsaTest, DividerMatchesDivide) {
+    const int divisors[] = {1, -1, 3, -7, 1000, INT32_MAX, INT32_MIN, 0};
+    for (int d : divisors) {
+        calc_divider_t div;
+        calc_divider_init(&div, d);
+        calc_divider_divide_n(&div, a, out, kLen);
+        for (size_t i = 0; i < kLen; i++) {
+            EXPECT_EQ(out[i], calc_divide(a[i], d)) << a[i] << " / " << d;
+            EXPECT_EQ(calc_divider_divide(&div, a[i]), out[i]);
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AllIsas,
+    CalcBatchIsaTest,
+    ::testing::Values(CALC_ISA_SCALAR, CALC_ISA_SSE2, CALC_ISA_AVX2, CALC_ISA_AVX512)
+);
+
+/* ========== calc.hpp Tests (constexpr + TYPED_TEST) ========== */
+
+// Constant operands fold at compile time with the C semantics
+static_assert(calc::add(2, 3) == 5, "add");
+static_assert(calc::subtract<int64_t>(3, 5) == -2, "subtract");
+static_assert(calc::multiply<int16_t>(-3, 4) == -12, "multiply");
+static_assert(calc::divide(7, 2) == 3, "divide truncates");
+static_assert(calc::divide(-7, 2) == -3, "divide truncates toward zero");
+static_assert(calc::divide(10, 0) == 0, "divide by zero returns 0");
+static_assert(calc::divide(1.0, 0.0) == 0.0, "float divide by zero returns 0");
+static_assert(calc::divide<int8_t>(-128, 0) == 0, "int8 divide by zero returns 0");
+static_assert(calc::divide<int8_t>(-128, -1) == -128, "int8 MIN / -1 wraps");
+static_assert(calc::divide<int64_t>(INT64_MIN, -1) == INT64_MIN, "int64 MIN / -1 wraps");
+
+TEST(CalcHppTest, MatchesCFunctions) {
+    const int values[] = {-1000, -7, -1, 0, 1, 3, 10, 999};
+    for (int a : values) {
+        for (int b : values) {
+            EXPECT_EQ(calc::add(a, b), calc_add(a, b));
+            EXPECT_EQ(calc::subtract(a, b), calc_subtract(a, b));
+            EXPECT_EQ(calc::multiply(a, b), calc_multiply(a, b));
+            EXPECT_EQ(calc::divide(a, b), calc_divide(a, b));
+        }
+    }
+}
+
+// Batch kernels for every element width must match the scalar templates
+template <typename T>
+class CalcHppBatchTest : public ::testing::Test {
+protected:
+    static const size_t kLen = 45;  // full vectors plus a tail for every width
+    T a[kLen];
+    T b[kLen];
+    T out[kLen];
+
+    void SetUp() override {
+        for (size_t i = 0; i < kLen; i++) {
+            a[i] = static_cast<T>(static_cast<int>(i * 7) % 61 - 30);
+            b[i] = static_cast<T>(static_cast<int>(i * 5) % 11 - 5);  // includes zeros
+        }
+    }
+};
+
+using CalcTypes = ::testing::Types<int8_t, int16_t, int32_t, int64_t, float, double>;
+TYPED_TEST_SUITE(CalcHppBatchTest, CalcTypes);
+
+TYPED_TEST(CalcHppBatchTest, AddN) {
+    calc::add_n(this->a, this->b, this->out, this->kLen);
+    for (size_t i = 0; i < this->kLen; i++) {
+        EXPECT_EQ(this->out[i], calc::add(this->a[i], this->b[i]));
+    }
+}
+
+TYPED_TEST(CalcHppBatchTest, SubtractN) {
+    calc::subtract_n(this->a, this->b, this->out, this->kLen);
+    for (size_t i = 0; i < this->kLen; i++) {
+        EXPECT_EQ(this->out[i], calc::subtract(this->a[i], this->b[i]));
+    }
+}
+
+TYPED_TEST(CalcHppBatchTest, MultiplyN) {
+    calc::multiply_n(this->a, this->b, this->out, this->kLen);
+    for (size_t i = 0; i < this->kLen; i++) {
+        EXPECT_EQ(this->out[i], calc::multiply(this->a[i], this->b[i]));
+    }
+}
+
+TYPED_TEST(CalcHppBatchTest, DivideN) {
+    calc::divide_n(this->a, this->b, this->out, this->kLen);
+    for (size_t i = 0; i < this->kLen; i++) {
+        EXPECT_EQ(this->out[i], calc::divide(this->a[i], this->b[i]));
+        if (this->b[i] == 0) {
+            EXPECT_EQ(this->out[i], static_cast<TypeParam>(0));
+        }
+    }
+}
+
+TYPED_TEST(CalcHppBatchTest, DivideNMinByMinusOne) {
+    // MIN / -1 overflows: it must wrap to MIN (integers), never trap
+    const TypeParam lowest = std::numeric_limits<TypeParam>::lowest();
+    for (size_t i = 0; i < this->kLen; i++) {
+        this->a[i] = i % 3 == 0 ? lowest : this->a[i];
+        this->b[i] = i % 2 == 0 ? static_cast<TypeParam>(-1) : this->b[i];
+    }
+    calc::divide_n(this->a, this->b, this->out, this->kLen);
+    for (size_t i = 0; i < this->kLen; i++) {
+        EXPECT_EQ(this->out[i], calc::divide(this->a[i], this->b[i])) << "i = " << i;
+        if (i % 6 == 0) {
+            EXPECT_EQ(this->out[i], std::is_integral<TypeParam>::value ? lowest : -lowest);
+        }
+    }
+}
+
 /* ========== Assertion Types Demo ========== */
 
 TEST(AssertionDemo, DifferentAssertionTypes) {
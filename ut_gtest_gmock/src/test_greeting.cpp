@@ -10,7 +10,12 @@
  */
 
 #include <gtest/gtest.h>
+#include <cerrno>
 #include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
 
 // C header needs extern "C"
 extern "C" {
@@ -140,6 +145,119 @@ TEST(GreetingEdgeCaseTest, ReturnNotNull) {
     EXPECT_NE(say_goodbye(nullptr), nullptr);
 }
 
+/* ========== Reentrant API Tests ========== */
+
+TEST(GreetingReentrantTest, WritesIntoCallerBuffer) {
+    char buf[64];
+    EXPECT_EQ(say_hello_r("Alice", GREETING_NAME_STRLEN, buf, sizeof(buf)), 13u);
+    EXPECT_STREQ(buf, "Hello, Alice!");
+    EXPECT_EQ(say_goodbye_r(nullptr, GREETING_NAME_STRLEN, buf, sizeof(buf)), 18u);
+    EXPECT_STREQ(buf, "Goodbye, stranger!");
+}
+
+TEST(GreetingReentrantTest, ExplicitNameLength) {
+    char buf[64];
+    const char *record = "Carol;Dave";
+    EXPECT_EQ(say_hello_r(record, 5, buf, sizeof(buf)), 13u);
+    EXPECT_STREQ(buf, "Hello, Carol!");
+}
+
+TEST(GreetingReentrantTest, ReportsNeededLength) {
+    char buf[6];
+    EXPECT_EQ(say_goodbye_r("Alice", GREETING_NAME_STRLEN, nullptr, 0), 15u);
+    EXPECT_EQ(say_goodbye_r("Alice", GREETING_NAME_STRLEN, buf, sizeof(buf)), 15u);
+    EXPECT_STREQ(buf, "Goodb");
+}
+
+/* ========== Batch API Tests ========== */
+
+TEST(GreetingBatchTest, WritesBackToBackWithOffsets) {
+    const char *names[] = { "Alice", nullptr, "Bob" };
+    char arena[64];
+    size_t offsets[4];
+    size_t used = say_hello_n(names, 3, '\n', arena, sizeof(arena), offsets);
+
+    EXPECT_EQ(std::string(arena, used), "Hello, Alice!\nHello, stranger!\nHello, Bob!\n");
+    EXPECT_EQ(offsets[0], 0u);
+    EXPECT_EQ(offsets[1], 14u);
+    EXPECT_EQ(offsets[2], 31u);
+    EXPECT_EQ(offsets[3], used);
+}
+
+TEST(GreetingBatchTest, StopsAtFirstMessageThatDoesNotFit) {
+    const char *names[] = { "Alice", "Bob" };
+    char arena[20];
+    size_t offsets[3];
+    EXPECT_EQ(say_goodbye_n(names, 2, '\0', arena, sizeof(arena), offsets), 30u);
+    EXPECT_STREQ(arena + offsets[0], "Goodbye, Alice!");
+    EXPECT_EQ(offsets[1], 16u);
+    EXPECT_EQ(offsets[2], 30u);
+}
+
+/* ========== Vectored I/O API Tests ========== */
+
+TEST(GreetingWriteTest, WritesThroughPipe) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    const char *names[] = { "Alice", "", "Bob" };
+    size_t written = 0;
+
+    EXPECT_EQ(say_hello_write(fds[1], "Carol", GREETING_NAME_STRLEN, &written), 0);
+    EXPECT_EQ(written, 13u);
+    EXPECT_EQ(say_goodbye_write_n(fds[1], names, 3, '\n', &written), 0);
+    EXPECT_EQ(written, 16u + 19u + 14u);
+    close(fds[1]);
+
+    char buf[128];
+    ssize_t n = read(fds[0], buf, sizeof(buf));
+    close(fds[0]);
+    EXPECT_EQ(std::string(buf, n > 0 ? n : 0),
+              "Hello, Carol!Goodbye, Alice!\nGoodbye, stranger!\nGoodbye, Bob!\n");
+}
+
+TEST(GreetingWriteTest, ReportsErrno) {
+    size_t written = 1;
+    errno = 0;
+    EXPECT_EQ(say_hello_write(-1, "Alice", GREETING_NAME_STRLEN, &written), -1);
+    EXPECT_EQ(errno, EBADF);
+    EXPECT_EQ(written, 0u);
+}
+
+/* ========== Thread-Local Mode Stress Test ========== */
+
+TEST(GreetingThreadLocalTest, ConcurrentLegacyCallers) {
+    constexpr int kThreads = 8;
+    constexpr int kIterations = 20000;
+    greeting_set_thread_local(1);
+
+    std::vector<int> mismatches(kThreads, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([t, &mismatches] {
+            const std::string name = "gtest-" + std::to_string(t);
+            const std::string hello = "Hello, " + name + "!";
+            const std::string goodbye = "Goodbye, " + name + "!";
+            for (int i = 0; i < kIterations; i++) {
+                const char *h = say_hello(name.c_str());
+                if (i % 16 == 0) {
+                    std::this_thread::yield();
+                }
+                mismatches[t] += hello != h;
+                mismatches[t] += goodbye != say_goodbye(name.c_str());
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+    for (int t = 0; t < kThreads; t++) {
+        EXPECT_EQ(mismatches[t], 0) << "thread " << t;
+    }
+
+    greeting_set_thread_local(0);
+    EXPECT_EQ(greeting_thread_local_enabled(), 0);
+}
+
 /* ========== String Assertion Demo ========== */
 
 TEST(StringAssertionDemo, DifferentStringAssertions) {
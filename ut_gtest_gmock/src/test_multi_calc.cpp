@@ -16,6 +16,13 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <climits>
+#include <exception>
+#include <future>
+#include <vector>
+
+#include "sdk-async.hpp"
+
 // C headers need extern "C"
 extern "C" {
 #include "calc.h"
@@ -192,26 +199,25 @@ TEST_F(MultiCalcMockTest, ExpressionCapturesArguments) {
 TEST_F(MultiCalcMockTest, AverageWithMockedValues) {
     // First add: a + b
     // Second add: (a+b) + c
-    // Then divide by 3
+    // Then divide by 3 (precomputed divider, not calc_divide)
     mock_add_return = 6;      // Both adds return 6
-    mock_divide_return = 2;   // Final divide returns 2
 
     int result = multi_calc_average(1, 2, 3);
 
-    EXPECT_EQ(result, 2);
+    EXPECT_EQ(result, 2);     // 6 / 3
     EXPECT_EQ(add_call_count, 2);  // Called twice
-    EXPECT_EQ(divide_call_count, 1);
+    EXPECT_EQ(divide_call_count, 0);
 }
 
 TEST_F(MultiCalcMockTest, AverageArgumentCapture) {
     mock_add_return = 100;
-    mock_divide_return = 33;
 
-    multi_calc_average(10, 20, 30);
+    int result = multi_calc_average(10, 20, 30);
 
-    // Last divide should be sum / 3
-    EXPECT_EQ(last_divide_a, 100);  // Sum from mocked add
-    EXPECT_EQ(last_divide_b, 3);    // Divisor is always 3
+    // Last add should be (a + b) + c
+    EXPECT_EQ(last_add_a, 100);  // Sum from mocked add
+    EXPECT_EQ(last_add_b, 30);   // c
+    EXPECT_EQ(result, 33);       // 100 / 3
 }
 
 /* ========== Hybrid Tests (Real + Mock) ========== */
@@ -258,7 +264,6 @@ TEST_F(MultiCalcHybridTest, CompareMockVsReal) {
     // Test with mock
     enable_all_mocks();
     mock_add_return = 100;
-    mock_divide_return = 66;
 
     int mock_result = multi_calc_average(1, 2, 3);
 
@@ -266,7 +271,7 @@ TEST_F(MultiCalcHybridTest, CompareMockVsReal) {
     disable_all_mocks();
     int real_result = multi_calc_average(1, 2, 3);
 
-    EXPECT_EQ(mock_result, 66);
+    EXPECT_EQ(mock_result, 33);  // 100 / 3
     EXPECT_EQ(real_result, 2);
     EXPECT_NE(mock_result, real_result);
 }
@@ -288,16 +293,111 @@ TEST_F(MultiCalcMockTest, VerifyCallCounts) {
 
 TEST_F(MultiCalcMockTest, AverageCallCounts) {
     mock_add_return = 10;
-    mock_divide_return = 3;
 
     multi_calc_average(1, 2, 3);
 
     EXPECT_EQ(add_call_count, 2);     // Called twice for sum
-    EXPECT_EQ(divide_call_count, 1);  // Called once for average
+    EXPECT_EQ(divide_call_count, 0);  // Divide by 3 is precomputed
     EXPECT_EQ(multiply_call_count, 0);
     EXPECT_EQ(subtract_call_count, 0);
 }
 
+/* ========== sdk-async.hpp Coroutine Tests ========== */
+
+namespace {
+
+// Minimal eager coroutine type: runs until the first co_await, then
+// continues on the ring's worker thread
+struct detached_task {
+    struct promise_type {
+        detached_task get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+detached_task expression_then_average(sdk::async::ring &ring, const std::vector<int> *in,
+                                      std::vector<int> *out, std::promise<int> *done) {
+    std::size_t n = out->size();
+    sdk_async_cqe_t cqe = co_await sdk::async::expression(ring, in[0].data(), in[1].data(),
+                                                          in[2].data(), in[3].data(), out->data(), n);
+    if (cqe.status != 0) {
+        done->set_value(INT_MIN);
+        co_return;
+    }
+    cqe = co_await sdk::async::average(ring, out->data(), n);
+    done->set_value(cqe.status == 0 ? cqe.result : INT_MIN);
+}
+
+detached_task await_invalid(sdk::async::ring &ring, std::promise<int> *done) {
+    int out[4];
+    // NULL operands with n > 0: rejected at submit, no suspension
+    sdk_async_cqe_t cqe = co_await sdk::async::add(ring, nullptr, nullptr, out, 4);
+    done->set_value(cqe.status);
+}
+
+detached_task await_twice(sdk::async::ring &ring, const int *a, const int *b, int *out,
+                          std::promise<int> *done) {
+    // The second submit runs inside the first completion's callback
+    sdk_async_cqe_t cqe = co_await sdk::async::add(ring, a, b, out, 4);
+    if (cqe.status != 0) {
+        done->set_value(cqe.status);
+        co_return;
+    }
+    cqe = co_await sdk::async::add(ring, out, b, out, 4);
+    done->set_value(cqe.status);
+}
+
+} // namespace
+
+TEST(SdkAsyncCoroutineTest, AwaitExpressionThenAverage) {
+    const std::size_t n = 1000;
+    std::vector<int> in[4];
+    for (int k = 0; k < 4; k++) {
+        in[k].resize(n);
+        for (std::size_t i = 0; i < n; i++) {
+            in[k][i] = static_cast<int>(i % (17 + k)) - 8;
+        }
+    }
+    std::vector<int> expected(n), out(n);
+    multi_calc_expression_n(in[0].data(), in[1].data(), in[2].data(), in[3].data(), expected.data(), n);
+
+    sdk::async::ring ring(8, 2);
+    ASSERT_TRUE(ring);
+    std::promise<int> done;
+    std::future<int> result = done.get_future();
+    expression_then_average(ring, in, &out, &done);
+
+    EXPECT_EQ(result.get(), multi_calc_average_n(expected.data(), n, 1));
+    EXPECT_EQ(out, expected);
+}
+
+TEST(SdkAsyncCoroutineTest, SubmitFailureResumesImmediately) {
+    sdk::async::ring ring(1);
+    ASSERT_TRUE(ring);
+    std::promise<int> done;
+    std::future<int> status = done.get_future();
+    await_invalid(ring, &done);
+    EXPECT_EQ(status.get(), -1);
+}
+
+TEST(SdkAsyncCoroutineTest, AwaitTwiceOnOneEntryRing) {
+    sdk::async::ring ring(1);
+    ASSERT_TRUE(ring);
+    const int a[] = { 1, 2, 3, 4 }, b[] = { 10, 20, 30, 40 };
+    int out[4] = {};
+    std::promise<int> done;
+    std::future<int> status = done.get_future();
+    await_twice(ring, a, b, out, &done);
+
+    EXPECT_EQ(status.get(), 0);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(out[i], a[i] + 2 * b[i]);
+    }
+}
+
 /* ========== Main function ========== */
 
 int main(int argc, char **argv) {
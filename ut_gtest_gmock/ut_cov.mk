@@ -30,6 +30,9 @@ GTEST_COV_SDK_LIB := $(GTEST_COV_OUTPUT_DIR)/libsdk_cov.a
 
 # UT specific flags for coverage build
 GTEST_COV_UT_CXXFLAGS := $(GTEST_COV_CXXFLAGS) -Isdk/include -I$(GTEST_INC_DIR)
+
+# Same C++20 exception as the regular build (see ut.mk)
+$(GTEST_COV_UT_OUTPUT_DIR)/test_multi_calc.o: GTEST_STD := -std=c++20
 GTEST_COV_UT_LDFLAGS := $(GTEST_COV_LDFLAGS) -L$(GTEST_COV_OUTPUT_DIR) -L$(GTEST_LIB_DIR) -lsdk_cov -lgtest -lgmock -lpthread
 
 # Mock test specific LDFLAGS for coverage
@@ -118,7 +121,7 @@ $(GTEST_COV_TEST_MULTI_CALC): $(GTEST_COV_UT_OUTPUT_DIR)/test_multi_calc.o $(GTE
 $(GTEST_COV_UT_OUTPUT_DIR)/%.o: $(GTEST_SRC_DIR)/%.cpp
 	@echo "Compiling test (coverage): $<"
 	@$(MKDIR) $(dir $@)
-	$(CXX) $(GTEST_COV_UT_CXXFLAGS) -c $< -o $@
+	$(CXX) $(GTEST_COV_UT_CXXFLAGS) $(GTEST_STD) -c $< -o $@
 
 # Clean GoogleTest coverage artifacts
 .PHONY: clean-gtest-cov
@@ -129,15 +129,14 @@ TEST_F(MultiCalcMockcppTest, AverageWithMockedFunctions) {
         .stubs()
         .will(returnValue(15));
 
-    // Mock calc_divide to return 5
+    // The divide by 3 is precomputed: calc_divide must not be called
     MOCKER(calc_divide)
-        .stubs()
-        .will(returnValue(5));
+        .expects(never());
 
     // Call the average function
     int result = multi_calc_average(3, 5, 7);
 
-    // Verify result
+    // Verify result: 15 / 3
     EXPECT_EQ(result, 5);
 }
 
@@ -5,6 +5,7 @@
  * Demonstrates Unity basic assertions and test organization.
  */
 
+#include <stdint.h>
 #include "unity.h"
 #include "calc.h"
 
@@ -91,6 +92,37 @@ static void test_calc_divide_negative_numbers(void) {
     TEST_ASSERT_EQUAL_INT(2, calc_divide(-6, -3));
 }
 
+/* ========== Overflow-checked / saturating tests ========== */
+
+static void test_calc_add_checked_overflow(void) {
+    int r = 0;
+    TEST_ASSERT_EQUAL_INT(0, calc_add_checked(40, 2, &r));
+    TEST_ASSERT_EQUAL_INT(42, r);
+    TEST_ASSERT_EQUAL_INT(-1, calc_add_checked(INT32_MAX, 1, &r));
+    TEST_ASSERT_EQUAL_INT(-1, calc_multiply_checked(INT32_MIN, -1, &r));
+}
+
+static void test_calc_saturating_clamps(void) {
+    TEST_ASSERT_EQUAL_INT(INT32_MAX, calc_add_sat(INT32_MAX, INT32_MAX));
+    TEST_ASSERT_EQUAL_INT(INT32_MIN, calc_subtract_sat(-2, INT32_MAX));
+    TEST_ASSERT_EQUAL_INT(INT32_MIN, calc_multiply_sat(INT32_MAX, -2));
+    TEST_ASSERT_EQUAL_INT(INT32_MAX, calc_divide_sat(INT32_MIN, -1));
+}
+
+static void test_calc_add_sat_n_mask(void) {
+    int a[10] = { 1, INT32_MAX, 3, INT32_MIN, 5, 6, 7, 8, INT32_MAX, 10 };
+    int b[10] = { 1, 1, 1, -1, 1, 1, 1, 1, 1, 1 };
+    int out[10];
+    uint8_t mask[2];
+
+    TEST_ASSERT_EQUAL_UINT(3, calc_add_sat_n(a, b, out, mask, 10));
+    TEST_ASSERT_EQUAL_HEX8(0x0A, mask[0]);  /* lanes 1 and 3 */
+    TEST_ASSERT_EQUAL_HEX8(0x01, mask[1]);  /* lane 8 */
+    TEST_ASSERT_EQUAL_INT(INT32_MAX, out[1]);
+    TEST_ASSERT_EQUAL_INT(INT32_MIN, out[3]);
+    TEST_ASSERT_EQUAL_INT(11, out[9]);
+}
+
 /* ========== Unity assertion demo ========== */
 
 static void test_unity_assertions_demo(void) {
@@ -146,6 +178,11 @@ int main(void) {
     RUN_TEST(test_calc_divide_by_zero);
     RUN_TEST(test_calc_divide_negative_numbers);
 
+    /* Overflow-checked / saturating tests */
+    RUN_TEST(test_calc_add_checked_overflow);
+    RUN_TEST(test_calc_saturating_clamps);
+    RUN_TEST(test_calc_add_sat_n_mask);
+
     /* Unity assertions demo */
     RUN_TEST(test_unity_assertions_demo);
 
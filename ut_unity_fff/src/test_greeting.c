@@ -5,6 +5,9 @@
  * Demonstrates Unity setUp/tearDown fixtures and string assertions.
  */
 
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "unity.h"
@@ -144,6 +147,53 @@ static void test_say_hello_special_characters(void) {
     TEST_ASSERT_EQUAL_STRING("Hello, Test@123!", result);
 }
 
+/* ========== Thread-local mode stress test ========== */
+
+#define STRESS_THREADS 8
+#define STRESS_ITERATIONS 20000
+
+struct stress_worker {
+    pthread_t thread;
+    char name[32];
+    int mismatches;
+};
+
+static void *stress_greetings(void *arg) {
+    struct stress_worker *w = (struct stress_worker *)arg;
+    char hello[64], goodbye[64];
+    sprintf(hello, "Hello, %s!", w->name);
+    sprintf(goodbye, "Goodbye, %s!", w->name);
+
+    for (int i = 0; i < STRESS_ITERATIONS; i++) {
+        const char *h = say_hello(w->name);
+        if (i % 16 == 0) {
+            sched_yield();
+        }
+        w->mismatches += strcmp(h, hello) != 0;
+        w->mismatches += strcmp(say_goodbye(w->name), goodbye) != 0;
+    }
+    return NULL;
+}
+
+static void test_greeting_thread_local_stress(void) {
+    struct stress_worker workers[STRESS_THREADS];
+    greeting_set_thread_local(1);
+
+    for (int t = 0; t < STRESS_THREADS; t++) {
+        sprintf(workers[t].name, "unity-%d", t);
+        workers[t].mismatches = 0;
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&workers[t].thread, NULL, stress_greetings, &workers[t]));
+    }
+    for (int t = 0; t < STRESS_THREADS; t++) {
+        pthread_join(workers[t].thread, NULL);
+    }
+    for (int t = 0; t < STRESS_THREADS; t++) {
+        TEST_ASSERT_EQUAL_INT(0, workers[t].mismatches);
+    }
+
+    greeting_set_thread_local(0);
+}
+
 /* ========== Main ========== */
 
 int main(void) {
@@ -172,5 +222,8 @@ int main(void) {
     RUN_TEST(test_say_hello_long_name);
     RUN_TEST(test_say_hello_special_characters);
 
+    /* Thread-local mode */
+    RUN_TEST(test_greeting_thread_local_stress);
+
     return UNITY_END();
 }
@@ -83,15 +83,14 @@ static void test_expression_with_mocked_return_values(void) {
 
 static void test_average_with_mocked_return_values(void) {
     /* For multi_calc_average: (a+b+c)/3 */
-    /* calc_add is called twice, calc_divide once */
+    /* calc_add is called twice; the divide by 3 is precomputed */
     calc_add_fake.return_val = 10;    /* Both add calls return 10 */
-    calc_divide_fake.return_val = 3;  /* Final divide returns 3 */
 
     int result = multi_calc_average(1, 2, 3);
 
-    TEST_ASSERT_EQUAL_INT(3, result);
+    TEST_ASSERT_EQUAL_INT(3, result);  /* 10 / 3 */
     TEST_ASSERT_EQUAL_INT(2, calc_add_fake.call_count);
-    TEST_ASSERT_EQUAL_INT(1, calc_divide_fake.call_count);
+    TEST_ASSERT_EQUAL_INT(0, calc_divide_fake.call_count);
 }
 
 /* ========== Argument capture tests ========== */
@@ -118,13 +117,16 @@ static void test_expression_captures_arguments(void) {
 
 static void test_average_captures_arguments(void) {
     calc_add_fake.return_val = 6;
-    calc_divide_fake.return_val = 2;
 
-    multi_calc_average(1, 2, 3);
+    int result = multi_calc_average(1, 2, 3);
+
+    /* Verify the last calc_add was called with (sum1, c) */
+    TEST_ASSERT_EQUAL_INT(6, calc_add_fake.arg0_val);
+    TEST_ASSERT_EQUAL_INT(3, calc_add_fake.arg1_val);
 
-    /* Verify calc_divide was called with (sum, 3) */
-    TEST_ASSERT_EQUAL_INT(6, calc_divide_fake.arg0_val);
-    TEST_ASSERT_EQUAL_INT(3, calc_divide_fake.arg1_val);
+    /* The sum is divided by 3 without going through calc_divide */
+    TEST_ASSERT_EQUAL_INT(2, result);
+    TEST_ASSERT_EQUAL_INT(0, calc_divide_fake.call_count);
 }
 
 /* ========== Return value sequence tests ========== */
@@ -134,14 +136,13 @@ static int add_return_values[] = {3, 6};  /* First call returns 3, second return
 static void test_average_with_return_sequence(void) {
     /* Set up return value sequence for calc_add */
     SET_RETURN_SEQ(calc_add, add_return_values, 2);
-    calc_divide_fake.return_val = 3;
 
     int result = multi_calc_average(1, 2, 3);
 
     /* First calc_add(1, 2) returns 3 */
     /* Second calc_add(3, 3) returns 6 */
-    /* calc_divide(6, 3) returns 3 */
-    TEST_ASSERT_EQUAL_INT(3, result);
+    /* 6 / 3 = 2 */
+    TEST_ASSERT_EQUAL_INT(2, result);
     TEST_ASSERT_EQUAL_INT(2, calc_add_fake.call_count);
 }
 
@@ -191,7 +192,6 @@ static void test_call_history_order(void) {
 
 static void test_argument_history(void) {
     calc_add_fake.return_val = 10;
-    calc_divide_fake.return_val = 3;
 
     multi_calc_average(1, 2, 3);
 
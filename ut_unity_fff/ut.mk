@@ -21,7 +21,7 @@ UNITY_REPORT_DIR := $(BUILD_DIR)/ut-unity-report
 
 # UT specific flags
 UNITY_CFLAGS := $(CFLAGS) -I$(SDK_INSTALL_INC_DIR) -I$(UNITY_INC_DIR) -I$(FFF_DIR)
-UNITY_LDFLAGS := -L$(SDK_INSTALL_LIB_DIR) -L$(UNITY_LIB_DIR) -lsdk -lunity
+UNITY_LDFLAGS := -L$(SDK_INSTALL_LIB_DIR) -L$(UNITY_LIB_DIR) -lsdk -lunity -lpthread
 
 # Mock test specific LDFLAGS (--wrap options for mocking calc functions)
 UNITY_MOCK_LDFLAGS := $(UNITY_LDFLAGS) \